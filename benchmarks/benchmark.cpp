@@ -0,0 +1,614 @@
+#include "hep/mc.hpp"
+
+#include "genz_integrand.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the throughput of the most important functions of the library and writes it as JSON to
+// the standard output. Usage:
+//
+//     benchmark [filter] [seconds]
+//
+// where `filter` selects the benchmarks whose names contain it and `seconds` is the minimum time
+// each measurement runs (default: 0.5)
+
+using T = double;
+using generator_type = std::mt19937_64;
+
+// prevents the compiler from removing calculations whose results are not used otherwise
+volatile T sink;
+
+std::string parameter(std::string const& name, std::size_t value)
+{
+    return "\"" + name + "\": " + std::to_string(value);
+}
+
+std::string parameter(std::string const& name, std::string const& value)
+{
+    return "\"" + name + "\": \"" + value + "\"";
+}
+
+class benchmark_runner
+{
+public:
+    benchmark_runner(std::string const& filter, double min_seconds)
+        : filter_(filter)
+        , min_seconds_(min_seconds)
+        , first_(true)
+    {
+        std::cout << "{\n    \"benchmarks\": [";
+    }
+
+    ~benchmark_runner()
+    {
+        std::cout << "\n    ]\n}\n";
+    }
+
+    // Measures how many calls of `run`, which performs `calls` calls with each invocation, are
+    // performed per second
+    template <typename F>
+    void measure(
+        std::string const& name,
+        std::vector<std::string> const& parameters,
+        std::size_t calls,
+        F&& run
+    ) {
+        if (name.find(filter_) == std::string::npos)
+        {
+            return;
+        }
+
+        using clock = std::chrono::steady_clock;
+
+        // warm up the caches and let the processor reach its clock speed
+        run();
+
+        std::size_t runs = 0;
+        double seconds = 0.0;
+        auto const start = clock::now();
+
+        do
+        {
+            run();
+            ++runs;
+            seconds = std::chrono::duration<double>(clock::now() - start).count();
+        }
+        while (seconds < min_seconds_);
+
+        std::cout << (first_ ? "" : ",") << "\n        {\n            \"name\": \"" << name
+            << "\",\n            \"parameters\": { ";
+
+        for (std::size_t i = 0; i != parameters.size(); ++i)
+        {
+            std::cout << ((i == 0) ? "" : ", ") << parameters.at(i);
+        }
+
+        std::cout << " },\n            \"calls\": " << (runs * calls)
+            << ",\n            \"seconds\": " << seconds
+            << ",\n            \"calls_per_second\": " << (double(runs * calls) / seconds)
+            << "\n        }";
+        std::cout.flush();
+
+        first_ = false;
+    }
+
+private:
+    std::string filter_;
+    double min_seconds_;
+    bool first_;
+};
+
+genz::integrand<T> make_genz_integrand(genz::integrand_type type, std::size_t dimensions)
+{
+    genz::parameters<T> const parameters(dimensions, T(5.0), T(1.0));
+
+    return genz::integrand<T>(type, parameters.affective(), parameters.unaffective());
+}
+
+std::string genz_name(genz::integrand_type type)
+{
+    switch (type)
+    {
+    case genz::oscillatory:   return "oscillatory";
+    case genz::product_peak:  return "product_peak";
+    case genz::corner_peak:   return "corner_peak";
+    case genz::gaussian:      return "gaussian";
+    case genz::c0_function:   return "c0_function";
+    case genz::discontinuous: return "discontinuous";
+    }
+
+    return "";
+}
+
+std::vector<genz::integrand_type> const genz_types = {
+    genz::oscillatory,
+    genz::product_peak,
+    genz::corner_peak,
+    genz::gaussian,
+    genz::c0_function,
+    genz::discontinuous
+};
+
+std::size_t const iteration_calls = 100000;
+
+void benchmark_plain_iteration(benchmark_runner& runner)
+{
+    for (auto const type : genz_types)
+    {
+        for (std::size_t const dimensions : { 1, 4, 16 })
+        {
+            auto const genz = make_genz_integrand(type, dimensions);
+            auto integrand = hep::make_integrand<T>(genz, dimensions);
+            generator_type generator;
+
+            runner.measure("plain_iteration", { parameter("integrand", genz_name(type)),
+                parameter("dimensions", dimensions) }, iteration_calls, [&]() {
+                sink = hep::plain_iteration(integrand, iteration_calls, generator).value();
+            });
+        }
+    }
+}
+
+void benchmark_vegas_iteration(benchmark_runner& runner)
+{
+    for (auto const type : genz_types)
+    {
+        for (std::size_t const dimensions : { 1, 4, 16 })
+        {
+            for (std::size_t const bins : { 16, 128, 1024 })
+            {
+                auto const genz = make_genz_integrand(type, dimensions);
+                auto integrand = hep::make_integrand<T>(genz, dimensions);
+                hep::vegas_pdf<T> const pdf(dimensions, bins);
+                generator_type generator;
+
+                runner.measure("vegas_iteration", { parameter("integrand", genz_name(type)),
+                    parameter("dimensions", dimensions), parameter("bins", bins) },
+                    iteration_calls, [&]() {
+                    sink = hep::vegas_iteration(integrand, iteration_calls, pdf, generator)
+                        .value();
+                });
+            }
+        }
+    }
+}
+
+void benchmark_multi_channel_iteration(benchmark_runner& runner)
+{
+    std::size_t const dimensions = 4;
+
+    for (auto const type : { genz::oscillatory, genz::gaussian })
+    {
+        for (std::size_t const channels : { 1, 4, 16, 64 })
+        {
+            auto const genz = make_genz_integrand(type, dimensions);
+
+            // every channel is the identity, so that the overhead of the channels is measured
+            auto const map = [](
+                std::size_t,
+                std::vector<T> const& random_numbers,
+                std::vector<T>& coordinates,
+                std::vector<std::size_t> const& enabled_channels,
+                std::vector<T>& densities,
+                hep::multi_channel_map action
+            ) {
+                if (action == hep::multi_channel_map::calculate_densities)
+                {
+                    for (std::size_t const channel : enabled_channels)
+                    {
+                        densities[channel] = T(1.0);
+                    }
+                }
+                else
+                {
+                    coordinates = random_numbers;
+                }
+
+                return T(1.0);
+            };
+
+            auto integrand = hep::make_multi_channel_integrand<T>(
+                [&](hep::multi_channel_point<T> const& point) {
+                    return genz(hep::mc_point<T>(point.coordinates()));
+                },
+                dimensions,
+                map,
+                dimensions,
+                channels
+            );
+
+            std::vector<T> const weights(channels, T(1.0) / T(channels));
+            generator_type generator;
+
+            runner.measure("multi_channel_iteration", { parameter("integrand", genz_name(type)),
+                parameter("dimensions", dimensions), parameter("channels", channels) },
+                iteration_calls, [&]() {
+                sink = hep::multi_channel_iteration(integrand, iteration_calls, weights,
+                    generator).value();
+            });
+        }
+    }
+}
+
+// Samples the unit hypercube with `channels - 1` channels that each cover a slice of the first
+// dimension and a last channel that covers the whole hypercube, so that only two channels have a
+// non-zero density at every point
+template <typename Densities>
+T slice_map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    Densities& densities,
+    hep::multi_channel_map action,
+    void (*set_densities)(Densities&, std::size_t, std::size_t)
+) {
+    std::size_t const slices = enabled_channels.size() - 1;
+
+    if (action == hep::multi_channel_map::calculate_coordinates)
+    {
+        coordinates = random_numbers;
+
+        if (channel != slices)
+        {
+            coordinates[0] = (T(channel) + random_numbers[0]) / T(slices);
+        }
+    }
+    else
+    {
+        std::size_t const slice = std::min(static_cast <std::size_t> (coordinates[0] *
+            T(slices)), slices - 1);
+        set_densities(densities, slice, slices);
+    }
+
+    return T(1.0);
+}
+
+void benchmark_multi_channel_densities(benchmark_runner& runner)
+{
+    std::size_t const dimensions = 4;
+    auto const genz = make_genz_integrand(genz::gaussian, dimensions);
+    auto const function = [&](hep::multi_channel_point<T> const& point) {
+        return genz(hep::mc_point<T>(point.coordinates()));
+    };
+
+    auto const dense_map = [](
+        std::size_t channel,
+        std::vector<T> const& random_numbers,
+        std::vector<T>& coordinates,
+        std::vector<std::size_t> const& enabled_channels,
+        std::vector<T>& densities,
+        hep::multi_channel_map action
+    ) {
+        return slice_map<std::vector<T>>(channel, random_numbers, coordinates, enabled_channels,
+            densities, action, [](std::vector<T>& densities, std::size_t slice,
+            std::size_t slices) {
+            std::fill(densities.begin(), densities.end(), T());
+            densities[slice] = T(slices);
+            densities[slices] = T(1.0);
+        });
+    };
+
+    auto const sparse_map = [](
+        std::size_t channel,
+        std::vector<T> const& random_numbers,
+        std::vector<T>& coordinates,
+        std::vector<std::size_t> const& enabled_channels,
+        hep::sparse_densities<T>& densities,
+        hep::multi_channel_map action
+    ) {
+        return slice_map<hep::sparse_densities<T>>(channel, random_numbers, coordinates,
+            enabled_channels, densities, action, [](hep::sparse_densities<T>& densities,
+            std::size_t slice, std::size_t slices) {
+            densities.add(slice, T(slices));
+            densities.add(slices, T(1.0));
+        });
+    };
+
+    for (std::size_t const channels : { 17, 1025, 16385 })
+    {
+        auto dense = hep::make_multi_channel_integrand<T>(function, dimensions, dense_map,
+            dimensions, channels);
+        auto sparse = hep::make_multi_channel_integrand<T>(function, dimensions,
+            hep::make_sparse_map(sparse_map), dimensions, channels);
+
+        std::vector<T> const weights(channels, T(1.0) / T(channels));
+        generator_type generator;
+
+        runner.measure("multi_channel_densities", { parameter("dimensions", dimensions),
+            parameter("channels", channels), parameter("densities", "dense") }, iteration_calls,
+            [&]() {
+            sink = hep::multi_channel_iteration(dense, iteration_calls, weights,
+                generator).value();
+        });
+
+        runner.measure("multi_channel_densities", { parameter("dimensions", dimensions),
+            parameter("channels", channels), parameter("densities", "sparse") }, iteration_calls,
+            [&]() {
+            sink = hep::multi_channel_iteration(sparse, iteration_calls, weights,
+                generator).value();
+        });
+    }
+}
+
+void benchmark_vegas_icdf(benchmark_runner& runner)
+{
+    for (std::size_t const dimensions : { 1, 4, 16 })
+    {
+        for (std::size_t const bins : { 16, 128, 1024 })
+        {
+            hep::vegas_pdf<T> const pdf(dimensions, bins);
+            std::vector<T> random_numbers(dimensions);
+            std::vector<std::size_t> bin(dimensions);
+            generator_type generator;
+
+            runner.measure("vegas_icdf", { parameter("dimensions", dimensions),
+                parameter("bins", bins) }, iteration_calls, [&]() {
+                T sum = T();
+
+                for (std::size_t i = 0; i != iteration_calls; ++i)
+                {
+                    for (auto& number : random_numbers)
+                    {
+                        number = hep::generate_uniform<T>(generator);
+                    }
+
+                    sum += hep::vegas_icdf(pdf, random_numbers, bin);
+                }
+
+                sink = sum;
+            });
+        }
+    }
+}
+
+void benchmark_vegas_refine_pdf(benchmark_runner& runner)
+{
+    for (std::size_t const dimensions : { 1, 4, 16 })
+    {
+        for (std::size_t const bins : { 16, 128, 1024 })
+        {
+            hep::vegas_pdf<T> const pdf(dimensions, bins);
+            std::vector<T> data(dimensions * bins);
+            generator_type generator;
+
+            for (auto& value : data)
+            {
+                value = hep::generate_uniform<T>(generator);
+            }
+
+            runner.measure("vegas_refine_pdf", { parameter("dimensions", dimensions),
+                parameter("bins", bins) }, 1, [&]() {
+                sink = hep::vegas_refine_pdf(pdf, T(1.5), data).bin_left(0, 1);
+            });
+        }
+    }
+}
+
+template <typename Selection>
+void benchmark_discrete_distribution(benchmark_runner& runner, std::string const& selection)
+{
+    for (std::size_t const channels : { 2, 16, 128, 1024, 16384, 131072 })
+    {
+        std::vector<T> weights(channels);
+        generator_type generator;
+
+        for (auto& weight : weights)
+        {
+            weight = hep::generate_uniform<T>(generator);
+        }
+
+        std::vector<std::string> const parameters = { parameter("channels", channels),
+            parameter("selection", selection) };
+
+        runner.measure("discrete_distribution_setup", parameters, channels, [&]() {
+            typename Selection::template distribution<std::size_t, T> const distribution(
+                weights.begin(), weights.end());
+            sink = T(distribution(generator));
+        });
+
+        typename Selection::template distribution<std::size_t, T> const distribution(
+            weights.begin(), weights.end());
+
+        runner.measure("discrete_distribution", parameters, iteration_calls, [&]() {
+            std::size_t sum = 0;
+
+            for (std::size_t i = 0; i != iteration_calls; ++i)
+            {
+                sum += distribution(generator);
+            }
+
+            sink = T(sum);
+        });
+    }
+}
+
+void benchmark_distributions(benchmark_runner& runner)
+{
+    std::size_t const dimensions = 2;
+    auto const genz = make_genz_integrand(genz::gaussian, dimensions);
+
+    auto const function = [&](hep::mc_point<T> const& point, hep::projector<T>& projector) {
+        T const value = genz(point);
+
+        projector.add(0, point.point()[0], value);
+        projector.add(1, point.point()[0], point.point()[1], value);
+
+        return value;
+    };
+
+    for (std::size_t const bins : { 10, 100, 1000 })
+    {
+        auto integrand = hep::make_integrand<T>(
+            function,
+            dimensions,
+            hep::make_dist_params<T>(bins, T(), T(1.0), "x"),
+            hep::distribution_parameters<T>(bins, bins, T(), T(1.0), T(), T(1.0), "xy")
+        );
+        generator_type generator;
+
+        runner.measure("distributions", { parameter("integrand", genz_name(genz::gaussian)),
+            parameter("dimensions", dimensions), parameter("bins", bins) }, iteration_calls,
+            [&]() {
+            sink = hep::plain_iteration(integrand, iteration_calls, generator).value();
+        });
+    }
+}
+
+void benchmark_accumulate_distributions(benchmark_runner& runner)
+{
+    std::size_t const distributions = 10;
+    generator_type generator;
+    std::uniform_real_distribution<T> uniform;
+
+    for (std::size_t const bins : { 10, 1000 })
+    {
+        for (std::size_t const iterations : { 10, 100 })
+        {
+            std::vector<hep::plain_result<T>> results;
+            results.reserve(iterations);
+
+            for (std::size_t i = 0; i != iterations; ++i)
+            {
+                std::vector<hep::distribution_result<T>> distribution_results;
+
+                for (std::size_t j = 0; j != distributions; ++j)
+                {
+                    std::vector<hep::mc_result<T>> bin_results;
+
+                    for (std::size_t k = 0; k != bins; ++k)
+                    {
+                        T const value = uniform(generator);
+                        bin_results.emplace_back(1000, 900, 900, T(1000.0) * value,
+                            T(2000.0) * value * value);
+                    }
+
+                    distribution_results.emplace_back(hep::make_dist_params<T>(bins, T(),
+                        T(1.0), "x"), bin_results);
+                }
+
+                results.emplace_back(distribution_results, 1000, 900, 900, T(1000.0),
+                    T(2000.0));
+            }
+
+            std::vector<std::string> parameters = { parameter("distributions", distributions),
+                parameter("bins", bins), parameter("iterations", iterations) };
+            std::size_t const calls = distributions * bins * iterations;
+
+            auto with_variance = parameters;
+            with_variance.push_back(parameter("accumulator", "weighted_with_variance"));
+            auto equally = parameters;
+            equally.push_back(parameter("accumulator", "weighted_equally"));
+
+            runner.measure("accumulate_distributions", with_variance, calls, [&]() {
+                sink = hep::accumulate<hep::weighted_with_variance>(results.begin(),
+                    results.end()).distributions().back().results().back().value();
+            });
+
+            runner.measure("accumulate_distributions", equally, calls, [&]() {
+                sink = hep::accumulate<hep::weighted_equally>(results.begin(),
+                    results.end()).distributions().back().results().back().value();
+            });
+        }
+    }
+}
+
+void benchmark_chkpt(benchmark_runner& runner)
+{
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    std::size_t const dimensions = 4;
+    auto const genz = make_genz_integrand(genz::gaussian, dimensions);
+
+    for (std::size_t const bins : { 16, 128, 1024 })
+    {
+        for (std::size_t const distribution_bins : { 10, 1000 })
+        {
+            auto const function = [&](hep::mc_point<T> const& point, hep::projector<T>& projector) {
+                T const value = genz(point);
+                projector.add(0, point.point()[0], value);
+                return value;
+            };
+
+            auto const chkpt = hep::vegas(
+                hep::make_integrand<T>(function, dimensions,
+                    hep::make_dist_params<T>(distribution_bins, T(), T(1.0), "x")),
+                std::vector<std::size_t>(10, 1000),
+                hep::make_vegas_chkpt<T>(bins),
+                hep::callback<chkpt_type>(hep::callback_mode::silent)
+            );
+
+            std::vector<std::string> const parameters = { parameter("dimensions", dimensions),
+                parameter("bins", bins), parameter("distribution_bins", distribution_bins),
+                parameter("iterations", chkpt.results().size()) };
+
+            std::ostringstream text;
+            chkpt.serialize(text);
+            std::string const text_data = text.str();
+
+            std::ostringstream binary;
+            hep::binary_writer writer(binary);
+            chkpt.serialize(writer);
+            std::string const binary_data = binary.str();
+
+            auto text_parameters = parameters;
+            text_parameters.push_back(parameter("format", "text"));
+            auto binary_parameters = parameters;
+            binary_parameters.push_back(parameter("format", "binary"));
+
+            runner.measure("chkpt_serialize", text_parameters, 1, [&]() {
+                std::ostringstream out;
+                chkpt.serialize(out);
+                sink = T(out.tellp());
+            });
+
+            runner.measure("chkpt_deserialize", text_parameters, 1, [&]() {
+                std::istringstream in(text_data);
+                sink = chkpt_type(in).results().back().value();
+            });
+
+            runner.measure("chkpt_serialize", binary_parameters, 1, [&]() {
+                std::ostringstream out;
+                hep::binary_writer writer(out);
+                chkpt.serialize(writer);
+                sink = T(out.tellp());
+            });
+
+            runner.measure("chkpt_deserialize", binary_parameters, 1, [&]() {
+                hep::binary_reader reader(binary_data.data(), binary_data.size());
+                sink = chkpt_type(reader).results().back().value();
+            });
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string const filter = (argc > 1) ? argv[1] : "";
+    double const seconds = (argc > 2) ? std::atof(argv[2]) : 0.5;
+
+    benchmark_runner runner(filter, seconds);
+
+    benchmark_plain_iteration(runner);
+    benchmark_vegas_iteration(runner);
+    benchmark_multi_channel_iteration(runner);
+    benchmark_multi_channel_densities(runner);
+    benchmark_vegas_icdf(runner);
+    benchmark_vegas_refine_pdf(runner);
+    benchmark_discrete_distribution<hep::cumulative_selection>(runner, "cumulative");
+    benchmark_discrete_distribution<hep::alias_selection>(runner, "alias");
+    benchmark_distributions(runner);
+    benchmark_accumulate_distributions(runner);
+    benchmark_chkpt(runner);
+
+    return 0;
+}
@@ -25,6 +25,7 @@
 #include "hep/mc/mpi_helper.hpp"
 #include "hep/mc/mpi_multi_channel.hpp"
 #include "hep/mc/mpi_plain.hpp"
+#include "hep/mc/mpi_schedule.hpp"
 #include "hep/mc/mpi_vegas.hpp"
 
 #endif
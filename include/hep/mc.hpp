@@ -21,17 +21,27 @@
 
 #include "hep/mc/accumulator.hpp"
 #include "hep/mc/accumulator_fwd.hpp"
+#include "hep/mc/async_chkpt_writer.hpp"
+#include "hep/mc/batch_integrand.hpp"
+#include "hep/mc/binary_stream.hpp"
 #include "hep/mc/callback.hpp"
 #include "hep/mc/chkpt.hpp"
+#include "hep/mc/chkpt_io.hpp"
+#include "hep/mc/chkpt_journal.hpp"
 #include "hep/mc/discrete_distribution.hpp"
 #include "hep/mc/distribution_parameters.hpp"
 #include "hep/mc/distribution_result.hpp"
+#include "hep/mc/event_writer.hpp"
 #include "hep/mc/generator_helper.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/mapped_file.hpp"
+#include "hep/mc/mc_batch.hpp"
 #include "hep/mc/mc_helper.hpp"
 #include "hep/mc/mc_point.hpp"
 #include "hep/mc/mc_result.hpp"
 #include "hep/mc/multi_channel.hpp"
+#include "hep/mc/multi_channel_batch.hpp"
 #include "hep/mc/multi_channel_chkpt.hpp"
 #include "hep/mc/multi_channel_integrand.hpp"
 #include "hep/mc/multi_channel_map.hpp"
@@ -40,15 +50,33 @@
 #include "hep/mc/multi_channel_refine_weights.hpp"
 #include "hep/mc/multi_channel_result.hpp"
 #include "hep/mc/multi_channel_summary.hpp"
+#include "hep/mc/multi_channel_vegas.hpp"
+#include "hep/mc/multi_channel_vegas_chkpt.hpp"
+#include "hep/mc/multi_channel_vegas_result.hpp"
 #include "hep/mc/multi_channel_weight_info.hpp"
+#include "hep/mc/parallel_multi_channel.hpp"
+#include "hep/mc/parallel_plain.hpp"
+#include "hep/mc/parallel_vegas.hpp"
+#include "hep/mc/philox4x64.hpp"
 #include "hep/mc/plain.hpp"
 #include "hep/mc/plain_chkpt.hpp"
 #include "hep/mc/plain_result.hpp"
 #include "hep/mc/projector.hpp"
+#include "hep/mc/running_distributions.hpp"
+#include "hep/mc/running_statistics.hpp"
+#include "hep/mc/sparse_densities.hpp"
+#include "hep/mc/storage_policy.hpp"
+#include "hep/mc/thread_pool.hpp"
+#include "hep/mc/uniform_random.hpp"
 #include "hep/mc/vegas.hpp"
+#include "hep/mc/vegas_batch.hpp"
 #include "hep/mc/vegas_chkpt.hpp"
 #include "hep/mc/vegas_pdf.hpp"
 #include "hep/mc/vegas_point.hpp"
 #include "hep/mc/vegas_result.hpp"
+#include "hep/mc/vegas_stratified.hpp"
+#include "hep/mc/vegas_stratified_chkpt.hpp"
+#include "hep/mc/vegas_stratified_result.hpp"
+#include "hep/mc/xoshiro256pp.hpp"
 
 #endif
@@ -24,10 +24,13 @@
 #include "hep/mc/distribution_result.hpp"
 #include "hep/mc/plain_result.hpp"
 #include "hep/mc/projector.hpp"
+#include "hep/mc/storage_policy.hpp"
 
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace hep
@@ -46,28 +49,54 @@ inline void accumulate(T& sum, T& sum_of_squares, T& compensation, T value)
     sum_of_squares += value * value;
 }
 
+template <typename T>
+inline void merge(T& sum, T& compensation, T other_sum, T other_compensation)
+{
+    T const y = (other_sum - other_compensation) - compensation;
+    T const t = sum + y;
+    compensation = (t - sum) - y;
+    sum = t;
+}
+
+// The bins of the distributions are stored as specified by \ref storage_policy, the sums of the
+// integral always use `T`
 template <typename T>
 class accumulator<T, true>
 {
 public:
+    using storage = storage_policy<T>;
+    using bin_type = typename storage::bin_type;
+    using counter_type = typename storage::counter_type;
+
     explicit accumulator(std::vector<hep::distribution_parameters<T>> const& parameters)
-        : parameters_(parameters)
+        : parameters_(std::make_shared<std::vector<hep::distribution_parameters<T>> const>(
+            parameters))
         , sums_()
-        , compensations_()
+        , non_zero_calls_{}
+        , finite_calls_{}
     {
-        std::size_t index = 2;
-        indices_.reserve(parameters.size());
+        std::size_t index = 0;
+        binnings_.reserve(parameters.size());
 
         for (auto const& params : parameters)
         {
-            indices_.push_back(index);
-            index += 2 * params.bins_x() * params.bins_y();
+            binnings_.push_back(binning{
+                params.x_min(),
+                params.y_min(),
+                params.bin_size_x(),
+                params.bin_size_y(),
+                params.bins_x(),
+                params.bins_y(),
+                index
+            });
+
+            index += params.bins_x() * params.bins_y();
         }
 
-        sums_.resize(2 + index);
-        compensations_.resize(index / 2);
-        non_zero_calls_.resize(index / 2);
-        finite_calls_.resize(index / 2);
+        bin_sums_.resize(2 * index);
+        bin_compensations_.resize(storage::compensated ? index : 0);
+        bin_non_zero_calls_.resize(index);
+        bin_finite_calls_.resize(index);
     }
 
     template <typename I, typename P>
@@ -87,15 +116,15 @@ public:
 
             if (isfinite(value))
             {
-                accumulate(sums_[0], sums_[1], compensations_[0], value);
-                ++finite_calls_[0];
+                accumulate(sums_[0], sums_[1], sums_[2], value);
+                ++finite_calls_;
             }
             else
             {
                 value = T();
             }
 
-            ++non_zero_calls_[0];
+            ++non_zero_calls_;
         }
 
         return value;
@@ -105,15 +134,16 @@ public:
     {
         using std::isfinite;
 
+        assert( index < binnings_.size() );
+
         if (!isfinite(value))
         {
             return;
         }
 
-        // TODO: index might be larger than the than allowed; throw?
-        auto const parameters = parameters_.at(index);
+        binning const& params = binnings_[index];
 
-        T const shifted_x = x - parameters.x_min();
+        T const shifted_x = x - params.x_min;
 
         if (shifted_x < T())
         {
@@ -121,42 +151,31 @@ public:
             return;
         }
 
-        std::size_t const bin_x = shifted_x / parameters.bin_size_x();
+        std::size_t const bin_x = shifted_x / params.bin_size_x;
 
-        if (bin_x >= parameters.bins_x())
+        if (bin_x >= params.bins_x)
         {
             // point is right of the range that we are binning
             return;
         }
 
-        std::size_t const new_index = indices_.at(index) + 2 * bin_x;
-
-        accumulate(
-            sums_.at(new_index),
-            sums_.at(new_index + 1),
-            compensations_.at(new_index / 2),
-            value
-        );
-
-        // FIXME: if this function is called more than once, the values are
-        // incorrect
-        ++non_zero_calls_.at(new_index / 2);
-        ++finite_calls_.at(new_index / 2);
+        add_to_bin(params.offset + bin_x, value);
     }
 
     void add_to_2d_distribution(std::size_t index, T x, T y, T value)
     {
         using std::isfinite;
 
+        assert( index < binnings_.size() );
+
         if (!isfinite(value))
         {
             return;
         }
 
-        // TODO: index might be larger than the than allowed; throw?
-        auto const parameters = parameters_.at(index);
+        binning const& params = binnings_[index];
 
-        T const shifted_x = x - parameters.x_min();
+        T const shifted_x = x - params.x_min;
 
         if (shifted_x < T())
         {
@@ -164,7 +183,7 @@ public:
             return;
         }
 
-        T const shifted_y = y - parameters.y_min();
+        T const shifted_y = y - params.y_min;
 
         if (shifted_y < T())
         {
@@ -172,46 +191,58 @@ public:
             return;
         }
 
-        std::size_t const bin_x = shifted_x / parameters.bin_size_x();
+        std::size_t const bin_x = shifted_x / params.bin_size_x;
 
-        if (bin_x >= parameters.bins_x())
+        if (bin_x >= params.bins_x)
         {
             // point is right of the range that we are binning
             return;
         }
 
-        std::size_t const bin_y = shifted_y / parameters.bin_size_y();
+        std::size_t const bin_y = shifted_y / params.bin_size_y;
 
-        if (bin_y >= parameters.bins_y())
+        if (bin_y >= params.bins_y)
         {
             return;
         }
 
-        std::size_t const new_index = indices_.at(index) + 2 * (bin_y *
-            parameters.bins_x() + bin_x);
+        add_to_bin(params.offset + bin_y * params.bins_x + bin_x, value);
+    }
 
-        accumulate(
-            sums_.at(new_index),
-            sums_.at(new_index + 1),
-            compensations_.at(new_index / 2),
-            value
-        );
+    void merge(accumulator<T, true> const& other)
+    {
+        hep::merge(sums_[0], sums_[2], other.sums_[0], other.sums_[2]);
+        sums_[1] += other.sums_[1];
+        non_zero_calls_ += other.non_zero_calls_;
+        finite_calls_ += other.finite_calls_;
 
-        // FIXME: if this function is called more than once, the values are
-        // incorrect
-        ++non_zero_calls_.at(new_index / 2);
-        ++finite_calls_.at(new_index / 2);
+        for (std::size_t i = 0; i != bin_non_zero_calls_.size(); ++i)
+        {
+            if (storage::compensated)
+            {
+                hep::merge(bin_sums_[2 * i], bin_compensations_[i], other.bin_sums_[2 * i],
+                    other.bin_compensations_[i]);
+            }
+            else
+            {
+                bin_sums_[2 * i] += other.bin_sums_[2 * i];
+            }
+
+            bin_sums_[2 * i + 1] += other.bin_sums_[2 * i + 1];
+            bin_non_zero_calls_[i] += other.bin_non_zero_calls_[i];
+            bin_finite_calls_[i] += other.bin_finite_calls_[i];
+        }
     }
 
     hep::plain_result<T> result(std::size_t calls) const
     {
         std::vector<hep::distribution_result<T>> result;
-        result.reserve(parameters_.size());
+        result.reserve(parameters_->size());
 
-        std::size_t index = 2;
+        std::size_t index = 0;
 
         // loop over all distributions
-        for (auto const& params : parameters_)
+        for (auto const& params : *parameters_)
         {
             std::vector<hep::mc_result<T>> bin_results;
             bin_results.reserve(params.bins_x());
@@ -224,13 +255,13 @@ public:
             {
                 bin_results.emplace_back(
                     calls,
-                    non_zero_calls_[index / 2],
-                    finite_calls_[index / 2],
-                    inv_bin_size                * sums_[index],
-                    inv_bin_size * inv_bin_size * sums_[index + 1]
+                    static_cast <std::size_t> (bin_non_zero_calls_[index]),
+                    static_cast <std::size_t> (bin_finite_calls_[index]),
+                    inv_bin_size                * static_cast <T> (bin_sums_[2 * index]),
+                    inv_bin_size * inv_bin_size * static_cast <T> (bin_sums_[2 * index + 1])
                 );
 
-                index += 2;
+                ++index;
             }
 
             result.emplace_back(params, bin_results);
@@ -239,20 +270,59 @@ public:
         return hep::plain_result<T>(
             result,
             calls,
-            non_zero_calls_[0],
-            finite_calls_[0],
+            non_zero_calls_,
+            finite_calls_,
             sums_[0],
             sums_[1]
         );
     }
 
 private:
-    std::vector<hep::distribution_parameters<T>> parameters_;
-    std::vector<std::size_t> indices_;
-    std::vector<T> sums_;
-    std::vector<T> compensations_;
-    std::vector<std::size_t> non_zero_calls_;
-    std::vector<std::size_t> finite_calls_;
+    // The parameters of a distribution needed to find the bin of a point, and the index of its
+    // first bin. This avoids copying the name of the distribution for each point.
+    struct binning
+    {
+        T x_min;
+        T y_min;
+        T bin_size_x;
+        T bin_size_y;
+        std::size_t bins_x;
+        std::size_t bins_y;
+        std::size_t offset;
+    };
+
+    void add_to_bin(std::size_t index, T value)
+    {
+        bin_type const bin_value = static_cast <bin_type> (value);
+
+        if (storage::compensated)
+        {
+            accumulate(bin_sums_[2 * index], bin_sums_[2 * index + 1], bin_compensations_[index],
+                bin_value);
+        }
+        else
+        {
+            bin_sums_[2 * index] += bin_value;
+            bin_sums_[2 * index + 1] += bin_value * bin_value;
+        }
+
+        // FIXME: if this function is called more than once, the values are
+        // incorrect
+        ++bin_non_zero_calls_[index];
+        ++bin_finite_calls_[index];
+    }
+
+    // the parameters are shared by all copies, which are made e.g. for each chunk of the parallel
+    // integrators
+    std::shared_ptr<std::vector<hep::distribution_parameters<T>> const> parameters_;
+    std::vector<binning> binnings_;
+    std::array<T, 3> sums_;
+    std::size_t non_zero_calls_;
+    std::size_t finite_calls_;
+    std::vector<bin_type> bin_sums_;
+    std::vector<bin_type> bin_compensations_;
+    std::vector<counter_type> bin_non_zero_calls_;
+    std::vector<counter_type> bin_finite_calls_;
 };
 
 template <typename T>
@@ -269,32 +339,47 @@ public:
     template <typename I, typename P>
     T invoke(I& integrand, P const& point)
     {
-        using std::isfinite;
-
         // call the integrand function with the supplied point. No distributions
         // are generated here
         T value = integrand.function()(point);
 
         if (value != T())
         {
-            value *= point.weight();
+            value = add(value * point.weight());
+        }
 
-            if (isfinite(value))
-            {
-                accumulate(sums_[0], sums_[1], sums_[2], value);
-                ++finite_calls_;
-            }
-            else
-            {
-                value = T();
-            }
+        return value;
+    }
 
-            ++non_zero_calls_;
+    // Adds `value`, which must be the product of a non-zero integrand value with the weight of its
+    // point, and returns it. If it is not finite, zero is returned instead.
+    T add(T value)
+    {
+        using std::isfinite;
+
+        if (isfinite(value))
+        {
+            accumulate(sums_[0], sums_[1], sums_[2], value);
+            ++finite_calls_;
+        }
+        else
+        {
+            value = T();
         }
 
+        ++non_zero_calls_;
+
         return value;
     }
 
+    void merge(accumulator<T, false> const& other)
+    {
+        hep::merge(sums_[0], sums_[2], other.sums_[0], other.sums_[2]);
+        sums_[1] += other.sums_[1];
+        non_zero_calls_ += other.non_zero_calls_;
+        finite_calls_ += other.finite_calls_;
+    }
+
     hep::plain_result<T> result(std::size_t calls) const
     {
         return hep::plain_result<T>(
@@ -34,9 +34,9 @@ namespace hep
 //    Monte Carlo point to the integrand and completely skips the potentially time-consuming
 //    generation of distributions.
 // 2. The accumulation is performed in a central place for all integrators.
-// 3. The intermediate results (sum, sum_of_squars) for all distributions and the total integral is
-//    stored in a single vector that can be easily distributed when the integration is performed on
-//    multiple cores.
+// 3. The intermediate results (sum, sum_of_squars) for all distributions and the total integral are
+//    stored in a few vectors that can be easily merged when the integration is performed on
+//    multiple cores. The types of the bins are chosen by `storage_policy`.
 template <typename T, bool distributions>
 class accumulator;
 
@@ -0,0 +1,293 @@
+#ifndef HEP_MC_ASYNC_CHKPT_WRITER_HPP
+#define HEP_MC_ASYNC_CHKPT_WRITER_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/chkpt_io.hpp"
+#include "hep/mc/chkpt_journal.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// \cond INTERNAL
+
+// Returns a function that adds the last iteration of `chkpt`, i.e. its last result, the random
+// number generator after it, and its timing, to another checkpoint
+template <typename C>
+inline std::function<void(C&)> async_chkpt_last_iteration(C const& chkpt, std::true_type)
+{
+    auto const result = chkpt.results().back();
+    auto const generator = chkpt.generator();
+
+    // the timing is only available if the checkpoint stores timings
+    if (chkpt.store_timings())
+    {
+        auto const timing = chkpt.timings().back();
+
+        return [=](C& snapshot) { snapshot.add(result, generator, timing); };
+    }
+
+    return [=](C& snapshot) { snapshot.add(result, generator); };
+}
+
+template <typename C>
+inline std::function<void(C&)> async_chkpt_last_iteration(C const&, std::false_type)
+{
+    return nullptr;
+}
+
+/// \endcond
+
+/// Writes checkpoints on a background thread, so that the next iteration of an integration can run
+/// while the previous checkpoint is being written. The thread keeps its own copy of the checkpoint.
+/// If the checkpoint passed to \ref write has exactly one result more than the previous one, only
+/// the new result, the random number generator after it, and its timing are copied and added to
+/// the copy of the thread, in the same way a \ref chkpt_journal is replayed. Otherwise, e.g. for
+/// the first call, after a rollback, or for checkpoints without random number generators, the
+/// entire checkpoint is copied. The calling thread therefore only spends the time needed to copy a
+/// single result in \ref write, independently of the number of iterations. If the thread is still
+/// busy when new checkpoints arrive, only the newest one is written afterwards; a journal, however,
+/// receives a record for every iteration. The destructor waits until the last checkpoint has been
+/// written.
+template <typename Checkpoint>
+class async_chkpt_writer
+{
+public:
+    /// Constructor. Checkpoints are written to `filename` using `format`, see \ref save_chkpt.
+    async_chkpt_writer(std::string const& filename, chkpt_format format)
+        : filename_(filename)
+        , format_(format)
+        , journal_(filename)
+        , results_(0)
+        , snapshot_sent_(false)
+        , busy_(false)
+        , stop_(false)
+    {
+        thread_ = std::thread(&async_chkpt_writer::run, this);
+    }
+
+    async_chkpt_writer(async_chkpt_writer const&) = delete;
+
+    async_chkpt_writer& operator=(async_chkpt_writer const&) = delete;
+
+    /// Destructor. Writes the last checkpoint and stops the background thread. If writing failed,
+    /// the error is printed to `std::cerr` unless it was already reported by \ref flush.
+    ~async_chkpt_writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        condition_.notify_all();
+        thread_.join();
+
+        if (error_)
+        {
+            try
+            {
+                std::rethrow_exception(error_);
+            }
+            catch (std::exception const& exception)
+            {
+                std::cerr << "writing checkpoint `" << filename_ << "` failed: "
+                    << exception.what() << '\n';
+            }
+            catch (...)
+            {
+                std::cerr << "writing checkpoint `" << filename_ << "` failed\n";
+            }
+        }
+    }
+
+    /// Schedules `chkpt` to be written. If a previous write failed, its exception is rethrown. New
+    /// iterations are detected by the number of results, so a checkpoint with exactly one result
+    /// more than the previous one must be the previous checkpoint with one added iteration.
+    void write(Checkpoint const& chkpt)
+    {
+        std::size_t const results = chkpt.results().size();
+        bool const append = chkpt_has_generator<Checkpoint>::value && snapshot_sent_ &&
+            (results == results_ + 1);
+
+        // copy the data before taking the lock, so that the thread is not blocked by it
+        std::function<void(snapshot_type&)> iteration;
+        std::unique_ptr<snapshot_type> copy;
+
+        if (append)
+        {
+            iteration = async_chkpt_last_iteration(chkpt, chkpt_has_generator<Checkpoint>());
+        }
+        else
+        {
+            copy.reset(new snapshot_type(chkpt));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rethrow();
+
+            if (append)
+            {
+                pending_iterations_.push_back(std::move(iteration));
+            }
+            else
+            {
+                // the new checkpoint supersedes all iterations that have not been added yet
+                pending_snapshot_ = std::move(copy);
+                pending_iterations_.clear();
+            }
+        }
+
+        results_ = results;
+        snapshot_sent_ = true;
+
+        condition_.notify_all();
+    }
+
+    /// Waits until all scheduled checkpoints have been written. If writing failed, the exception
+    /// is rethrown.
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&] { return !pending() && !busy_; });
+        rethrow();
+    }
+
+private:
+    // the copy of the thread must be modifiable, even if `Checkpoint` is const-qualified
+    using snapshot_type = typename std::remove_const<Checkpoint>::type;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (;;)
+        {
+            condition_.wait(lock, [&] { return pending() || stop_; });
+
+            if (!pending())
+            {
+                break;
+            }
+
+            std::unique_ptr<snapshot_type> snapshot = std::move(pending_snapshot_);
+            std::vector<std::function<void(snapshot_type&)>> iterations;
+            iterations.swap(pending_iterations_);
+            busy_ = true;
+            lock.unlock();
+
+            std::exception_ptr error;
+
+            try
+            {
+                if (snapshot)
+                {
+                    snapshot_ = std::move(snapshot);
+
+                    if (format_ == chkpt_format::journal)
+                    {
+                        journal_.write(*snapshot_);
+                    }
+                }
+
+                for (auto const& iteration : iterations)
+                {
+                    iteration(*snapshot_);
+
+                    // every iteration is appended, so that the journal is never rewritten
+                    if (format_ == chkpt_format::journal)
+                    {
+                        journal_.write(*snapshot_);
+                    }
+                }
+
+                if (format_ != chkpt_format::journal)
+                {
+                    save_chkpt(*snapshot_, filename_, format_);
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            busy_ = false;
+
+            if (error)
+            {
+                error_ = error;
+            }
+
+            condition_.notify_all();
+        }
+    }
+
+    bool pending() const
+    {
+        return pending_snapshot_ || !pending_iterations_.empty();
+    }
+
+    void rethrow()
+    {
+        if (error_)
+        {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::string filename_;
+    chkpt_format format_;
+    chkpt_journal<Checkpoint> journal_;
+    std::size_t results_;
+    bool snapshot_sent_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::unique_ptr<snapshot_type> pending_snapshot_;
+    std::vector<std::function<void(snapshot_type&)>> pending_iterations_;
+    std::unique_ptr<snapshot_type> snapshot_;
+    bool busy_;
+    bool stop_;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef HEP_MC_BATCH_INTEGRAND_HPP
+#define HEP_MC_BATCH_INTEGRAND_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/distribution_parameters.hpp"
+#include "hep/mc/integrand.hpp"
+#include "hep/mc/multi_channel_integrand.hpp"
+#include "hep/mc/uniform_random.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup integrands
+/// @{
+
+/// Class representing a function that evaluates a batch of points at once and that can be
+/// integrated using the PLAIN-like algorithms. Batch integrands do not support distributions.
+template <typename T, typename F>
+class batch_integrand : public integrand<T, F, false>
+{
+public:
+    /// Signals that this integrand evaluates many points at once.
+    static constexpr bool is_batch = true;
+
+    /// Constructor. Instead of using the constructor directly you should consider using the helper
+    /// function \ref make_batch_integrand.
+    template <typename G>
+    batch_integrand(G&& function, std::size_t dimensions, std::size_t batch_size)
+        : integrand<T, F, false>(std::forward<G>(function), dimensions,
+            std::vector<distribution_parameters<T>>())
+        , batch_size_(batch_size)
+    {
+    }
+
+    /// Returns the largest number of points that are passed to the function at once.
+    std::size_t batch_size() const
+    {
+        return batch_size_;
+    }
+
+private:
+    std::size_t batch_size_;
+};
+
+/// Template alias for a \ref batch_integrand with its type `F` decayed with `std::decay`.
+template <typename T, typename F>
+using batch_integrand_type = batch_integrand<T, typename std::decay<F>::type>;
+
+/// Class representing a function that evaluates a batch of points at once and that can be
+/// integrated using the multi channel algorithms.
+template <typename T, typename F, typename M>
+class multi_channel_batch_integrand : public multi_channel_integrand<T, F, M, false>
+{
+public:
+    /// Signals that this integrand evaluates many points at once.
+    static constexpr bool is_batch = true;
+
+    /// Constructor. Instead of using the constructor directly you should consider using the helper
+    /// function \ref make_multi_channel_batch_integrand.
+    template <typename G, typename N>
+    multi_channel_batch_integrand(
+        G&& function,
+        std::size_t dimensions,
+        N&& map,
+        std::size_t map_dimensions,
+        std::size_t channels,
+        std::size_t batch_size
+    )
+        : multi_channel_integrand<T, F, M, false>(std::forward<G>(function), dimensions,
+            std::forward<N>(map), map_dimensions, channels,
+            std::vector<distribution_parameters<T>>())
+        , batch_size_(batch_size)
+    {
+    }
+
+    /// Returns the largest number of points that are passed to the function at once.
+    std::size_t batch_size() const
+    {
+        return batch_size_;
+    }
+
+private:
+    std::size_t batch_size_;
+};
+
+/// Template alias for a \ref multi_channel_batch_integrand with its types `F` and `M` decayed with
+/// `std::decay`.
+template <typename T, typename F, typename M>
+using multi_channel_batch_integrand_type = multi_channel_batch_integrand<T,
+    typename std::decay<F>::type, typename std::decay<M>::type>;
+
+/// PLAIN/VEGAS batch integrand constructor. The integrators pass up to `batch_size` points at once
+/// to `function`, which must write the value of the integrand for each point into `values`. The
+/// points are captured by an \ref mc_batch, or for VEGAS by a \ref vegas_batch if the bins are
+/// needed:
+/// \code
+/// void function(hep::mc_batch<T> const& batch, std::vector<T>& values)
+/// {
+///     T const* x = batch.point(0);
+///     T const* y = batch.point(1);
+///
+///     for (std::size_t i = 0; i != batch.size(); ++i)
+///     {
+///         values[i] = /* calculate the function value from x[i] and y[i] */;
+///     }
+/// }
+/// \endcode
+/// The random numbers are drawn in the same order as for an integrand created with \ref
+/// make_integrand, so that both integrands yield the same results.
+template <typename T, typename F>
+inline batch_integrand_type<T, F> make_batch_integrand(
+    F&& function,
+    std::size_t dimensions,
+    std::size_t batch_size
+) {
+    return batch_integrand_type<T, F>(std::forward<F>(function), dimensions, batch_size);
+}
+
+/// Multi channel batch integrand constructor. The parameters are the same as for \ref
+/// make_multi_channel_integrand, with `function` evaluating up to `batch_size` points at once:
+/// \code
+/// void function(hep::multi_channel_batch<T> const& batch, std::vector<T>& values);
+/// \endcode
+/// The function `map` is called for each point separately. Since the densities are calculated
+/// after `function` has been evaluated for the whole batch, `map` must calculate them when called
+/// with \ref multi_channel_map::calculate_densities.
+template <typename T, typename F, typename M>
+inline multi_channel_batch_integrand_type<T, F, M> make_multi_channel_batch_integrand(
+    F&& function,
+    std::size_t dimensions,
+    M&& map,
+    std::size_t map_dimensions,
+    std::size_t channels,
+    std::size_t batch_size
+) {
+    return multi_channel_batch_integrand_type<T, F, M>(
+        std::forward<F>(function),
+        dimensions,
+        std::forward<M>(map),
+        map_dimensions,
+        channels,
+        batch_size
+    );
+}
+
+/// @}
+
+/// \cond INTERNAL
+
+// Returns the number of points the integrators store for a batch when `calls` points must be
+// evaluated, which is never zero.
+template <typename I>
+inline std::size_t batch_capacity(I const& integrand, std::size_t calls)
+{
+    return std::max(std::size_t(1), std::min(integrand.batch_size(), calls));
+}
+
+// Generates the coordinates of `size` points in the same order as for integrands evaluating single
+// points, using `random_numbers` as buffer, and stores them as a structure of arrays in `points`.
+template <typename R, typename T>
+inline void batch_generate_points(
+    R& generator,
+    std::size_t size,
+    std::size_t capacity,
+    std::vector<T>& random_numbers,
+    std::vector<T>& points
+) {
+    std::size_t const dimensions = points.size() / capacity;
+
+    generate_uniform(generator, random_numbers.data(), random_numbers.data() + size * dimensions);
+
+    for (std::size_t i = 0; i != dimensions; ++i)
+    {
+        for (std::size_t j = 0; j != size; ++j)
+        {
+            points[i * capacity + j] = random_numbers[j * dimensions + i];
+        }
+    }
+}
+
+/// \endcond
+
+}
+
+#endif
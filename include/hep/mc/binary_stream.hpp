@@ -0,0 +1,311 @@
+#ifndef HEP_MC_BINARY_STREAM_HPP
+#define HEP_MC_BINARY_STREAM_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// \cond INTERNAL
+
+// The first bytes of every binary checkpoint
+inline char const* binary_chkpt_magic()
+{
+    return "hepmcchk";
+}
+
+// The version of the binary format, which must be increased whenever the layout changes. Version 2
+// added the timing of each iteration, version 3 the pruned channels of multi channel checkpoints
+constexpr std::uint32_t binary_chkpt_version = 3;
+
+// Written in the byte order of the machine creating the file, so that a reader can detect whether
+// it must reverse the bytes of every number
+constexpr std::uint32_t binary_chkpt_endian_tag = 0x01020304;
+
+/// \endcond
+
+/// Returns `true` if the `size` bytes at `data` start with the header of a binary checkpoint.
+inline bool is_binary_chkpt(char const* data, std::size_t size)
+{
+    return (size >= 8) && (std::memcmp(data, binary_chkpt_magic(), 8) == 0);
+}
+
+/// Writes the binary checkpoint format to a stream. The data starts with a header consisting of
+/// eight magic bytes, a 32-bit tag recording the byte order of the writing machine and a 32-bit
+/// version number. Numbers are written in their native representation, sizes as 64-bit unsigned
+/// integers and strings as their size followed by their characters. The stream must be opened in
+/// binary mode.
+class binary_writer
+{
+public:
+    /// Constructor. Writes the header to `out`.
+    explicit binary_writer(std::ostream& out)
+        : out_(out)
+    {
+        out_.write(binary_chkpt_magic(), 8);
+        write(binary_chkpt_endian_tag);
+        write(binary_chkpt_version);
+    }
+
+    /// Writes the number `value`.
+    template <typename U>
+    void write(U value)
+    {
+        static_assert (std::is_arithmetic<U>::value, "only numbers can be written");
+
+        out_.write(reinterpret_cast <char const*> (&value), sizeof (U));
+    }
+
+    /// Writes the `size` numbers at `values`, but not their number.
+    template <typename U>
+    void write(U const* values, std::size_t size)
+    {
+        static_assert (std::is_arithmetic<U>::value, "only numbers can be written");
+
+        out_.write(reinterpret_cast <char const*> (values), size * sizeof (U));
+    }
+
+    /// Writes the size and the numbers of `values`.
+    template <typename U>
+    void write(std::vector<U> const& values)
+    {
+        write_size(values.size());
+        write(values.data(), values.size());
+    }
+
+    /// Writes the string `value`.
+    void write(std::string const& value)
+    {
+        write_size(value.size());
+        out_.write(value.data(), value.size());
+    }
+
+    /// Writes `size` as a 64-bit unsigned integer.
+    void write_size(std::size_t size)
+    {
+        write(static_cast <std::uint64_t> (size));
+    }
+
+private:
+    std::ostream& out_;
+};
+
+/// Reads the binary checkpoint format written by \ref binary_writer from a contiguous region of
+/// memory, for example a \ref mapped_file. Arrays of numbers are copied with a single
+/// `std::memcpy` instead of being parsed. If the data was written on a machine with a different
+/// byte order, the bytes of every number are reversed. All functions throw `std::runtime_error` if
+/// the data is truncated.
+class binary_reader
+{
+public:
+    /// Constructor. Checks the header at the beginning of the `size` bytes at `data`, which must
+    /// stay valid for the lifetime of this object, and throws `std::runtime_error` if it is not the
+    /// header of a binary checkpoint with a supported version. Data written with an older version
+    /// can be read, see \ref version.
+    binary_reader(char const* data, std::size_t size)
+        : data_(data)
+        , size_(size)
+        , position_(0)
+        , swap_bytes_(false)
+        , version_(0)
+    {
+        if (!is_binary_chkpt(data, size))
+        {
+            throw std::runtime_error("data is not a binary checkpoint");
+        }
+
+        position_ = 8;
+
+        std::uint32_t const tag = read<std::uint32_t>();
+
+        if (tag != binary_chkpt_endian_tag)
+        {
+            if (swap(tag) != binary_chkpt_endian_tag)
+            {
+                throw std::runtime_error("binary checkpoint has an unknown byte order");
+            }
+
+            swap_bytes_ = true;
+        }
+
+        version_ = swap_if_needed(read_raw<std::uint32_t>());
+
+        if ((version_ == 0) || (version_ > binary_chkpt_version))
+        {
+            throw std::runtime_error("binary checkpoint has an unsupported version");
+        }
+    }
+
+    /// Reads a single number.
+    template <typename U>
+    U read()
+    {
+        return swap_if_needed(read_raw<U>());
+    }
+
+    /// Reads `size` numbers into the array `values`.
+    template <typename U>
+    void read(U* values, std::size_t size)
+    {
+        static_assert (std::is_arithmetic<U>::value, "only numbers can be read");
+
+        require<U>(size);
+
+        std::size_t const bytes = size * sizeof (U);
+
+        std::memcpy(values, data_ + position_, bytes);
+        position_ += bytes;
+
+        if (swap_bytes_)
+        {
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                values[i] = swap(values[i]);
+            }
+        }
+    }
+
+    /// Reads numbers written with \ref binary_writer::write for vectors.
+    template <typename U>
+    std::vector<U> read_vector()
+    {
+        std::size_t const size = read_size();
+
+        // check the size before allocating memory for it
+        require<U>(size);
+
+        std::vector<U> values(size);
+        read(values.data(), size);
+
+        return values;
+    }
+
+    /// Reads a string.
+    std::string read_string()
+    {
+        std::size_t const size = read_size();
+        require_bytes(size);
+
+        std::string value(data_ + position_, size);
+        position_ += size;
+
+        return value;
+    }
+
+    /// Reads a size written by \ref binary_writer::write_size.
+    std::size_t read_size()
+    {
+        return static_cast <std::size_t> (read<std::uint64_t>());
+    }
+
+    /// Returns `true` if the data was written on a machine with a different byte order.
+    bool swap_bytes() const
+    {
+        return swap_bytes_;
+    }
+
+    /// Returns the version of the format the data was written with, which deserialization
+    /// constructors use to skip data that older versions did not write.
+    std::uint32_t version() const
+    {
+        return version_;
+    }
+
+    /// Returns the number of bytes that have not been read yet.
+    std::size_t remaining() const
+    {
+        return size_ - position_;
+    }
+
+private:
+    void require_bytes(std::size_t bytes) const
+    {
+        if (bytes > remaining())
+        {
+            throw std::runtime_error("binary checkpoint is truncated");
+        }
+    }
+
+    // Checks that `size` numbers of the type `U` are left; dividing instead of multiplying avoids
+    // an overflow for corrupt sizes
+    template <typename U>
+    void require(std::size_t size) const
+    {
+        if (size > remaining() / sizeof (U))
+        {
+            throw std::runtime_error("binary checkpoint is truncated");
+        }
+    }
+
+    template <typename U>
+    U read_raw()
+    {
+        static_assert (std::is_arithmetic<U>::value, "only numbers can be read");
+
+        require_bytes(sizeof (U));
+
+        U value;
+        std::memcpy(&value, data_ + position_, sizeof (U));
+        position_ += sizeof (U);
+
+        return value;
+    }
+
+    template <typename U>
+    U swap_if_needed(U value) const
+    {
+        return swap_bytes_ ? swap(value) : value;
+    }
+
+    template <typename U>
+    static U swap(U value)
+    {
+        char bytes[sizeof (U)];
+        std::memcpy(bytes, &value, sizeof (U));
+        std::reverse(bytes, bytes + sizeof (U));
+        std::memcpy(&value, bytes, sizeof (U));
+
+        return value;
+    }
+
+    char const* data_;
+    std::size_t size_;
+    std::size_t position_;
+    bool swap_bytes_;
+    std::uint32_t version_;
+};
+
+/// @}
+
+}
+
+#endif
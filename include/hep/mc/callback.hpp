@@ -19,14 +19,16 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/async_chkpt_writer.hpp"
 #include "hep/mc/chkpt.hpp"
+#include "hep/mc/chkpt_io.hpp"
 #include "hep/mc/mc_helper.hpp"
-#include "hep/mc/multi_channel_chkpt.hpp"
+#include "hep/mc/multi_channel_result.hpp"
 #include "hep/mc/multi_channel_summary.hpp"
 
 #include <cmath>
-#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <type_traits>
 
@@ -64,14 +66,25 @@ public:
     /// is \ref callback_mode::verbose_and_write_chkpt, then `filename` is the file the checkpoint
     /// is written to. If `target_rel_err` is strictly larger than zero, the integration is stopped
     /// if the accumulated result has a relative precision which is better than `target_rel_err`.
+    /// Checkpoints are written using `format`; with \ref chkpt_format::journal only the first call
+    /// writes the entire checkpoint, and every further call appends the new result. If
+    /// `asynchronous` is `true`, checkpoints are written by an \ref async_chkpt_writer while the
+    /// integrator performs the next iteration. The writer is created by the first call of \ref
+    /// operator()(), which integrators make on their own copy of the callback, so that the last
+    /// checkpoint has been written when the integrator returns.
     callback(
         callback_mode mode = callback_mode::verbose,
         std::string const& filename = "",
-        numeric_type target_rel_err = numeric_type()
+        numeric_type target_rel_err = numeric_type(),
+        chkpt_format format = chkpt_format::text,
+        bool asynchronous = false
     )
         : mode_{mode}
         , filename_{filename}
         , target_rel_err_{target_rel_err}
+        , format_{format}
+        , journal_{filename}
+        , asynchronous_{asynchronous}
     {
     }
 
@@ -82,8 +95,11 @@ public:
         using std::fabs;
         using T = numeric_type;
 
+        // the statistics are updated by the checkpoint, so this does not depend on the number of
+        // iterations
         auto const& results = chkpt.results();
-        auto const result = accumulate<weighted_with_variance>(results.begin(), results.end());
+        auto const& statistics = chkpt.statistics();
+        auto const result = statistics.result();
 
         std::size_t const num_all = result.calls();
         T const val_all = result.value();
@@ -96,12 +112,14 @@ public:
         {
             std::cout << "iteration " << (results.size() - 1) << " finished.\n";
 
-//            if constexpr (std::is_base_of_v<multi_channel_chkpt<T>, Checkpoint>)
-            if (std::is_base_of<multi_channel_chkpt<T>, Checkpoint>::value)
+            using result_type = typename Checkpoint::result_type;
+
+//            if constexpr (std::is_base_of_v<multi_channel_result<T>, result_type>)
+            if (std::is_base_of<multi_channel_result<T>, result_type>::value)
             {
-//                multi_channel_summary(chkpt, std::cout);
-                multi_channel_summary(dynamic_cast <multi_channel_chkpt<T> const&> (chkpt),
-                    std::cout);
+//                multi_channel_summary(results.back(), std::cout);
+                multi_channel_summary(dynamic_cast <multi_channel_result<T> const&>
+                    (results.back()), std::cout);
             }
 
             // print result for this iteration
@@ -116,9 +134,28 @@ public:
             std::cout << "this iteration: N=" << num << " E=" << val << " +- " << err << " ("
                 << (T(100.0) * rel_err) << "%) eff=" << eff << "% nnf=" << nnf << '\n';
 
+            // print timing for this iteration, unless it was read from an old checkpoint
+
+            auto const& timing = chkpt.timings().back();
+
+            if (timing.wall_time() > 0.0)
+            {
+                std::cout << "time: T=" << timing.wall_time() << "s integrand="
+                    << timing.integrand_time() << "s other=" << timing.overhead_time()
+                    << "s calls/s=" << timing.calls_per_second(num);
+
+                if (timing.processes() != 0)
+                {
+                    std::cout << " reduction=" << timing.reduction_time() << "s imbalance="
+                        << timing.imbalance() << " slowest rank=" << timing.slowest_process();
+                }
+
+                std::cout << '\n';
+            }
+
             // print result for all iterations
 
-            T const chi = chi_square_dof<weighted_with_variance>(results.begin(), results.end());
+            T const chi = statistics.chi_square_dof();
 
             std::cout << "all iterations: N=" << num_all << " E=" << val_all << " +- " << err_all
                 << " (" << (T(100.0) * rel_err_all) << "%) chi^2/dof=" << chi << '\n' << std::endl;
@@ -127,8 +164,23 @@ public:
         if ((mode_ == callback_mode::silent_and_write_chkpt) ||
             (mode_ == callback_mode::verbose_and_write_chkpt))
         {
-            std::ofstream out(filename_);
-            chkpt.serialize(out);
+            if (asynchronous_)
+            {
+                if (!writer_)
+                {
+                    writer_ = std::make_shared<async_chkpt_writer<Checkpoint>>(filename_, format_);
+                }
+
+                writer_->write(chkpt);
+            }
+            else if (format_ == chkpt_format::journal)
+            {
+                journal_.write(chkpt);
+            }
+            else
+            {
+                save_chkpt(chkpt, filename_, format_);
+            }
         }
 
         return perform_more_iterations;
@@ -146,10 +198,23 @@ public:
         return mode_;
     }
 
+    /// Waits until all checkpoints written asynchronously by this callback are on disk.
+    void flush()
+    {
+        if (writer_)
+        {
+            writer_->flush();
+        }
+    }
+
 private:
     callback_mode mode_;
     std::string filename_;
     numeric_type target_rel_err_;
+    chkpt_format format_;
+    chkpt_journal<Checkpoint> journal_;
+    bool asynchronous_;
+    std::shared_ptr<async_chkpt_writer<Checkpoint>> writer_;
 };
 
 /// @}
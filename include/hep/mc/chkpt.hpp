@@ -19,10 +19,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/binary_stream.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/running_statistics.hpp"
+
 #include <cassert>
+#include <cstdint>
 #include <istream>
 #include <limits>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -41,16 +48,26 @@ public:
     /// The type of results this class stores. See \ref results for the different result types.
     using result_type = Result;
 
+    /// The numeric type of the results.
+    using numeric_type = typename Result::numeric_type;
+
     /// Default constructor.
     chkpt() = default;
 
     /// Deserialization constructor. This creates a checkpoint by reading from the stream `in`.
     explicit chkpt(std::istream& in)
     {
-        // if the first line starts with a header, ignore it
+        // version two contains the timings; checkpoints without a header use version one
+        unsigned version = 1;
+
         if (in.peek() == '#')
         {
-            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::string header;
+            std::getline(in, header);
+
+            std::string hash;
+            std::string name;
+            std::istringstream(header) >> hash >> name >> version;
         }
 
         std::size_t size = 0;
@@ -62,6 +79,42 @@ public:
         {
             results_.emplace_back(in);
         }
+
+        store_timings_ = (version >= 2);
+        read_timings(in);
+        compute_statistics();
+    }
+
+    /// Deserialization constructor for the binary format. Throws `std::runtime_error` if the
+    /// checkpoint was written with a different result or numeric type.
+    explicit chkpt(binary_reader& in)
+    {
+        std::string const name = in.read_string();
+
+        if (name != result_type::result_name())
+        {
+            throw std::runtime_error("binary checkpoint contains `" + name + "`, expected `" +
+                result_type::result_name() + "`");
+        }
+
+        if ((in.read<std::uint32_t>() != sizeof (numeric_type)) ||
+            (in.read<std::uint32_t>() != std::numeric_limits<numeric_type>::digits))
+        {
+            throw std::runtime_error("binary checkpoint has a different numeric type");
+        }
+
+        std::size_t const size = in.read_size();
+
+        results_.reserve(size);
+
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            results_.emplace_back(in);
+        }
+
+        store_timings_ = (in.version() >= 2) && (in.read<std::uint8_t>() != 0);
+        read_timings(in);
+        compute_statistics();
     }
 
     /// Copy constructor.
@@ -82,6 +135,42 @@ public:
         return results_;
     }
 
+    /// Returns the timing of each iteration; the element with index `i` belongs to the result
+    /// with the same index.
+    std::vector<iteration_timing> const& timings() const
+    {
+        return timings_;
+    }
+
+    /// Returns the statistics of all results, i.e. the cumulative result and the \f$ \chi^2 \f$,
+    /// which are updated with each added result instead of being recomputed from \ref results.
+    running_statistics<numeric_type> const& statistics() const
+    {
+        return statistics_.back();
+    }
+
+    /// Returns the statistics of the first `iteration` results, which are the \ref statistics
+    /// this checkpoint had before \ref rollback was called with the same argument.
+    running_statistics<numeric_type> const& statistics(std::size_t iteration) const
+    {
+        return statistics_.at(iteration);
+    }
+
+    /// Returns whether the timings are serialized, see \ref store_timings(bool).
+    bool store_timings() const
+    {
+        return store_timings_;
+    }
+
+    /// If `store` is `true`, the \ref timings are serialized together with the results. By
+    /// default they are not, so that integrations with the same parameters write identical
+    /// checkpoints. Checkpoints that are read from a stream store the timings if the stream
+    /// contains them. This setting does not change \ref timings, which are always recorded.
+    void store_timings(bool store)
+    {
+        store_timings_ = store;
+    }
+
     /// Destructor.
     virtual ~chkpt() = default;
 
@@ -96,6 +185,8 @@ public:
         }
 
         results_.erase(results_.begin() + iteration, results_.end());
+        timings_.erase(timings_.begin() + iteration, timings_.end());
+        statistics_.erase(statistics_.begin() + iteration + 1, statistics_.end());
     }
 
     /// Serializes this object. This writes a textual representation of this class to the stream
@@ -103,7 +194,7 @@ public:
     virtual void serialize(std::ostream& out) const
     {
         // write header containing version and numeric type info
-        out << "# " << result_type::result_name() << " 1 "
+        out << "# " << result_type::result_name() << ' ' << (store_timings_ ? 2 : 1) << ' '
             << std::numeric_limits<typename Result::numeric_type>::max_digits10 << '\n';
 
         std::size_t const size = results_.size();
@@ -115,10 +206,94 @@ public:
             out << '\n';
             results_.at(i).serialize(out);
         }
+
+        if (store_timings_)
+        {
+            for (auto const& timing : timings_)
+            {
+                out << '\n';
+                timing.serialize(out);
+            }
+        }
+    }
+
+    /// Serializes this object using the binary format, see \ref binary_writer. Besides the
+    /// results, this writes the name of the result type and the size and precision of its numeric
+    /// type, which are checked when reading the checkpoint.
+    virtual void serialize(binary_writer& out) const
+    {
+        out.write(std::string(result_type::result_name()));
+        out.write(static_cast <std::uint32_t> (sizeof (numeric_type)));
+        out.write(static_cast <std::uint32_t> (std::numeric_limits<numeric_type>::digits));
+        out.write_size(results_.size());
+
+        for (auto const& result : results_)
+        {
+            result.serialize(out);
+        }
+
+        out.write(static_cast <std::uint8_t> (store_timings_ ? 1 : 0));
+
+        if (store_timings_)
+        {
+            for (auto const& timing : timings_)
+            {
+                timing.serialize(out);
+            }
+        }
     }
 
 protected:
+    /// Appends `result` to the results, together with an unknown timing. Derived checkpoints can
+    /// hide this function to process new results, which \ref chkpt_with_rng::add then calls
+    /// instead.
+    void add_result(Result const& result)
+    {
+        results_.push_back(result);
+        timings_.emplace_back();
+        statistics_.push_back(statistics_.back());
+        statistics_.back().add(result);
+    }
+
     std::vector<Result> results_;
+    std::vector<iteration_timing> timings_;
+
+private:
+    // Reads one timing for each result if the checkpoint contains them
+    template <typename Stream>
+    void read_timings(Stream& in)
+    {
+        timings_.reserve(results_.size());
+
+        for (std::size_t i = 0; i != results_.size(); ++i)
+        {
+            if (store_timings_)
+            {
+                timings_.emplace_back(in);
+            }
+            else
+            {
+                timings_.emplace_back();
+            }
+        }
+    }
+
+    // Computes the statistics of each iteration from the results that were read
+    void compute_statistics()
+    {
+        statistics_.reserve(results_.size() + 1);
+
+        for (auto const& result : results_)
+        {
+            statistics_.push_back(statistics_.back());
+            statistics_.back().add(result);
+        }
+    }
+
+    // the element with index `i` contains the statistics of the first `i` results
+    std::vector<running_statistics<numeric_type>> statistics_ =
+        std::vector<running_statistics<numeric_type>>(1);
+    bool store_timings_ = false;
 };
 
 /// Class representing a checkpoint together with a random number generators which were used to
@@ -149,13 +324,32 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit chkpt_with_rng(binary_reader& in)
+        : Checkpoint(in)
+    {
+        std::size_t const size = this->results().size() + 1;
+
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            std::istringstream state(in.read_string());
+            RandomNumberEngine rne;
+            state >> rne;
+            generators_.push_back(rne);
+        }
+    }
+
     /// Adds a result and a random number generator to this checkpoint. The argument `result` must
     /// correspond to the result created with the random number generator returned previously with
     /// \ref generator. The argument `generator` will be random number generator for the next
-    /// iteration.
-    void add(typename Checkpoint::result_type const& result, RandomNumberEngine const& generator)
-    {
-        this->results_.push_back(result);
+    /// iteration. The time the iteration took is recorded from `timing`.
+    void add(
+        typename Checkpoint::result_type const& result,
+        RandomNumberEngine const& generator,
+        iteration_timing const& timing = iteration_timing()
+    ) {
+        Checkpoint::add_result(result);
+        this->timings_.back() = timing;
         generators_.push_back(generator);
     }
 
@@ -168,7 +362,7 @@ public:
     void rollback(std::size_t iteration) override
     {
         Checkpoint::rollback(iteration);
-        generators_.erase(generators_.begin() + iteration, generators_.end());
+        generators_.erase(generators_.begin() + iteration + 1, generators_.end());
     }
 
     void serialize(std::ostream& out) const override
@@ -183,6 +377,21 @@ public:
         }
     }
 
+    void serialize(binary_writer& out) const override
+    {
+        Checkpoint::serialize(out);
+
+        assert( generators_.size() == (this->results().size() + 1) );
+
+        // generators only define their state through the stream operators
+        for (auto const& generator : generators_)
+        {
+            std::ostringstream state;
+            state << generator;
+            out.write(state.str());
+        }
+    }
+
 private:
     std::vector<RandomNumberEngine> generators_;
 };
@@ -0,0 +1,137 @@
+#ifndef HEP_MC_CHKPT_IO_HPP
+#define HEP_MC_CHKPT_IO_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/binary_stream.hpp"
+#include "hep/mc/chkpt_journal.hpp"
+#include "hep/mc/mapped_file.hpp"
+
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// The formats checkpoints can be written in.
+enum class chkpt_format
+{
+    /// Human-readable text, which is written by the `serialize(std::ostream&)` member functions.
+    text,
+
+    /// Binary format written with \ref binary_writer. Numbers are stored with their native
+    /// representation, which makes files smaller and allows them to be loaded without parsing.
+    binary,
+
+    /// Binary \ref chkpt_journal, to which \ref callback appends only the result of each new
+    /// iteration.
+    journal
+};
+
+/// Writes the checkpoint `chkpt` to the file `filename` using `format`. Throws
+/// `std::runtime_error` if the file can not be written.
+template <typename Checkpoint>
+inline void save_chkpt(
+    Checkpoint const& chkpt,
+    std::string const& filename,
+    chkpt_format format = chkpt_format::text
+) {
+    if (format == chkpt_format::journal)
+    {
+        chkpt_journal<Checkpoint>(filename).write(chkpt);
+
+        return;
+    }
+
+    std::ofstream out;
+
+    if (format == chkpt_format::binary)
+    {
+        out.open(filename, std::ios::binary);
+
+        binary_writer writer(out);
+        chkpt.serialize(writer);
+    }
+    else
+    {
+        out.open(filename);
+        chkpt.serialize(out);
+    }
+
+    out.flush();
+
+    if (!out)
+    {
+        throw std::runtime_error("could not write checkpoint `" + filename + "`");
+    }
+}
+
+/// Reads a checkpoint of type `Checkpoint`, e.g. \ref default_vegas_chkpt, from the file
+/// `filename`. The format is determined from the contents of the file. Binary checkpoints and
+/// journals are mapped into memory with \ref mapped_file and read without parsing; the records of
+/// a journal are replayed. Throws `std::runtime_error` if the file is empty or a binary checkpoint
+/// does not match `Checkpoint`.
+template <typename Checkpoint>
+inline Checkpoint load_chkpt(std::string const& filename)
+{
+    mapped_file const file(filename);
+
+    if (file.size() == 0)
+    {
+        throw std::runtime_error("checkpoint `" + filename + "` is empty");
+    }
+
+    if (is_binary_chkpt(file.data(), file.size()))
+    {
+        binary_reader reader(file.data(), file.size());
+
+        return Checkpoint(reader);
+    }
+
+    if (is_chkpt_journal(file.data(), file.size()))
+    {
+        return replay_chkpt_journal<Checkpoint>(file.data(), file.size());
+    }
+
+    std::ifstream in(filename);
+
+    return Checkpoint(in);
+}
+
+/// Converts the checkpoint in the file `input` into `format` and writes it to the file `output`.
+/// The type `Checkpoint` must be the type of the stored checkpoint.
+template <typename Checkpoint>
+inline void convert_chkpt(
+    std::string const& input,
+    std::string const& output,
+    chkpt_format format
+) {
+    save_chkpt(load_chkpt<Checkpoint>(input), output, format);
+}
+
+/// @}
+
+}
+
+#endif
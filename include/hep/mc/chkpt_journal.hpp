@@ -0,0 +1,395 @@
+#ifndef HEP_MC_CHKPT_JOURNAL_HPP
+#define HEP_MC_CHKPT_JOURNAL_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/binary_stream.hpp"
+#include "hep/mc/iteration_timing.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <ios>
+#endif
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// \cond INTERNAL
+
+// The first bytes of every checkpoint journal
+inline char const* chkpt_journal_magic()
+{
+    return "hepmcjnl";
+}
+
+// Each record of a journal starts with its size and the checksum of its payload, both of which are
+// stored as little-endian 64-bit integers
+constexpr std::size_t chkpt_journal_record_header = 16;
+
+inline void chkpt_journal_put(std::string& data, std::uint64_t value)
+{
+    for (int i = 0; i != 8; ++i)
+    {
+        data.push_back(static_cast <char> ((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline std::uint64_t chkpt_journal_get(char const* data)
+{
+    std::uint64_t value = 0;
+
+    for (int i = 0; i != 8; ++i)
+    {
+        value |= std::uint64_t(static_cast <unsigned char> (data[i])) << (8 * i);
+    }
+
+    return value;
+}
+
+// 64-bit FNV-1a hash, which detects records that were only partially written
+inline std::uint64_t chkpt_journal_checksum(char const* data, std::size_t size)
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        hash ^= static_cast <unsigned char> (data[i]);
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+inline std::string chkpt_journal_record(std::string const& payload)
+{
+    std::string record;
+    record.reserve(chkpt_journal_record_header + payload.size());
+
+    chkpt_journal_put(record, payload.size());
+    chkpt_journal_put(record, chkpt_journal_checksum(payload.data(), payload.size()));
+    record += payload;
+
+    return record;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+inline void chkpt_journal_write_all(int descriptor, std::string const& data)
+{
+    std::size_t written = 0;
+
+    while (written != data.size())
+    {
+        ::ssize_t const result = ::write(descriptor, data.data() + written, data.size() - written);
+
+        if (result == -1)
+        {
+            throw std::runtime_error("could not write checkpoint journal");
+        }
+
+        written += static_cast <std::size_t> (result);
+    }
+}
+
+// Writes `data` to the file `filename` and makes sure it reaches the disk. If `append` is `false`,
+// the data is written to a temporary file which then replaces `filename`, so that the file is never
+// left in an incomplete state
+inline void chkpt_journal_commit(std::string const& filename, std::string const& data, bool append)
+{
+    std::string const target = append ? filename : (filename + ".tmp");
+    int const flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+    int const descriptor = ::open(target.c_str(), flags, 0644);
+
+    if (descriptor == -1)
+    {
+        throw std::runtime_error("could not open `" + target + "`");
+    }
+
+    try
+    {
+        chkpt_journal_write_all(descriptor, data);
+    }
+    catch (...)
+    {
+        ::close(descriptor);
+        throw;
+    }
+
+    bool const synced = (::fsync(descriptor) == 0);
+    ::close(descriptor);
+
+    if (!synced)
+    {
+        throw std::runtime_error("could not synchronize `" + target + "`");
+    }
+
+    if (!append && (std::rename(target.c_str(), filename.c_str()) != 0))
+    {
+        throw std::runtime_error("could not rename `" + target + "`");
+    }
+}
+
+#else
+
+inline void chkpt_journal_commit(std::string const& filename, std::string const& data, bool append)
+{
+    std::string const target = append ? filename : (filename + ".tmp");
+
+    {
+        std::ofstream out(target, append ? (std::ios::binary | std::ios::app) : std::ios::binary);
+        out.write(data.data(), data.size());
+        out.flush();
+
+        if (!out)
+        {
+            throw std::runtime_error("could not write `" + target + "`");
+        }
+    }
+
+    if (!append)
+    {
+        // not every platform allows renaming onto an existing file
+        std::remove(filename.c_str());
+
+        if (std::rename(target.c_str(), filename.c_str()) != 0)
+        {
+            throw std::runtime_error("could not rename `" + target + "`");
+        }
+    }
+}
+
+#endif
+
+// Determines whether checkpoints of type `C` store random number generators, which are needed to
+// append results to a journal
+template <typename C, typename = void>
+struct chkpt_has_generator : std::false_type
+{
+};
+
+template <typename C>
+struct chkpt_has_generator<C, decltype (void (std::declval<C const&>().generator()))>
+    : std::true_type
+{
+};
+
+template <typename C>
+inline void chkpt_journal_serialize_last(C const& chkpt, binary_writer& out, std::true_type)
+{
+    chkpt.results().back().serialize(out);
+
+    std::ostringstream state;
+    state << chkpt.generator();
+    out.write(state.str());
+
+    if (chkpt.store_timings())
+    {
+        chkpt.timings().back().serialize(out);
+    }
+}
+
+template <typename C>
+inline void chkpt_journal_serialize_last(C const&, binary_writer&, std::false_type)
+{
+}
+
+template <typename C>
+inline void chkpt_journal_add(C& chkpt, binary_reader& in, std::true_type)
+{
+    typename C::result_type const result(in);
+
+    std::istringstream state(in.read_string());
+    auto generator = chkpt.generator();
+    state >> generator;
+
+    // the timing is only written if the checkpoint stores timings
+    if (in.remaining() != 0)
+    {
+        chkpt.add(result, generator, iteration_timing(in));
+    }
+    else
+    {
+        chkpt.add(result, generator);
+    }
+}
+
+template <typename C>
+inline void chkpt_journal_add(C&, binary_reader&, std::false_type)
+{
+    throw std::runtime_error("checkpoint type can not replay the records of a journal");
+}
+
+/// \endcond
+
+/// Returns `true` if the `size` bytes at `data` start with the header of a \ref chkpt_journal.
+inline bool is_chkpt_journal(char const* data, std::size_t size)
+{
+    return (size >= 8) && (std::memcmp(data, chkpt_journal_magic(), 8) == 0);
+}
+
+/// Append-only file of checkpoints. A journal consists of records, each of which is prefixed with
+/// its size and a checksum. The first record is a snapshot of a complete checkpoint in the binary
+/// format, see \ref binary_writer, and every further record contains the result of one iteration
+/// together with the state of the random number generator after it and its timing. Writing a
+/// journal after each iteration therefore costs only the size of the new result, instead of the
+/// size of the entire checkpoint. Journals are read with \ref load_chkpt, which ignores a record at
+/// the end that was not written completely, for example because the program was killed.
+///
+/// Only checkpoints with random number generators, e.g. \ref default_vegas_chkpt, can be appended
+/// to; for other checkpoints every write replaces the journal with a snapshot.
+template <typename Checkpoint>
+class chkpt_journal
+{
+public:
+    /// Constructor. The file `filename` is not touched until \ref write is called.
+    explicit chkpt_journal(std::string const& filename)
+        : filename_(filename)
+        , results_(0)
+        , snapshot_written_(false)
+    {
+    }
+
+    /// Writes the state of `chkpt` to the journal. If the journal already contains all results of
+    /// `chkpt` except the last one, only the last result and the current random number generator
+    /// are appended. Otherwise, e.g. when this function is called for the first time, the file is
+    /// atomically replaced with a snapshot of `chkpt`. On POSIX systems the data is written to
+    /// disk with `fsync` before this function returns.
+    void write(Checkpoint const& chkpt)
+    {
+        std::size_t const results = chkpt.results().size();
+        bool const append = chkpt_has_generator<Checkpoint>::value && snapshot_written_ &&
+            (results == results_ + 1);
+
+        std::ostringstream payload;
+
+        {
+            binary_writer writer(payload);
+
+            if (append)
+            {
+                chkpt_journal_serialize_last(chkpt, writer, chkpt_has_generator<Checkpoint>());
+            }
+            else
+            {
+                chkpt.serialize(writer);
+            }
+        }
+
+        std::string const record = chkpt_journal_record(payload.str());
+
+        if (append)
+        {
+            chkpt_journal_commit(filename_, record, true);
+        }
+        else
+        {
+            chkpt_journal_commit(filename_, chkpt_journal_magic() + record, false);
+            snapshot_written_ = true;
+        }
+
+        results_ = results;
+    }
+
+    /// Returns the name of the file this journal is written to.
+    std::string const& filename() const
+    {
+        return filename_;
+    }
+
+private:
+    std::string filename_;
+    std::size_t results_;
+    bool snapshot_written_;
+};
+
+/// \cond INTERNAL
+
+// Replays the journal stored in the `size` bytes at `data`
+template <typename Checkpoint>
+inline Checkpoint replay_chkpt_journal(char const* data, std::size_t size)
+{
+    std::size_t position = 8;
+
+    // returns the size of the next record or zero if it was not completely written
+    auto const next_record = [&]() -> std::size_t {
+        if (size - position < chkpt_journal_record_header)
+        {
+            return 0;
+        }
+
+        std::uint64_t const record_size = chkpt_journal_get(data + position);
+        std::uint64_t const checksum = chkpt_journal_get(data + position + 8);
+
+        if ((record_size > size - position - chkpt_journal_record_header) ||
+            (chkpt_journal_checksum(data + position + chkpt_journal_record_header,
+                static_cast <std::size_t> (record_size)) != checksum))
+        {
+            return 0;
+        }
+
+        position += chkpt_journal_record_header;
+
+        return static_cast <std::size_t> (record_size);
+    };
+
+    std::size_t record_size = next_record();
+
+    if (record_size == 0)
+    {
+        throw std::runtime_error("checkpoint journal does not contain a complete snapshot");
+    }
+
+    binary_reader snapshot(data + position, record_size);
+    Checkpoint chkpt(snapshot);
+    position += record_size;
+
+    while ((record_size = next_record()) != 0)
+    {
+        binary_reader reader(data + position, record_size);
+        chkpt_journal_add(chkpt, reader, chkpt_has_generator<Checkpoint>());
+        position += record_size;
+    }
+
+    return chkpt;
+}
+
+/// \endcond
+
+/// @}
+
+}
+
+#endif
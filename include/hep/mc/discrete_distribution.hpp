@@ -19,11 +19,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/uniform_random.hpp"
+
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
-#include <limits>
 #include <numeric>
-#include <random>
 #include <vector>
 
 namespace hep
@@ -32,15 +33,16 @@ namespace hep
 /// \cond INTERNAL
 
 // Implements a subset of the functionality of `std::discrete_distribution`, but it uses
-// `std::generate_canonical<T, ...>()` exactly once per random integer.
-template <typename I = int, typename T = double>
-class discrete_distribution
+// `generate_uniform<T>()` exactly once per random integer, which is mapped to an integer by a
+// binary search in the cumulative sums of the weights.
+template <typename I, typename T>
+class cumulative_distribution
 {
 public:
     /// Constructor. Creates a new object using the weights pointed to by the range given with
     /// `begin` and `end`.
     template <typename Iterator>
-    discrete_distribution(Iterator begin, Iterator end)
+    cumulative_distribution(Iterator begin, Iterator end)
         : weight_sums(std::distance(begin, end))
     {
         std::partial_sum(begin, end, weight_sums.begin());
@@ -53,11 +55,11 @@ public:
     }
 
     /// Creates a new random integer using the specified random number generator. The integer is
-    /// generated using exactly one call to `std::generate_canonical`.
+    /// generated using exactly one call to `generate_uniform`.
     template <typename R>
     I operator()(R& generator) const
     {
-        T const value = std::generate_canonical<T, std::numeric_limits<T>::digits>(generator);
+        T const value = generate_uniform<T>(generator);
 
         auto const iterator = std::lower_bound(weight_sums.begin(), weight_sums.end(), value);
 
@@ -70,6 +72,141 @@ private:
     std::vector<T> weight_sums;
 };
 
+// Same as `cumulative_distribution`, but uses Walker's alias method, constructed with Vose's
+// algorithm, so that generating an integer takes constant time. The integer part of the uniform
+// random number scaled with the number of weights selects an entry of the table, and its fractional
+// part selects either the entry itself or its alias.
+template <typename I, typename T>
+class alias_distribution
+{
+public:
+    /// Constructor. Creates a new object using the weights pointed to by the range given with
+    /// `begin` and `end`.
+    template <typename Iterator>
+    alias_distribution(Iterator begin, Iterator end)
+        : probabilities_(begin, end)
+        , aliases_(probabilities_.size())
+    {
+        std::size_t const size = probabilities_.size();
+        T const sum = std::accumulate(probabilities_.begin(), probabilities_.end(), T());
+
+        std::vector<std::size_t> small;
+        std::vector<std::size_t> large;
+        small.reserve(size);
+        large.reserve(size);
+
+        // scale the weights so that their average is one
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            probabilities_[i] *= T(size) / sum;
+            aliases_[i] = i;
+            ((probabilities_[i] < T(1.0)) ? small : large).push_back(i);
+        }
+
+        std::size_t last = size;
+
+        while (!small.empty() && !large.empty())
+        {
+            std::size_t const less = small.back();
+            std::size_t const more = large.back();
+            small.pop_back();
+            last = more;
+
+            // the entry `less` is filled up with the excess of `more`
+            aliases_[less] = more;
+            probabilities_[more] -= T(1.0) - probabilities_[less];
+
+            if (probabilities_[more] < T(1.0))
+            {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+
+        // the remaining entries are one up to rounding errors, except for those with a weight of
+        // zero, which must never be selected
+        for (auto const index : large)
+        {
+            probabilities_[index] = T(1.0);
+        }
+
+        for (auto const index : small)
+        {
+            if ((probabilities_[index] == T()) && (last != size))
+            {
+                aliases_[index] = last;
+            }
+            else
+            {
+                probabilities_[index] = T(1.0);
+            }
+        }
+    }
+
+    /// Creates a new random integer using the specified random number generator. The integer is
+    /// generated using exactly one call to `generate_uniform`.
+    template <typename R>
+    I operator()(R& generator) const
+    {
+        std::size_t const size = probabilities_.size();
+        T const value = generate_uniform<T>(generator) * T(size);
+
+        if (size == 0)
+        {
+            return I();
+        }
+
+        // rounding may map values close to one to `size`
+        std::size_t const index = std::min(static_cast <std::size_t> (value), size - 1);
+        T const fraction = value - T(index);
+
+        return I((fraction < probabilities_[index]) ? index : aliases_[index]);
+    }
+
+private:
+    std::vector<T> probabilities_;
+    std::vector<std::size_t> aliases_;
+};
+
+/// \endcond
+
+/// \addtogroup multi_channel_group
+/// @{
+
+/// Selects the channels of the multi channel integrators with a binary search in the cumulative
+/// sums of the channel weights, which takes a time logarithmic in the number of channels. This is
+/// the default policy of the multi channel integrators, which take it as their first template
+/// parameter `Selection`.
+struct cumulative_selection
+{
+    /// Type that selects a random integer of type `I` using the weights of type `T`.
+    template <typename I, typename T>
+    using distribution = cumulative_distribution<I, T>;
+};
+
+/// Selects the channels of the multi channel integrators with an alias table, which takes a
+/// constant time independent of the number of channels. The table is built in linear time at the
+/// beginning of each iteration. Both policies use a single random number for each selection, but
+/// they map it to different channels, so that the results of the integrators change. The policy is
+/// chosen for each integration, for example
+/// \code
+/// auto const result = hep::multi_channel<hep::alias_selection>(integrand, iteration_calls);
+/// \endcode
+struct alias_selection
+{
+    /// Type that selects a random integer of type `I` using the weights of type `T`.
+    template <typename I, typename T>
+    using distribution = alias_distribution<I, T>;
+};
+
+/// @}
+
+/// \cond INTERNAL
+
+// Type used by the integrators to select channels with the policy `Selection`
+template <typename I = int, typename T = double, typename Selection = cumulative_selection>
+using discrete_distribution = typename Selection::template distribution<I, T>;
+
 /// \endcond
 
 }
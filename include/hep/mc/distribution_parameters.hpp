@@ -19,6 +19,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/binary_stream.hpp"
+
 #include <cstddef>
 #include <iomanip>
 #include <ios>
@@ -73,6 +75,18 @@ public:
         in >> bins_x_ >> x_min_ >> bin_size_x_ >> bins_y_ >> y_min_ >> bin_size_y_;
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit distribution_parameters(binary_reader& in)
+        : name_(in.read_string())
+    {
+        bins_x_ = in.read_size();
+        x_min_ = in.read<T>();
+        bin_size_x_ = in.read<T>();
+        bins_y_ = in.read_size();
+        y_min_ = in.read<T>();
+        bin_size_y_ = in.read<T>();
+    }
+
     /// Returns the number of bins in x-direction.
     std::size_t bins_x() const
     {
@@ -126,6 +140,18 @@ public:
             << bin_size_x_ << ' ' << bins_y_ << ' ' << y_min_ << ' ' << bin_size_y_;
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const
+    {
+        out.write(name_);
+        out.write_size(bins_x_);
+        out.write(x_min_);
+        out.write(bin_size_x_);
+        out.write_size(bins_y_);
+        out.write(y_min_);
+        out.write(bin_size_y_);
+    }
+
 private:
     std::size_t bins_x_;
     std::size_t bins_y_;
@@ -60,6 +60,19 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit distribution_result(binary_reader& in)
+        : parameters_{in}
+    {
+        std::size_t const size = parameters_.bins_x() * parameters_.bins_y();
+        results_.reserve(size);
+
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            results_.emplace_back(in);
+        }
+    }
+
     /// Returns the parameters associated with this distribution.
     distribution_parameters<T> const& parameters() const
     {
@@ -85,6 +98,17 @@ public:
         }
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const
+    {
+        parameters_.serialize(out);
+
+        for (auto const& result : results_)
+        {
+            result.serialize(out);
+        }
+    }
+
 private:
     distribution_parameters<T> parameters_;
     std::vector<mc_result<T>> results_;
@@ -0,0 +1,496 @@
+#ifndef HEP_MC_EVENT_WRITER_HPP
+#define HEP_MC_EVENT_WRITER_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/mc_point.hpp"
+#include "hep/mc/multi_channel_point.hpp"
+#include "hep/mc/uniform_random.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <istream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup events
+/// @{
+
+/// A single event read by \ref read_events.
+template <typename T>
+struct event
+{
+    /// The channel of the point, which is zero for integrators other than the multi channel ones.
+    std::uint64_t channel;
+
+    /// The weight of the event, i.e. the value of the integrand multiplied with the weight of the
+    /// point.
+    T weight;
+
+    /// The value of the integrand.
+    T value;
+
+    /// The coordinates of the point.
+    std::vector<T> coordinates;
+};
+
+/// \cond INTERNAL
+
+// Returns the eight bytes each event file starts with
+inline char const* event_file_magic()
+{
+    return "hepmcevt";
+}
+
+// Reads the header of an event file from `in` and returns the number of dimensions of its events.
+// Throws if it is not the header of an event file written for the numeric type `T`
+template <typename T>
+inline std::uint64_t read_event_header(std::istream& in, std::string const& filename)
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t size;
+    std::uint64_t dimensions;
+
+    in.read(magic, 8);
+    in.read(reinterpret_cast <char*> (&version), sizeof version);
+    in.read(reinterpret_cast <char*> (&size), sizeof size);
+    in.read(reinterpret_cast <char*> (&dimensions), sizeof dimensions);
+
+    if (!in || (std::memcmp(magic, event_file_magic(), 8) != 0) || (version != 1) ||
+        (size != sizeof (T)))
+    {
+        throw std::runtime_error("`" + filename + "` is not an event file of the requested type");
+    }
+
+    return dimensions;
+}
+
+/// \endcond
+
+/// Writes events into a binary file. If the file does not exist or is empty, the writer starts it
+/// with a header that records the size of `T` and the number of `dimensions` of the
+/// coordinates; otherwise the events are appended to the existing ones, and the constructor throws
+/// `std::runtime_error` if the header of the file differs. Each event is stored as
+/// its channel (a 64-bit unsigned integer), its weight, the value of the integrand, and the
+/// coordinates, using the native representation of the numbers. The events are collected in a
+/// buffer of `buffer_size` bytes which is written when it is full, when \ref flush is called,
+/// and when the writer is destroyed. All member functions can be called concurrently, so the same
+/// writer can be used by the threads of the parallel integrators; the order of the events then
+/// depends on the scheduling of the threads.
+template <typename T>
+class event_writer
+{
+public:
+    /// Constructor. Opens the file with the name `filename` for appending.
+    event_writer(
+        std::string const& filename,
+        std::size_t dimensions,
+        std::size_t buffer_size = std::size_t(1) << 20
+    )
+        : out_(filename, std::ios::binary | std::ios::app)
+        , filename_(filename)
+        , dimensions_(dimensions)
+        , buffer_size_(buffer_size)
+        , events_(0)
+    {
+        if (!out_)
+        {
+            throw std::runtime_error("could not open the event file `" + filename + "`");
+        }
+
+        buffer_.reserve(buffer_size_);
+
+        out_.seekp(0, std::ios::end);
+
+        if (out_.tellp() != std::streampos(0))
+        {
+            std::ifstream in(filename, std::ios::binary);
+
+            if (read_event_header<T>(in, filename) != dimensions)
+            {
+                throw std::runtime_error("the events in `" + filename + "` have a different "
+                    "number of dimensions");
+            }
+        }
+        else
+        {
+            std::uint32_t const version = 1;
+            std::uint32_t const size = sizeof (T);
+            std::uint64_t const dims = dimensions;
+
+            buffer_.insert(buffer_.end(), magic(), magic() + 8);
+            append(version);
+            append(size);
+            append(dims);
+        }
+    }
+
+    /// There is no copy constructor.
+    event_writer(event_writer<T> const&) = delete;
+
+    /// There is no assignment operator.
+    event_writer& operator=(event_writer<T> const&) = delete;
+
+    /// Destructor. Writes all buffered events. Since a destructor must not throw, a failed write is
+    /// only printed to `std::cerr`; call \ref flush before to handle the error.
+    ~event_writer()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // an earlier error was already reported by `add` or `flush`
+        if (!out_)
+        {
+            return;
+        }
+
+        try
+        {
+            write_file();
+        }
+        catch (std::exception const& exception)
+        {
+            std::cerr << exception.what() << '\n';
+        }
+    }
+
+    /// Adds an event with the given `channel`, `weight`, integrand `value` and `coordinates`,
+    /// whose size must be the number of dimensions given in the constructor. Throws
+    /// `std::runtime_error` if the buffer was full and writing it failed.
+    void add(std::size_t channel, T weight, T value, std::vector<T> const& coordinates)
+    {
+        assert( coordinates.size() == dimensions_ );
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        append(static_cast <std::uint64_t> (channel));
+        append(weight);
+        append(value);
+
+        for (std::size_t i = 0; i != dimensions_; ++i)
+        {
+            append(coordinates[i]);
+        }
+
+        ++events_;
+
+        if (buffer_.size() >= buffer_size_)
+        {
+            write_buffer();
+        }
+    }
+
+    /// Writes all buffered events to the file. Throws `std::runtime_error` if writing failed.
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_file();
+    }
+
+    /// Returns the number of events added to this writer.
+    std::size_t events() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    /// Returns the number of dimensions of the coordinates of each event.
+    std::size_t dimensions() const
+    {
+        return dimensions_;
+    }
+
+    /// Returns the eight bytes each event file starts with.
+    static char const* magic()
+    {
+        return event_file_magic();
+    }
+
+private:
+    template <typename U>
+    void append(U value)
+    {
+        char bytes[sizeof (U)];
+        std::memcpy(bytes, &value, sizeof (U));
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof (U));
+    }
+
+    void write_buffer()
+    {
+        out_.write(buffer_.data(), static_cast <std::streamsize> (buffer_.size()));
+        buffer_.clear();
+
+        if (!out_)
+        {
+            throw std::runtime_error("could not write the event file `" + filename_ + "`");
+        }
+    }
+
+    // Writes the buffer and the data buffered by the stream into the file
+    void write_file()
+    {
+        write_buffer();
+        out_.flush();
+
+        if (!out_)
+        {
+            throw std::runtime_error("could not write the event file `" + filename_ + "`");
+        }
+    }
+
+    std::ofstream out_;
+    std::string filename_;
+    std::size_t dimensions_;
+    std::size_t buffer_size_;
+    std::size_t events_;
+    std::vector<char> buffer_;
+    mutable std::mutex mutex_;
+};
+
+/// Reads all events from the file `filename` written by \ref event_writer.
+template <typename T>
+inline std::vector<event<T>> read_events(std::string const& filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    std::uint64_t const dimensions = read_event_header<T>(in, filename);
+
+    std::vector<event<T>> events;
+
+    for (;;)
+    {
+        event<T> e;
+        e.coordinates.resize(dimensions);
+
+        in.read(reinterpret_cast <char*> (&e.channel), sizeof e.channel);
+        in.read(reinterpret_cast <char*> (&e.weight), sizeof e.weight);
+        in.read(reinterpret_cast <char*> (&e.value), sizeof e.value);
+        in.read(reinterpret_cast <char*> (e.coordinates.data()),
+            static_cast <std::streamsize> (dimensions * sizeof (T)));
+
+        if (!in)
+        {
+            break;
+        }
+
+        events.push_back(std::move(e));
+    }
+
+    return events;
+}
+
+/// Hit-or-miss unweighting of events, which are then passed to `Sink`, e.g. an \ref
+/// event_writer. An event with the weight \f$ w \f$ is accepted with the probability
+/// \f$ |w| / w_\text{max} \f$, where \f$ w_\text{max} \f$ is the running maximum of the
+/// absolute values of all weights seen so far, including \f$ w \f$; accepted events are passed
+/// on with the weight \f$ \mathrm{sgn}(w) w_\text{max} \f$. Since the maximum is only known
+/// approximately at the beginning, the first events are slightly overrepresented; this can be
+/// avoided by passing the maximum weight of a previous run to the constructor. The random numbers
+/// are drawn from a separate generator of the type `R` and do not influence the integration.
+template <typename T, typename Sink, typename R = std::mt19937>
+class event_unweighter
+{
+public:
+    /// Constructor.
+    explicit event_unweighter(Sink& sink, T max_weight = T(), R const& generator = R())
+        : sink_(sink)
+        , generator_(generator)
+        , max_weight_(max_weight)
+        , trials_(0)
+        , accepted_(0)
+    {
+    }
+
+    /// Performs the unweighting of one event. Events whose weight is zero are always rejected.
+    void add(std::size_t channel, T weight, T value, std::vector<T> const& coordinates)
+    {
+        using std::fabs;
+
+        T const abs_weight = fabs(weight);
+        T unweighted;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            ++trials_;
+
+            if (abs_weight > max_weight_)
+            {
+                max_weight_ = abs_weight;
+            }
+
+            if (!(abs_weight > generate_uniform<T>(generator_) * max_weight_))
+            {
+                return;
+            }
+
+            ++accepted_;
+            unweighted = (weight < T()) ? -max_weight_ : max_weight_;
+        }
+
+        sink_.add(channel, unweighted, value, coordinates);
+    }
+
+    /// Returns the current maximum weight.
+    T max_weight() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return max_weight_;
+    }
+
+    /// Returns the number of events that were passed to this object.
+    std::size_t trials() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return trials_;
+    }
+
+    /// Returns the number of events that were accepted.
+    std::size_t accepted() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return accepted_;
+    }
+
+private:
+    Sink& sink_;
+    R generator_;
+    T max_weight_;
+    std::size_t trials_;
+    std::size_t accepted_;
+    mutable std::mutex mutex_;
+};
+
+/// \cond INTERNAL
+
+template <typename T>
+inline std::size_t event_channel(mc_point<T> const&)
+{
+    return 0;
+}
+
+template <typename T>
+inline std::size_t event_channel(multi_channel_point<T> const& point)
+{
+    return point.channel();
+}
+
+template <typename T>
+inline std::vector<T> const& event_coordinates(mc_point<T> const& point)
+{
+    return point.point();
+}
+
+template <typename T>
+inline std::vector<T> const& event_coordinates(multi_channel_point<T> const& point)
+{
+    return point.coordinates();
+}
+
+/// \endcond
+
+/// Function object that calls `function` and passes every point for which it returns a
+/// non-zero and finite value to the `sink`, which must be an \ref event_writer, an \ref
+/// event_unweighter, or a class with the same member function `add`. The coordinates of each
+/// event are the ones of the point, or for multi channel integrators the `coordinates` of the
+/// map. See \ref make_event_function.
+template <typename F, typename Sink>
+class event_function
+{
+public:
+    /// Constructor.
+    event_function(F const& function, Sink& sink)
+        : function_(function)
+        , sink_(&sink)
+    {
+    }
+
+    /// Calls the function for integrands without distributions.
+    template <typename P>
+    auto operator()(P const& point) -> decltype (std::declval<F&>()(point))
+    {
+        auto const value = function_(point);
+        add(point, value);
+        return value;
+    }
+
+    /// Calls the function for integrands with distributions.
+    template <typename P, typename Projector>
+    auto operator()(P const& point, Projector& projector)
+        -> decltype (std::declval<F&>()(point, projector))
+    {
+        auto const value = function_(point, projector);
+        add(point, value);
+        return value;
+    }
+
+private:
+    template <typename P, typename T>
+    void add(P const& point, T value)
+    {
+        using std::isfinite;
+
+        if (value == T())
+        {
+            return;
+        }
+
+        T const weight = value * point.weight();
+
+        if (isfinite(weight))
+        {
+            sink_->add(event_channel(point), weight, value, event_coordinates(point));
+        }
+    }
+
+    F function_;
+    Sink* sink_;
+};
+
+/// Returns an \ref event_function that calls `function` and writes the events into `sink`. The
+/// result can be used in place of `function` with \ref make_integrand and \ref
+/// make_multi_channel_integrand, but not for batch integrands. The `sink` must outlive the
+/// integration.
+template <typename F, typename Sink>
+inline event_function<typename std::decay<F>::type, Sink> make_event_function(
+    F&& function,
+    Sink& sink
+) {
+    return event_function<typename std::decay<F>::type, Sink>(std::forward<F>(function), sink);
+}
+
+/// @}
+
+}
+
+#endif
@@ -47,6 +47,9 @@ public:
     /// Signals whether this integrand wants to generate distributions or not.
     static constexpr bool has_distributions = distributions;
 
+    /// Signals whether this integrand evaluates many points at once, see \ref make_batch_integrand.
+    static constexpr bool is_batch = false;
+
     /// Constructor. Instead of using the constructor directly you should consider using one of the
     /// helper functions \ref make_integrand.
     template <typename G>
@@ -147,6 +150,14 @@ inline integrand_type<T, F, true> make_integrand(
 template <typename I>
 using numeric_type_of = typename std::remove_reference<I>::type::numeric_type;
 
+/// \cond INTERNAL
+
+// Tag used by the integrators to select the evaluation of single points or of batches of points.
+template <typename I>
+using batch_tag_of = std::integral_constant<bool, std::remove_reference<I>::type::is_batch>;
+
+/// \endcond
+
 /// @}
 
 }
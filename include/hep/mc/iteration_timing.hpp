@@ -0,0 +1,254 @@
+#ifndef HEP_MC_ITERATION_TIMING_HPP
+#define HEP_MC_ITERATION_TIMING_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/binary_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// Time spent in a single iteration of an integrator, which is stored in the checkpoints next to
+/// its result, see \ref chkpt::timings. All times are wall-clock times in seconds. Checkpoints
+/// that were written before the timing was recorded contain iterations whose times are all zero.
+class iteration_timing
+{
+public:
+    /// Constructor. Creates an object whose times are all zero, which means that the timing of the
+    /// iteration is unknown.
+    iteration_timing()
+        : wall_time_()
+        , integrand_time_()
+        , reduction_time_()
+        , processes_()
+        , slowest_integrand_time_()
+        , total_integrand_time_()
+        , slowest_process_()
+    {
+    }
+
+    /// Constructor. The arguments are the values returned by the member functions with the same
+    /// names.
+    iteration_timing(
+        double wall_time,
+        double integrand_time,
+        double reduction_time = 0.0,
+        std::size_t processes = 0,
+        double slowest_integrand_time = 0.0,
+        double total_integrand_time = 0.0,
+        std::size_t slowest_process = 0
+    )
+        : wall_time_(wall_time)
+        , integrand_time_(integrand_time)
+        , reduction_time_(reduction_time)
+        , processes_(processes)
+        , slowest_integrand_time_(slowest_integrand_time)
+        , total_integrand_time_(total_integrand_time)
+        , slowest_process_(slowest_process)
+    {
+    }
+
+    /// Deserialization constructor.
+    explicit iteration_timing(std::istream& in)
+        : iteration_timing()
+    {
+        in >> wall_time_ >> integrand_time_ >> reduction_time_ >> processes_;
+
+        if (processes_ != 0)
+        {
+            in >> slowest_integrand_time_ >> total_integrand_time_ >> slowest_process_;
+        }
+    }
+
+    /// Deserialization constructor for the binary format.
+    explicit iteration_timing(binary_reader& in)
+        : wall_time_(in.read<double>())
+        , integrand_time_(in.read<double>())
+        , reduction_time_(in.read<double>())
+        , processes_(in.read_size())
+        , slowest_integrand_time_((processes_ == 0) ? 0.0 : in.read<double>())
+        , total_integrand_time_((processes_ == 0) ? 0.0 : in.read<double>())
+        , slowest_process_((processes_ == 0) ? 0 : in.read_size())
+    {
+    }
+
+    /// Returns the time of the entire iteration. It is measured from the end of the previous
+    /// iteration, i.e. after its callback returned, or from the start of the integrator, until
+    /// the result is added to the checkpoint. This includes refining the grid or the channel
+    /// weights with the results of the previous iteration and, for the MPI integrators, summing
+    /// the results over all processes.
+    double wall_time() const
+    {
+        return wall_time_;
+    }
+
+    /// Returns the time this process spent in sampling the integrand. Since the integrand is
+    /// evaluated, random numbers are generated, and distributions are filled for each point in
+    /// turn, this time includes all three; measuring them separately would require reading the
+    /// clock for every call.
+    double integrand_time() const
+    {
+        return integrand_time_;
+    }
+
+    /// Returns the time the MPI integrators spent in summing the results over all processes,
+    /// which includes waiting for the slowest process. This is zero for all other integrators.
+    double reduction_time() const
+    {
+        return reduction_time_;
+    }
+
+    /// Returns the time spent in the iteration that is neither \ref integrand_time nor \ref
+    /// reduction_time, e.g. for refining the grid.
+    double overhead_time() const
+    {
+        return std::max(0.0, wall_time_ - integrand_time_ - reduction_time_);
+    }
+
+    /// Returns the number of calls per second for an iteration with `calls` calls, or zero if the
+    /// timing is unknown.
+    double calls_per_second(std::size_t calls) const
+    {
+        return (wall_time_ > 0.0) ? (double(calls) / wall_time_) : 0.0;
+    }
+
+    /// Returns the number of processes of the MPI integrators, and zero for all other integrators.
+    /// Instead of the \ref integrand_time of every process, which would make the data summed over
+    /// all processes grow with their number, only the following summaries are recorded.
+    std::size_t processes() const
+    {
+        return processes_;
+    }
+
+    /// Returns the largest \ref integrand_time of all processes.
+    double slowest_integrand_time() const
+    {
+        return slowest_integrand_time_;
+    }
+
+    /// Returns the sum of the \ref integrand_time of all processes.
+    double total_integrand_time() const
+    {
+        return total_integrand_time_;
+    }
+
+    /// Returns the rank of the process with the \ref slowest_integrand_time. If several processes
+    /// were equally slow, the smallest rank is returned.
+    std::size_t slowest_process() const
+    {
+        return slowest_process_;
+    }
+
+    /// Returns the ratio of the largest to the average \ref integrand_time of all processes. A
+    /// value close to one means the processes are equally fast; larger values are caused by
+    /// slower processes, which the others have to wait for unless \ref mpi_schedule::dynamic is
+    /// used. Returns one if there are no \ref processes.
+    double imbalance() const
+    {
+        if (total_integrand_time_ <= 0.0)
+        {
+            return 1.0;
+        }
+
+        return slowest_integrand_time_ * double(processes_) / total_integrand_time_;
+    }
+
+    /// Serializes this object.
+    void serialize(std::ostream& out) const
+    {
+        out << std::scientific << std::setprecision(std::numeric_limits<double>::max_digits10 - 1)
+            << wall_time_ << ' ' << integrand_time_ << ' ' << reduction_time_ << ' '
+            << processes_;
+
+        if (processes_ != 0)
+        {
+            out << ' ' << slowest_integrand_time_ << ' ' << total_integrand_time_ << ' '
+                << slowest_process_;
+        }
+    }
+
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const
+    {
+        out.write(wall_time_);
+        out.write(integrand_time_);
+        out.write(reduction_time_);
+        out.write_size(processes_);
+
+        if (processes_ != 0)
+        {
+            out.write(slowest_integrand_time_);
+            out.write(total_integrand_time_);
+            out.write_size(slowest_process_);
+        }
+    }
+
+private:
+    double wall_time_;
+    double integrand_time_;
+    double reduction_time_;
+    std::size_t processes_;
+    double slowest_integrand_time_;
+    double total_integrand_time_;
+    std::size_t slowest_process_;
+};
+
+/// \cond INTERNAL
+
+// Measures the wall-clock time since its construction or the last call of `restart`
+class stopwatch
+{
+public:
+    stopwatch()
+        : start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    void restart()
+    {
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// \endcond
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef HEP_MC_MAPPED_FILE_HPP
+#define HEP_MC_MAPPED_FILE_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// Read-only view of the contents of a file. On POSIX systems the file is mapped into memory, so
+/// that only the pages that are accessed are read from disk; on other systems the file is read
+/// into a buffer. Throws `std::runtime_error` if the file can not be opened.
+class mapped_file
+{
+public:
+    /// Constructor. Opens the file `filename`.
+    explicit mapped_file(std::string const& filename)
+        : data_(nullptr)
+        , size_(0)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        int const descriptor = ::open(filename.c_str(), O_RDONLY);
+
+        if (descriptor == -1)
+        {
+            throw std::runtime_error("could not open `" + filename + "`");
+        }
+
+        struct stat status;
+
+        if (::fstat(descriptor, &status) == -1)
+        {
+            ::close(descriptor);
+
+            throw std::runtime_error("could not determine the size of `" + filename + "`");
+        }
+
+        size_ = static_cast <std::size_t> (status.st_size);
+
+        // empty files can not be mapped
+        if (size_ != 0)
+        {
+            void* const address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+            if (address == MAP_FAILED)
+            {
+                ::close(descriptor);
+
+                throw std::runtime_error("could not map `" + filename + "` into memory");
+            }
+
+            data_ = static_cast <char const*> (address);
+        }
+
+        // the mapping stays valid after closing the file
+        ::close(descriptor);
+#else
+        std::ifstream in(filename, std::ios::binary);
+
+        if (!in)
+        {
+            throw std::runtime_error("could not open `" + filename + "`");
+        }
+
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    mapped_file(mapped_file const&) = delete;
+
+    mapped_file& operator=(mapped_file const&) = delete;
+
+    /// Destructor. Unmaps the file.
+    ~mapped_file()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast <char*> (data_), size_);
+        }
+#endif
+    }
+
+    /// Returns a pointer to the contents of the file.
+    char const* data() const
+    {
+        return data_;
+    }
+
+    /// Returns the size of the file in bytes.
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    char const* data_;
+    std::size_t size_;
+#if !defined(__unix__) && !defined(__APPLE__)
+    std::vector<char> buffer_;
+#endif
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef HEP_MC_MC_BATCH_HPP
+#define HEP_MC_MC_BATCH_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup integrands
+/// @{
+
+/// A block of random points \f$ \vec{x}_i \in [0,1]^d \f$ in the \f$ d \f$-dimensional hypercube
+/// with associated weights, which is passed to integrands created with \ref make_batch_integrand.
+/// The coordinates are stored as a structure of arrays: for each dimension the coordinates of all
+/// points are stored contiguously, which allows integrands to evaluate many points at once using
+/// SIMD instructions.
+template <typename T>
+class mc_batch
+{
+public:
+    /// Constructor. The vector `points` must contain the coordinates of dimension `d` of the point
+    /// `i` at index `d * weights.size() + i`. The first `size` points are the ones of this batch.
+    mc_batch(std::vector<T> const& points, std::vector<T> const& weights, std::size_t size)
+        : points_(points)
+        , weights_(weights)
+        , size_(size)
+    {
+    }
+
+    /// There is no copy constructor.
+    mc_batch(mc_batch<T> const&) = delete;
+
+    /// There is no move constructor.
+    mc_batch(mc_batch<T>&&) = delete;
+
+    /// There is no copy assignment operator.
+    mc_batch& operator=(mc_batch<T> const&) = delete;
+
+    /// There is no move assignment operator.
+    mc_batch& operator=(mc_batch<T>&&) = delete;
+
+    /// Destructor.
+    virtual ~mc_batch() = default;
+
+    /// The number of points in this batch.
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// The largest number of points a batch can have. This is the distance between the
+    /// coordinates of two subsequent dimensions.
+    std::size_t capacity() const
+    {
+        return weights_.size();
+    }
+
+    /// The dimension \f$ d \f$ of the points.
+    std::size_t dimensions() const
+    {
+        return points_.size() / weights_.size();
+    }
+
+    /// Returns a pointer to the coordinates in `dimension` of all \ref size points.
+    T const* point(std::size_t dimension) const
+    {
+        return points_.data() + dimension * weights_.size();
+    }
+
+    /// Returns a pointer to the weights of all \ref size points. See \ref mc_point::weight for the
+    /// meaning of the weights. The integrators multiply the values of the integrand with these
+    /// weights.
+    T const* weights() const
+    {
+        return weights_.data();
+    }
+
+private:
+    std::vector<T> const& points_;
+    std::vector<T> const& weights_;
+    std::size_t size_;
+};
+
+/// @}
+
+}
+
+#endif
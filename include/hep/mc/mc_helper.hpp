@@ -22,6 +22,7 @@
 #include "hep/mc/distribution_result.hpp"
 #include "hep/mc/mc_result.hpp"
 #include "hep/mc/plain_result.hpp"
+#include "hep/mc/running_distributions.hpp"
 
 #include <cmath>
 #include <cstddef>
@@ -54,9 +55,33 @@ using hep_mc_result_if = typename std::enable_if<!std::is_convertible<
     typename std::iterator_traits<Iterator>::value_type,
     hep_plain_result<Iterator>>::value, hep_mc_result<Iterator>>::type;
 
+template <typename IteratorOverMcResults>
+struct weighted_with_variance;
+
+// Streams the results into running sums for each bin, which avoids copying the bins
 template <template <typename> class Accumulator, typename Iterator>
-inline hep_plain_result<Iterator> hep_distribution_accumulator(Iterator begin, Iterator end)
-{
+inline hep_plain_result<Iterator> hep_distribution_accumulator(
+    Iterator begin,
+    Iterator end,
+    std::true_type
+) {
+    hep::running_distributions<hep_numeric_type<Iterator>> distributions;
+
+    for (auto i = begin; i != end; ++i)
+    {
+        distributions.add(*i);
+    }
+
+    return distributions.result();
+}
+
+// Collects the results of each bin and accumulates them with `Accumulator`
+template <template <typename> class Accumulator, typename Iterator>
+inline hep_plain_result<Iterator> hep_distribution_accumulator(
+    Iterator begin,
+    Iterator end,
+    std::false_type
+) {
     using T = hep_numeric_type<Iterator>;
 
     std::size_t n = std::distance(begin, end);
@@ -67,6 +92,10 @@ inline hep_plain_result<Iterator> hep_distribution_accumulator(Iterator begin, I
         std::size_t const distribution_count = begin->distributions().size();
         distributions.reserve(distribution_count);
 
+        // the same buffer is used for every bin
+        std::vector<hep::mc_result<T>> bin_results;
+        bin_results.reserve(n);
+
         for (std::size_t j = 0; j != distribution_count; ++j)
         {
             std::size_t const bin_count = begin->distributions().at(j).results().size();
@@ -75,8 +104,7 @@ inline hep_plain_result<Iterator> hep_distribution_accumulator(Iterator begin, I
 
             for (std::size_t k = 0; k != bin_count; ++k)
             {
-                std::vector<hep::mc_result<T>> bin_results;
-                bin_results.reserve(n);
+                bin_results.clear();
 
                 for (auto i = begin; i != end; ++i)
                 {
@@ -107,6 +135,13 @@ inline hep_plain_result<Iterator> hep_distribution_accumulator(Iterator begin, I
     };
 }
 
+template <template <typename> class Accumulator, typename Iterator>
+inline hep_plain_result<Iterator> hep_distribution_accumulator(Iterator begin, Iterator end)
+{
+    return hep_distribution_accumulator<Accumulator>(begin, end, std::integral_constant<bool,
+        std::is_same<Accumulator<Iterator>, weighted_with_variance<Iterator>>::value>());
+}
+
 /// \endcond
 
 /// \addtogroup results
@@ -241,7 +276,9 @@ inline hep_mc_result_if<IteratorOverMcResults> accumulate(
 /// Accumulates the results in the interval [`begin`, `end`) using an instance of the type
 /// `Accumulator`. This function is called if the interval points to results of the type \ref
 /// plain_result and therefore also accumulates all distributions. `Accumulator` can be \ref
-/// weighted_with_variance, \ref weighted_equally, or a similar type.
+/// weighted_with_variance, \ref weighted_equally, or a similar type. With \ref
+/// weighted_with_variance the results are added to \ref running_distributions, which does not copy
+/// the bins; use this class directly to combine results as they become available.
 template <template <typename> class Accumulator, typename IteratorOverPlainResults>
 inline hep_plain_result_if<IteratorOverPlainResults> accumulate(
     IteratorOverPlainResults begin,
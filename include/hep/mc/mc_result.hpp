@@ -19,6 +19,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/binary_stream.hpp"
+
 #include <cmath>
 #include <cstddef>
 #include <iomanip>
@@ -72,6 +74,16 @@ public:
         in >> calls_ >> non_zero_calls_ >> finite_calls_ >> sum_ >> sum_of_squares_;
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit mc_result(binary_reader& in)
+        : calls_(in.read_size())
+        , non_zero_calls_(in.read_size())
+        , finite_calls_(in.read_size())
+        , sum_(in.read<T>())
+        , sum_of_squares_(in.read<T>())
+    {
+    }
+
     /// Copy constructor.
     mc_result(mc_result<T> const&) = default;
 
@@ -100,8 +112,9 @@ public:
         return sum_ / T(calls_);
     }
 
-    /// Variance \f$ S^2 \f$ of the expectation value.
-    T variance() const
+    /// Variance \f$ S^2 \f$ of the expectation value. Results of integrators that do not sample
+    /// independent points, e.g. \ref vegas_stratified_result, override this function.
+    virtual T variance() const
     {
         return (sum_of_squares_ - sum_ * sum_ / T(calls_)) / T(calls_) / T(calls_ - 1);
     }
@@ -147,6 +160,16 @@ public:
             << sum_of_squares_;
     }
 
+    /// Serializes this object using the binary format.
+    virtual void serialize(binary_writer& out) const
+    {
+        out.write_size(calls_);
+        out.write_size(non_zero_calls_);
+        out.write_size(finite_calls_);
+        out.write(sum_);
+        out.write(sum_of_squares_);
+    }
+
     static char const* result_name()
     {
         return "mc_result";
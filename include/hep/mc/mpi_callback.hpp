@@ -39,13 +39,15 @@ public:
     /// Numeric type used by the checkpoint.
     using numeric_type = typename Checkpoint::result_type::numeric_type;
 
-    /// Constructor.
+    /// Constructor. The parameters are the same as for \ref callback::callback.
     mpi_callback(
         callback_mode mode = callback_mode::verbose,
         std::string const& filename = "",
-        numeric_type target_rel_err = numeric_type()
+        numeric_type target_rel_err = numeric_type(),
+        chkpt_format format = chkpt_format::text,
+        bool asynchronous = false
     )
-        : callback_{mode, filename, target_rel_err}
+        : callback_{mode, filename, target_rel_err, format, asynchronous}
     {
     }
 
@@ -67,6 +69,12 @@ public:
         return callback_(chkpt);
     }
 
+    /// Waits until all checkpoints written asynchronously by this callback are on disk.
+    void flush()
+    {
+        callback_.flush();
+    }
+
 private:
     callback<Checkpoint> callback_;
 };
@@ -23,7 +23,10 @@
 #include "hep/mc/mc_result.hpp"
 #include "hep/mc/plain_result.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 #include <mpi.h>
@@ -72,92 +75,421 @@ inline MPI_Datatype mpi_datatype<long double>()
     return MPI_LONG_DOUBLE;
 }
 
+// Throws `std::runtime_error` if the integrators evaluate the calls of each process with more than
+// one of the `threads` but MPI was initialized with a thread level lower than
+// `MPI_THREAD_FUNNELED`, in which case the threads would not be allowed to exist next to MPI
+inline void mpi_check_thread_level(std::size_t threads)
+{
+    if (threads == 1)
+    {
+        return;
+    }
+
+    int provided = 0;
+    MPI_Query_thread(&provided);
+
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+        throw std::runtime_error("MPI must be initialized with at least MPI_THREAD_FUNNELED to use "
+            "more than one thread per process");
+    }
+}
+
+// Size of the header of the buffers reduced by `mpi_result_sum`
+constexpr std::size_t mpi_result_header = 4 * sizeof (std::uint64_t);
+
+// Returns the offset of the counters in a buffer of `mpi_result_sum` with `values` numbers
 template <typename T>
-hep::plain_result<T> allreduce_result(
-    MPI_Comm communicator,
-    hep::plain_result<T> const& result,
-    std::vector<T>& buffer,
-    std::vector<T> const& in_buffer,
-    std::size_t total_calls
-) {
-    // pack everything into `buffer` ...
-    buffer = in_buffer;
-    buffer.push_back(result.sum());
-    buffer.push_back(result.sum_of_squares());
+inline std::size_t mpi_result_counter_offset(std::size_t values)
+{
+    std::size_t const end = mpi_result_header + values * sizeof (T);
+    std::size_t const alignment = sizeof (std::uint64_t);
+
+    return (end + alignment - 1) / alignment * alignment;
+}
+
+// Returns the offset of the timings in a buffer of `mpi_result_sum` with `values` numbers and
+// `counters` counters
+template <typename T>
+inline std::size_t mpi_result_timing_offset(std::size_t values, std::size_t counters)
+{
+    return mpi_result_counter_offset<T>(values) + counters * sizeof (std::uint64_t);
+}
+
+// Number of `double`s at the end of the buffers of `mpi_result_sum`, which are the integrand time
+// of the slowest process, the sum of the integrand times of all processes, and the rank of the
+// slowest process
+constexpr std::size_t mpi_result_timings = 3;
+
+// User-defined reduction that sums the buffers of `mpi_result_reduction`. Each buffer starts
+// with a header containing the number of floating-point values, the number of counters, and the
+// extent of the datatype; the header itself is identical on all processes and therefore not summed.
+// Of the timings only the total is summed, while the slowest time is the maximum, which on ties is
+// attributed to the smaller rank so that the operation stays commutative
+template <typename T>
+inline void mpi_result_sum(void* in, void* inout, int* length, MPI_Datatype*)
+{
+    char const* source = static_cast <char const*> (in);
+    char* target = static_cast <char*> (inout);
+
+    for (int element = 0; element != *length; ++element)
+    {
+        std::uint64_t const* header = reinterpret_cast <std::uint64_t const*> (target);
+        std::size_t const values = static_cast <std::size_t> (header[0]);
+        std::size_t const counters = static_cast <std::size_t> (header[1]);
+        std::size_t const extent = static_cast <std::size_t> (header[2]);
+        std::size_t const offset = mpi_result_counter_offset<T>(values);
+
+        T const* source_values = reinterpret_cast <T const*> (source + mpi_result_header);
+        T* target_values = reinterpret_cast <T*> (target + mpi_result_header);
+
+        for (std::size_t i = 0; i != values; ++i)
+        {
+            target_values[i] += source_values[i];
+        }
+
+        std::uint64_t const* source_counters = reinterpret_cast <std::uint64_t const*> (source +
+            offset);
+        std::uint64_t* target_counters = reinterpret_cast <std::uint64_t*> (target + offset);
+
+        for (std::size_t i = 0; i != counters; ++i)
+        {
+            target_counters[i] += source_counters[i];
+        }
+
+        std::size_t const timing_offset = mpi_result_timing_offset<T>(values, counters);
+        double const* source_timings = reinterpret_cast <double const*> (source + timing_offset);
+        double* target_timings = reinterpret_cast <double*> (target + timing_offset);
+
+        if ((source_timings[0] > target_timings[0]) || ((source_timings[0] == target_timings[0])
+            && (source_timings[2] < target_timings[2])))
+        {
+            target_timings[0] = source_timings[0];
+            target_timings[2] = source_timings[2];
+        }
+
+        target_timings[1] += source_timings[1];
+
+        source += extent;
+        target += extent;
+    }
+}
 
-    std::vector<std::size_t> size_t_buffer;
-    size_t_buffer.push_back(result.non_zero_calls());
-    size_t_buffer.push_back(result.finite_calls());
+// Returns the number of counters, which is the same as the number of sums and sums of squares,
+// needed to pack `result` with `mpi_pack_result`
+template <typename T>
+inline std::size_t mpi_result_counters(plain_result<T> const& result)
+{
+    std::size_t bins = 0;
+
+    for (auto const& distribution : result.distributions())
+    {
+        bins += distribution.results().size();
+    }
+
+    return 2 * (bins + 1);
+}
+
+// Writes `additional_data` and the sums of `result` into `values`, and the counters of `result`
+// into `counters`
+template <typename T>
+inline void mpi_pack_result(
+    plain_result<T> const& result,
+    std::vector<T> const& additional_data,
+    T* values,
+    std::uint64_t* counters
+) {
+    values = std::copy(additional_data.begin(), additional_data.end(), values);
+    *values++ = result.sum();
+    *values++ = result.sum_of_squares();
+    *counters++ = result.non_zero_calls();
+    *counters++ = result.finite_calls();
 
     for (auto const& distribution : result.distributions())
     {
         for (auto const& bin : distribution.results())
         {
-            buffer.push_back(bin.sum());
-            buffer.push_back(bin.sum_of_squares());
-            size_t_buffer.push_back(bin.non_zero_calls());
-            size_t_buffer.push_back(bin.finite_calls());
+            *values++ = bin.sum();
+            *values++ = bin.sum_of_squares();
+            *counters++ = bin.non_zero_calls();
+            *counters++ = bin.finite_calls();
         }
     }
+}
 
-    // ... merge `buffer` of all processes into `buffer` again ...
-    MPI_Allreduce(
-        MPI_IN_PLACE,
-        &buffer[0],
-        buffer.size(),
-        mpi_datatype<T>(),
-        MPI_SUM,
-        communicator
-    );
-
-    MPI_Allreduce(
-        MPI_IN_PLACE,
-        &size_t_buffer[0],
-        size_t_buffer.size(),
-        mpi_datatype<std::size_t>(),
-        MPI_SUM,
-        communicator
-    );
+// Inverse of `mpi_pack_result`, where `values` points behind the additional data. The
+// distributions of the returned result have the same parameters as the ones of `result`, and
+// `total_calls` is the number of calls of the returned result
+template <typename T>
+inline plain_result<T> mpi_unpack_result(
+    plain_result<T> const& result,
+    std::size_t total_calls,
+    T const* values,
+    std::uint64_t const* counters
+) {
+    T const sum = *values++;
+    T const sum_of_squares = *values++;
+    std::size_t const non_zero_calls = static_cast <std::size_t> (*counters++);
+    std::size_t const finite_calls = static_cast <std::size_t> (*counters++);
 
-    // ... and extract the results
-    std::size_t index = in_buffer.size();
-    T sum = buffer[index++];
-    T sum_of_squares = buffer[index++];
+    std::vector<distribution_result<T>> distributions;
+    distributions.reserve(result.distributions().size());
 
-    std::vector<hep::distribution_result<T>> distributions;
     for (auto const& distribution : result.distributions())
     {
-        std::vector<hep::mc_result<T>> bins;
+        std::vector<mc_result<T>> bins;
         bins.reserve(distribution.results().size());
 
         for (std::size_t i = 0; i != distribution.results().size(); ++i)
         {
             bins.emplace_back(
                 total_calls,
-                size_t_buffer[index     - in_buffer.size()],
-                size_t_buffer[index + 1 - in_buffer.size()],
-                buffer[index],
-                buffer[index + 1]
+                static_cast <std::size_t> (counters[0]),
+                static_cast <std::size_t> (counters[1]),
+                values[0],
+                values[1]
             );
-            index += 2;
+
+            values += 2;
+            counters += 2;
         }
 
         distributions.emplace_back(distribution.parameters(), bins);
     }
 
-    // resize `buffer` - contains the merged `additional_data`
-    buffer.resize(in_buffer.size());
-
-    return hep::plain_result<T>(
+    return plain_result<T>(
         distributions,
         total_calls,
-        size_t_buffer[0],
-        size_t_buffer[1],
+        non_zero_calls,
+        finite_calls,
         sum,
         sum_of_squares
     );
 }
 
+// Sums the results of an iteration over all processes of a communicator with a single collective
+// operation. The floating-point numbers and the counters of a result are packed into one buffer,
+// which is described by a derived datatype and reduced with `mpi_result_sum`. Each process also
+// writes the time it spent in sampling, which is reduced to the time and rank of the slowest
+// process and the total time of all processes, so that the size of the buffer does not grow with
+// the number of processes. The buffer, the datatype, and the operation are reused for all
+// iterations with the same layout.
+//
+// The reduction is blocking, since every integrator needs the sum before it can continue: the
+// callback decides whether the next iteration is performed, and VEGAS and the multi-channel
+// integrator adapt themselves to the sum. A user-defined operation on a derived datatype is
+// reduced by MPI with its generic algorithm, which does not split the buffer into segments like
+// the bandwidth-optimal algorithms for `MPI_SUM` on a contiguous array of a predefined type. Two
+// reductions with `MPI_SUM`, one for the floating-point numbers and one for the counters, would
+// allow that, but need twice as many latency-bound collectives, which dominate unless the results
+// have many bins
+template <typename T>
+class mpi_result_reduction
+{
+public:
+    explicit mpi_result_reduction(MPI_Comm communicator)
+        : communicator_(communicator)
+        , rank_(0)
+        , processes_(0)
+        , datatype_(MPI_DATATYPE_NULL)
+        , operation_(MPI_OP_NULL)
+        , values_(0)
+        , counters_(0)
+        , additional_(0)
+        , buffer_(nullptr)
+        , slowest_integrand_time_()
+        , total_integrand_time_()
+        , slowest_process_()
+    {
+        int rank = 0;
+        MPI_Comm_rank(communicator, &rank);
+        int world = 0;
+        MPI_Comm_size(communicator, &world);
+
+        rank_ = static_cast <std::size_t> (rank);
+        processes_ = static_cast <std::size_t> (world);
+    }
+
+    mpi_result_reduction(mpi_result_reduction const&) = delete;
+
+    mpi_result_reduction& operator=(mpi_result_reduction const&) = delete;
+
+    ~mpi_result_reduction()
+    {
+        if (datatype_ != MPI_DATATYPE_NULL)
+        {
+            MPI_Type_free(&datatype_);
+        }
+
+        if (operation_ != MPI_OP_NULL)
+        {
+            MPI_Op_free(&operation_);
+        }
+    }
+
+    // Packs `result` together with `additional_data`, e.g. the adjustment data of VEGAS, and the
+    // `integrand_time` this process needed for `result`, sums them over all processes and returns
+    // the sum of the results, which together performed `total_calls` calls. The sum of the
+    // additional data and the summary of the times of all processes are returned by
+    // `additional_data`, `slowest_integrand_time`, `total_integrand_time`, and `slowest_process`
+    // afterwards
+    plain_result<T> reduce(
+        plain_result<T> const& result,
+        std::vector<T> const& additional_data,
+        double integrand_time,
+        std::size_t total_calls
+    ) {
+        additional_ = additional_data.size();
+
+        std::size_t const counters = mpi_result_counters(result);
+
+        layout(additional_ + counters, counters);
+
+        mpi_pack_result(result, additional_data, reinterpret_cast <T*> (
+            &buffer_[mpi_result_header]), reinterpret_cast <std::uint64_t*> (
+            &buffer_[mpi_result_counter_offset<T>(values_)]));
+
+        double* timings = reinterpret_cast <double*> (
+            &buffer_[mpi_result_timing_offset<T>(values_, counters_)]);
+        timings[0] = integrand_time;
+        timings[1] = integrand_time;
+        timings[2] = static_cast <double> (rank_);
+
+        MPI_Allreduce(MPI_IN_PLACE, &buffer_[0], 1, datatype_, operation_, communicator_);
+
+        return unpack(result, total_calls);
+    }
+
+    // Returns the sum of the additional data after `reduce` has been called
+    std::vector<T> const& additional_data() const
+    {
+        return additional_data_;
+    }
+
+    // Returns the number of processes taking part in the reduction
+    std::size_t processes() const
+    {
+        return processes_;
+    }
+
+    // Returns the longest time a process spent in sampling after `reduce` has been called
+    double slowest_integrand_time() const
+    {
+        return slowest_integrand_time_;
+    }
+
+    // Returns the sum of the times all processes spent in sampling after `reduce` has been called
+    double total_integrand_time() const
+    {
+        return total_integrand_time_;
+    }
+
+    // Returns the rank of the process with the `slowest_integrand_time`
+    std::size_t slowest_process() const
+    {
+        return slowest_process_;
+    }
+
+private:
+    // Unpacks the sum of the results after the reduction, see `reduce`
+    plain_result<T> unpack(plain_result<T> const& result, std::size_t total_calls)
+    {
+        T const* values = reinterpret_cast <T const*> (&buffer_[mpi_result_header]);
+        std::uint64_t const* counters = reinterpret_cast <std::uint64_t const*> (
+            &buffer_[mpi_result_counter_offset<T>(values_)]);
+
+        additional_data_.assign(values, values + additional_);
+
+        double const* timings = reinterpret_cast <double const*> (
+            &buffer_[mpi_result_timing_offset<T>(values_, counters_)]);
+        slowest_integrand_time_ = timings[0];
+        total_integrand_time_ = timings[1];
+        slowest_process_ = static_cast <std::size_t> (timings[2]);
+
+        return mpi_unpack_result(result, total_calls, values + additional_, counters);
+    }
+
+    // Creates the buffer and the datatype for `values` floating-point numbers and `counters`
+    // counters, unless the previous iteration already used the same layout
+    void layout(std::size_t values, std::size_t counters)
+    {
+        if (operation_ == MPI_OP_NULL)
+        {
+            MPI_Op_create(&mpi_result_sum<T>, 1, &operation_);
+        }
+
+        if ((datatype_ != MPI_DATATYPE_NULL) && (values == values_) && (counters == counters_))
+        {
+            return;
+        }
+
+        if (datatype_ != MPI_DATATYPE_NULL)
+        {
+            MPI_Type_free(&datatype_);
+        }
+
+        values_ = values;
+        counters_ = counters;
+
+        std::size_t const offset = mpi_result_counter_offset<T>(values);
+        std::size_t const timing_offset = mpi_result_timing_offset<T>(values, counters);
+
+        int lengths[] = {
+            static_cast <int> (mpi_result_header / sizeof (std::uint64_t)),
+            static_cast <int> (values),
+            static_cast <int> (counters),
+            static_cast <int> (mpi_result_timings)
+        };
+        MPI_Aint displacements[] = {
+            0,
+            static_cast <MPI_Aint> (mpi_result_header),
+            static_cast <MPI_Aint> (offset),
+            static_cast <MPI_Aint> (timing_offset)
+        };
+        MPI_Datatype types[] = {
+            mpi_datatype<std::uint64_t>(),
+            mpi_datatype<T>(),
+            mpi_datatype<std::uint64_t>(),
+            mpi_datatype<double>()
+        };
+
+        MPI_Type_create_struct(4, lengths, displacements, types, &datatype_);
+        MPI_Type_commit(&datatype_);
+
+        MPI_Aint lower_bound = 0;
+        MPI_Aint extent = 0;
+        MPI_Type_get_extent(datatype_, &lower_bound, &extent);
+
+        std::size_t const size = timing_offset + mpi_result_timings * sizeof (double);
+
+        // the buffer consists of `long double` to align the header and all numbers
+        buffer_storage_.assign((std::max(size, static_cast <std::size_t> (extent)) +
+            sizeof (long double) - 1) / sizeof (long double), 0.0L);
+        buffer_ = reinterpret_cast <char*> (buffer_storage_.data());
+
+        std::uint64_t* header = reinterpret_cast <std::uint64_t*> (buffer_);
+        header[0] = values;
+        header[1] = counters;
+        header[2] = static_cast <std::uint64_t> (extent);
+        header[3] = 0;
+    }
+
+    MPI_Comm communicator_;
+    std::size_t rank_;
+    std::size_t processes_;
+    MPI_Datatype datatype_;
+    MPI_Op operation_;
+    std::size_t values_;
+    std::size_t counters_;
+    std::size_t additional_;
+    std::vector<long double> buffer_storage_;
+    char* buffer_;
+    std::vector<T> additional_data_;
+    double slowest_integrand_time_;
+    double total_integrand_time_;
+    std::size_t slowest_process_;
+};
+
 /// \endcond
 
 }
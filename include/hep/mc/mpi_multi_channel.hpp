@@ -21,13 +21,19 @@
 
 #include "hep/mc/generator_helper.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
 #include "hep/mc/mpi_callback.hpp"
 #include "hep/mc/mpi_helper.hpp"
+#include "hep/mc/mpi_schedule.hpp"
 #include "hep/mc/multi_channel.hpp"
 #include "hep/mc/multi_channel_result.hpp"
+#include "hep/mc/parallel_helper.hpp"
+#include "hep/mc/parallel_multi_channel.hpp"
 
 #include <cstddef>
+#include <memory>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -39,15 +45,23 @@ namespace hep
 /// \addtogroup multi_channel_group
 /// @{
 
-/// MPI version of \ref multi_channel.
-template <typename I, typename Checkpoint = default_multi_channel_chkpt<numeric_type_of<I>>,
+/// MPI version of \ref multi_channel. The calls of each iteration are distributed among the
+/// processes according to `schedule`. Each process evaluates its calls with `threads` threads, see
+/// \ref thread_pool; if `threads` is zero, the number of hardware threads is used. The results of
+/// the threads are merged before they are summed over the processes. Only the calling thread uses
+/// MPI, which must therefore be initialized with at least `MPI_THREAD_FUNNELED` if `threads` is not
+/// one; otherwise `std::runtime_error` is thrown.
+template <typename Selection = cumulative_selection, typename I,
+    typename Checkpoint = default_multi_channel_chkpt<numeric_type_of<I>>,
     typename Callback = mpi_callback<Checkpoint>>
 inline Checkpoint mpi_multi_channel(
     MPI_Comm communicator,
     I&& integrand,
     std::vector<std::size_t> const& iteration_calls,
     Checkpoint chkpt = make_multi_channel_chkpt<numeric_type_of<I>>(),
-    Callback callback = mpi_callback<Checkpoint>()
+    Callback callback = mpi_callback<Checkpoint>(),
+    mpi_schedule schedule = mpi_schedule::equal_shares,
+    std::size_t threads = 1
 ) {
     using T = numeric_type_of<I>;
 
@@ -61,34 +75,108 @@ inline Checkpoint mpi_multi_channel(
     auto generator = chkpt.generator();
     auto weights = chkpt.channel_weights();
 
-    std::vector<T> buffer;
+    using integrand_type = typename std::decay<I>::type;
+    using chunk_type = chunk_accumulator_type<I>;
+    using generator_type = decltype (generator);
+
+    thread_pool pool(threads);
+    mpi_check_thread_level(pool.size());
+
+    std::unique_ptr<mpi_chunk_counter> counter;
+
+    if (schedule == mpi_schedule::dynamic)
+    {
+        counter.reset(new mpi_chunk_counter(communicator, iteration_calls.size()));
+    }
+
+    mpi_result_reduction<T> reduction(communicator);
+    mpi_chunk_results<T> chunks(communicator);
 
     // hep::discrete_distribution consumes as many random numbers as an
     // additional dimension
     std::size_t const usage = (1 + integrand.dimensions()) *
         random_number_usage<T, decltype (generator)>();
 
-    for (auto const calls : iteration_calls)
-    {
+    // performs this process' part of the iteration with index `index`
+    auto const iteration = [&](std::size_t index) -> multi_channel_result<T> {
+        std::size_t const calls = iteration_calls[index];
+
+        if (counter)
+        {
+            auto const enabled_channels = multi_channel_enabled_channels(weights);
+
+            discrete_distribution<std::size_t, T, Selection> const channel_selector(
+                weights.begin(), weights.end());
+
+            auto const store = [&](std::size_t chunk, std::size_t chunk_calls,
+                chunk_type const& buffer) {
+                chunks.add(chunk, buffer.accumulator().result(chunk_calls),
+                    buffer.adjustment_data());
+            };
+
+            mpi_dynamic_sample(*counter, pool, index, integrand, calls, usage,
+                make_chunk_accumulator(integrand, weights.size()), generator,
+                [&](integrand_type& local_integrand, chunk_type& chunk, std::size_t chunk_calls,
+                    generator_type& chunk_generator) {
+                    multi_channel_sample(local_integrand, chunk.accumulator(), chunk_calls,
+                        weights, enabled_channels, channel_selector, chunk_generator,
+                        chunk.adjustment_data());
+            }, store);
+
+            // the chunks are summed after the sampling time has been measured, see below
+            return multi_channel_result<T>(make_accumulator(integrand).result(calls),
+                std::vector<T>(weights.size()), weights);
+        }
+
         generator.discard(usage * discard_before(calls, rank, world));
 
         std::size_t const sub_calls = (calls / world) +
             (static_cast <std::size_t> (rank) < (calls % world) ? 1 : 0);
 
-        auto const sub_result = multi_channel_iteration(integrand, sub_calls, weights, generator);
+        auto const result = (pool.size() == 1)
+            ? multi_channel_iteration<Selection>(integrand, sub_calls, weights, generator)
+            : parallel_multi_channel_iteration<Selection>(pool, integrand, sub_calls, weights,
+                generator);
 
         generator.discard(usage * discard_after(calls, sub_calls, rank, world));
 
-        auto const result = multi_channel_result<T>{allreduce_result(communicator, sub_result,
-            buffer, sub_result.adjustment_data(), calls), buffer, weights};
+        return result;
+    };
+
+    stopwatch wall_time;
+
+    for (std::size_t i = 0; i != iteration_calls.size(); ++i)
+    {
+        std::size_t const calls = iteration_calls[i];
+        stopwatch integrand_time;
+        auto sub_result = iteration(i);
+        double const integrand_seconds = integrand_time.seconds();
+
+        stopwatch reduction_time;
 
-        chkpt.add(result, generator);
+        if (counter)
+        {
+            // sum the chunks of all processes in the order of their indices
+            auto adjustment_data = sub_result.adjustment_data();
+            auto const sum = chunks.sum(sub_result, adjustment_data, calls);
+            sub_result = multi_channel_result<T>(sum, adjustment_data, weights);
+        }
+
+        auto const result = multi_channel_result<T>{reduction.reduce(sub_result,
+            sub_result.adjustment_data(), integrand_seconds, calls), reduction.additional_data(),
+            weights};
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(), integrand_seconds,
+            reduction_time.seconds(), reduction.processes(), reduction.slowest_integrand_time(),
+            reduction.total_integrand_time(), reduction.slowest_process()));
 
         if (!callback(communicator, chkpt))
         {
             break;
         }
 
+        wall_time.restart();
+
         weights = multi_channel_refine_weights(weights, result.adjustment_data(),
             chkpt.min_weight(), chkpt.beta());
     }
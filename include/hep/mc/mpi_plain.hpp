@@ -21,8 +21,11 @@
 
 #include "hep/mc/generator_helper.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
 #include "hep/mc/mpi_callback.hpp"
 #include "hep/mc/mpi_helper.hpp"
+#include "hep/mc/mpi_schedule.hpp"
+#include "hep/mc/parallel_plain.hpp"
 #include "hep/mc/plain.hpp"
 #include "hep/mc/plain_chkpt.hpp"
 #include "hep/mc/plain_result.hpp"
@@ -30,7 +33,9 @@
 #include <mpi.h>
 
 #include <cstddef>
+#include <memory>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace hep
@@ -39,7 +44,12 @@ namespace hep
 /// \addtogroup plain_group
 /// @{
 
-/// MPI version of the plain Monte Carlo integrator.
+/// MPI version of the plain Monte Carlo integrator. The calls of each iteration are distributed
+/// among the processes according to `schedule`. Each process evaluates its calls with `threads`
+/// threads, see \ref thread_pool; if `threads` is zero, the number of hardware threads is used. The
+/// results of the threads are merged before they are summed over the processes. Only the calling
+/// thread uses MPI, which must therefore be initialized with at least `MPI_THREAD_FUNNELED` if
+/// `threads` is not one; otherwise `std::runtime_error` is thrown.
 template <typename I, typename Checkpoint = default_plain_chkpt<numeric_type_of<I>>,
     typename Callback = mpi_callback<Checkpoint>>
 inline Checkpoint mpi_plain(
@@ -47,7 +57,9 @@ inline Checkpoint mpi_plain(
     I&& integrand,
     std::vector<std::size_t> const& iteration_calls,
     Checkpoint chkpt = make_plain_chkpt<numeric_type_of<I>>(),
-    Callback callback = mpi_callback<Checkpoint>()
+    Callback callback = mpi_callback<Checkpoint>(),
+    mpi_schedule schedule = mpi_schedule::equal_shares,
+    std::size_t threads = 1
 ) {
     using T = numeric_type_of<I>;
 
@@ -58,37 +70,95 @@ inline Checkpoint mpi_plain(
 
     auto generator = chkpt.generator();
 
-    std::vector<T> buffer;
+    using integrand_type = typename std::decay<I>::type;
+    using chunk_type = chunk_accumulator_type<I>;
+    using generator_type = decltype (generator);
+
+    thread_pool pool(threads);
+    mpi_check_thread_level(pool.size());
+
+    std::unique_ptr<mpi_chunk_counter> counter;
+
+    if (schedule == mpi_schedule::dynamic)
+    {
+        counter.reset(new mpi_chunk_counter(communicator, iteration_calls.size()));
+    }
+
+    mpi_result_reduction<T> reduction(communicator);
+    mpi_chunk_results<T> chunks(communicator);
+    std::vector<T> no_additional_data;
 
     std::size_t const usage = integrand.dimensions() *
         random_number_usage<T, decltype (generator)>();
 
-    // perform iterations
-    for (auto calls : iteration_calls)
-    {
+    auto const iteration = [&](std::size_t index) -> plain_result<T> {
+        std::size_t const calls = iteration_calls[index];
+
+        if (counter)
+        {
+            auto const store = [&](std::size_t chunk, std::size_t chunk_calls,
+                chunk_type const& buffer) {
+                chunks.add(chunk, buffer.accumulator().result(chunk_calls), no_additional_data);
+            };
+
+            mpi_dynamic_sample(*counter, pool, index, integrand, calls, usage,
+                make_chunk_accumulator(integrand, 0), generator,
+                [](integrand_type& local_integrand, chunk_type& chunk, std::size_t chunk_calls,
+                    generator_type& chunk_generator) {
+                    plain_sample(local_integrand, chunk.accumulator(), chunk_calls,
+                        chunk_generator);
+            }, store);
+
+            // the chunks are summed after the sampling time has been measured, see below
+            return make_accumulator(integrand).result(calls);
+        }
+
         generator.discard(usage * discard_before(calls, rank, world));
 
         // the number of function calls for each MPI process
         std::size_t const sub_calls = (calls / world) +
             (static_cast <std::size_t> (rank) < (calls % world) ? 1 : 0);
-        auto const result = plain_iteration(integrand, sub_calls, generator);
+        auto const result = (pool.size() == 1)
+            ? plain_iteration(integrand, sub_calls, generator)
+            : parallel_plain_iteration(pool, integrand, sub_calls, generator);
 
         generator.discard(usage * discard_after(calls, sub_calls, rank, world));
 
-        auto const& new_result = allreduce_result(
-            communicator,
-            result,
-            buffer,
-            std::vector<T>(),
-            calls
-        );
+        return result;
+    };
+
+    stopwatch wall_time;
+
+    // perform iterations
+    for (std::size_t i = 0; i != iteration_calls.size(); ++i)
+    {
+        stopwatch integrand_time;
+        auto sub_result = iteration(i);
+        double const integrand_seconds = integrand_time.seconds();
 
-        chkpt.add(new_result, generator);
+        // the next iteration is not sampled before `callback` decided to continue, because
+        // discarding it would waste its calls and repeat the side effects of the integrand
+        stopwatch reduction_time;
+
+        if (counter)
+        {
+            // sum the chunks of all processes in the order of their indices
+            sub_result = chunks.sum(sub_result, no_additional_data, iteration_calls[i]);
+        }
+
+        auto const result = reduction.reduce(sub_result, no_additional_data, integrand_seconds,
+            iteration_calls[i]);
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(), integrand_seconds,
+            reduction_time.seconds(), reduction.processes(), reduction.slowest_integrand_time(),
+            reduction.total_integrand_time(), reduction.slowest_process()));
 
         if (!callback(communicator, chkpt))
         {
             break;
         }
+
+        wall_time.restart();
     }
 
     return chkpt;
@@ -0,0 +1,378 @@
+#ifndef HEP_MC_MPI_SCHEDULE_HPP
+#define HEP_MC_MPI_SCHEDULE_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/mpi_helper.hpp"
+#include "hep/mc/parallel_helper.hpp"
+#include "hep/mc/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace hep
+{
+
+/// Determines how the MPI integrators distribute the calls of an iteration among the processes.
+/// The same schedule must be used by every process of the communicator.
+enum class mpi_schedule
+{
+    /// Each process performs an equal share of the calls of each iteration.
+    equal_shares,
+
+    /// The calls of each iteration are divided into chunks, which the processes fetch one after
+    /// another from a counter stored on the process with rank zero. Processes that evaluate
+    /// cheaper points therefore perform more calls, and fast processes do not have to wait for the
+    /// slow ones at the end of an iteration. Each chunk is identified by its offset in the random
+    /// numbers of the iteration, so that every call uses the same random numbers regardless of
+    /// which process performs it. The results of the chunks are sent to the process with rank
+    /// zero, which sums them in the order of their offsets. The results therefore do not depend on
+    /// which process evaluated which chunk, and repeated integrations with the same number of
+    /// processes and threads agree bitwise. They agree with those of
+    /// \ref mpi_schedule::equal_shares up to rounding differences in the summation. Collecting
+    /// the chunks costs an additional gather per iteration, whose size on the process with rank
+    /// zero is proportional to the number of processes times the size of a result with all its
+    /// distributions. This schedule requires an MPI library implementing MPI-3; with older
+    /// libraries the chunks are assigned to the processes in turn.
+    dynamic
+};
+
+/// \cond INTERNAL
+
+// Returns the number of calls in each chunk of an iteration with `calls` calls that is distributed
+// among `processes` processes with `threads` threads each
+inline std::size_t mpi_chunk_size(std::size_t calls, std::size_t processes, std::size_t threads)
+{
+    // enough chunks per process to balance the load, but large enough that fetching them is cheap
+    // and that every thread gets a part of each chunk
+    std::size_t const chunks_per_process = 16;
+    std::size_t const min_chunk_size = 64 * threads;
+    std::size_t const chunks = chunks_per_process * processes;
+
+    return std::max(min_chunk_size, (calls + chunks - 1) / chunks);
+}
+
+// Counter of the chunks already assigned to the processes of a communicator. Each iteration has its
+// own counter, so that the counters never have to be reset, which would need an additional
+// synchronization of all processes. The counters are stored in an
+// MPI window of the process with rank zero and incremented atomically by `MPI_Fetch_and_op`
+class mpi_chunk_counter
+{
+public:
+    mpi_chunk_counter(MPI_Comm communicator, std::size_t iterations)
+        : rank_(0)
+        , world_(0)
+#if MPI_VERSION >= 3
+        , window_(MPI_WIN_NULL)
+#else
+        , iteration_(0)
+        , assigned_(0)
+#endif
+    {
+        MPI_Comm_rank(communicator, &rank_);
+        MPI_Comm_size(communicator, &world_);
+
+#if MPI_VERSION >= 3
+        std::size_t const size = (rank_ == 0) ? iterations : 0;
+        std::uint64_t* counters = nullptr;
+
+        MPI_Win_allocate(static_cast <MPI_Aint> (size * sizeof (std::uint64_t)),
+            sizeof (std::uint64_t), MPI_INFO_NULL, communicator, &counters, &window_);
+
+        if (rank_ == 0)
+        {
+            MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, window_);
+            std::fill(counters, counters + size, std::uint64_t());
+            MPI_Win_unlock(0, window_);
+        }
+
+        // no process may fetch a chunk before the counters are initialized
+        MPI_Barrier(communicator);
+        MPI_Win_lock_all(0, window_);
+#else
+        static_cast <void> (iterations);
+#endif
+    }
+
+    mpi_chunk_counter(mpi_chunk_counter const&) = delete;
+
+    mpi_chunk_counter& operator=(mpi_chunk_counter const&) = delete;
+
+    ~mpi_chunk_counter()
+    {
+#if MPI_VERSION >= 3
+        MPI_Win_unlock_all(window_);
+        MPI_Win_free(&window_);
+#endif
+    }
+
+    // Returns the number of processes sharing this counter
+    std::size_t processes() const
+    {
+        return static_cast <std::size_t> (world_);
+    }
+
+    // Returns the index of the next chunk of `iteration` this process has to evaluate. Once all
+    // chunks have been assigned the returned indices are not smaller than the number of chunks
+    std::size_t next(std::size_t iteration)
+    {
+#if MPI_VERSION >= 3
+        std::uint64_t const one = 1;
+        std::uint64_t chunk = 0;
+
+        MPI_Fetch_and_op(&one, &chunk, mpi_datatype<std::uint64_t>(), 0,
+            static_cast <MPI_Aint> (iteration), MPI_SUM, window_);
+        MPI_Win_flush(0, window_);
+
+        return static_cast <std::size_t> (chunk);
+#else
+        if (iteration != iteration_)
+        {
+            iteration_ = iteration;
+            assigned_ = 0;
+        }
+
+        return static_cast <std::size_t> (rank_) + (assigned_++) * processes();
+#endif
+    }
+
+private:
+    int rank_;
+    int world_;
+#if MPI_VERSION >= 3
+    MPI_Win window_;
+#else
+    std::size_t iteration_;
+    std::size_t assigned_;
+#endif
+};
+
+// Results of the chunks of a dynamically scheduled iteration. Each process adds the chunks it
+// evaluated, and `sum` adds the chunks of all processes in the order of their indices, so that the
+// sum does not depend on which process evaluated which chunk. The results of the chunks are packed
+// as by `mpi_pack_result`, and the buffers are reused for all iterations
+template <typename T>
+class mpi_chunk_results
+{
+public:
+    explicit mpi_chunk_results(MPI_Comm communicator)
+        : communicator_(communicator)
+        , rank_(0)
+        , world_(0)
+    {
+        MPI_Comm_rank(communicator, &rank_);
+        MPI_Comm_size(communicator, &world_);
+    }
+
+    // Adds the `result` and the `additional_data` of the chunk with index `chunk`
+    void add(
+        std::size_t chunk,
+        plain_result<T> const& result,
+        std::vector<T> const& additional_data
+    ) {
+        std::size_t const values = values_.size();
+        std::size_t const counters = counters_.size();
+        std::size_t const size = mpi_result_counters(result);
+
+        values_.resize(values + additional_data.size() + size);
+        counters_.resize(counters + size + 1);
+        counters_[counters] = chunk;
+
+        mpi_pack_result(result, additional_data, &values_[values], &counters_[counters + 1]);
+    }
+
+    // Sums the chunks added by all processes in the order of their indices and removes them. The
+    // process with rank zero returns the sum and replaces `additional_data` with the sum of the
+    // additional data, the other processes return zeros and set `additional_data` to zero, so that
+    // summing the returned results over all processes gives the sum on every process, independently
+    // of the order of the summation. The layout of the chunks is given by `result` and the size of
+    // `additional_data`, which must be the same on all processes, and `total_calls` is the number
+    // of calls of the returned result
+    plain_result<T> sum(
+        plain_result<T> const& result,
+        std::vector<T>& additional_data,
+        std::size_t total_calls
+    ) {
+        std::size_t const counters = mpi_result_counters(result);
+        std::size_t const values = additional_data.size() + counters;
+
+        int const chunks = static_cast <int> (counters_.size() / (counters + 1));
+        std::vector<int> process_chunks(static_cast <std::size_t> (world_));
+
+        MPI_Gather(&chunks, 1, MPI_INT, process_chunks.data(), 1, MPI_INT, 0, communicator_);
+
+        // the chunks are counted with datatypes for a whole chunk, which avoids overflows of the
+        // counts and displacements for large results
+        MPI_Datatype value_type = MPI_DATATYPE_NULL;
+        MPI_Datatype counter_type = MPI_DATATYPE_NULL;
+        MPI_Type_contiguous(static_cast <int> (values), mpi_datatype<T>(), &value_type);
+        MPI_Type_contiguous(static_cast <int> (counters + 1), mpi_datatype<std::uint64_t>(),
+            &counter_type);
+        MPI_Type_commit(&value_type);
+        MPI_Type_commit(&counter_type);
+
+        std::vector<int> displacements(process_chunks.size());
+        std::size_t all_chunks = 0;
+
+        for (std::size_t i = 0; i != process_chunks.size(); ++i)
+        {
+            displacements[i] = static_cast <int> (all_chunks);
+            all_chunks += static_cast <std::size_t> (process_chunks[i]);
+        }
+
+        all_values_.resize(all_chunks * values);
+        all_counters_.resize(all_chunks * (counters + 1));
+
+        MPI_Gatherv(values_.data(), chunks, value_type, all_values_.data(), process_chunks.data(),
+            displacements.data(), value_type, 0, communicator_);
+        MPI_Gatherv(counters_.data(), chunks, counter_type, all_counters_.data(),
+            process_chunks.data(), displacements.data(), counter_type, 0, communicator_);
+
+        MPI_Type_free(&value_type);
+        MPI_Type_free(&counter_type);
+
+        std::vector<T> sum_values(values);
+        std::vector<std::uint64_t> sum_counters(counters);
+
+        if (rank_ == 0)
+        {
+            std::vector<std::pair<std::uint64_t, std::size_t>> order;
+            order.reserve(all_chunks);
+
+            for (std::size_t i = 0; i != all_chunks; ++i)
+            {
+                order.emplace_back(all_counters_[i * (counters + 1)], i);
+            }
+
+            std::sort(order.begin(), order.end());
+
+            for (auto const& chunk : order)
+            {
+                T const* chunk_values = &all_values_[chunk.second * values];
+                std::uint64_t const* chunk_counters =
+                    &all_counters_[chunk.second * (counters + 1) + 1];
+
+                for (std::size_t i = 0; i != values; ++i)
+                {
+                    sum_values[i] += chunk_values[i];
+                }
+
+                for (std::size_t i = 0; i != counters; ++i)
+                {
+                    sum_counters[i] += chunk_counters[i];
+                }
+            }
+        }
+
+        values_.clear();
+        counters_.clear();
+
+        std::size_t const additional = additional_data.size();
+        additional_data.assign(sum_values.begin(), sum_values.begin() + additional);
+
+        return mpi_unpack_result(result, total_calls, sum_values.data() + additional,
+            sum_counters.data());
+    }
+
+private:
+    MPI_Comm communicator_;
+    int rank_;
+    int world_;
+    std::vector<T> values_;
+    std::vector<std::uint64_t> counters_;
+    std::vector<T> all_values_;
+    std::vector<std::uint64_t> all_counters_;
+};
+
+// Performs the part of the iteration with index `iteration` and `calls` calls that `counter`
+// assigns to this process. Each chunk is evaluated by calling `sample(integrand, buffer,
+// chunk_calls, chunk_generator)` with a copy of `integrand`, a buffer initialized with `empty`, and
+// a copy of `generator` that is forwarded to the beginning of the chunk; `usage` must be the number
+// of random numbers each call draws. If `pool` has more than one thread, each chunk is divided
+// among its threads by \ref parallel_sample and only the calling thread communicates. The buffer
+// of each chunk is passed to `store(chunk, chunk_calls, buffer)` together with the index of the
+// chunk, so that the chunks can be summed in the order of their indices, see `mpi_chunk_results`.
+// Afterwards `generator` is in the same state as if it was used to perform all `calls` calls
+template <typename I, typename C, typename R, typename F, typename S>
+inline void mpi_dynamic_sample(
+    mpi_chunk_counter& counter,
+    thread_pool& pool,
+    std::size_t iteration,
+    I&& integrand,
+    std::size_t calls,
+    std::size_t usage,
+    C const& empty,
+    R& generator,
+    F&& sample,
+    S&& store
+) {
+    using integrand_type = typename std::decay<I>::type;
+
+    std::size_t const chunk_size = mpi_chunk_size(calls, counter.processes(), pool.size());
+    std::size_t const chunks = (calls + chunk_size - 1) / chunk_size;
+
+    integrand_type local_integrand = integrand;
+    C buffer = empty;
+    R local_generator = generator;
+    std::size_t position = 0;
+
+    for (;;)
+    {
+        std::size_t const chunk = counter.next(iteration);
+
+        if (chunk >= chunks)
+        {
+            break;
+        }
+
+        std::size_t const begin = chunk * chunk_size;
+        std::size_t const chunk_calls = std::min(chunk_size, calls - begin);
+
+        // the chunks of a process are increasing, so the generator only has to move forward
+        local_generator.discard(usage * (begin - position));
+        position = begin + chunk_calls;
+
+        if (pool.size() == 1)
+        {
+            // the assignment reuses the memory of the buffer
+            buffer = empty;
+            sample(local_integrand, buffer, chunk_calls, local_generator);
+            store(chunk, chunk_calls, buffer);
+        }
+        else
+        {
+            store(chunk, chunk_calls, parallel_sample(pool, integrand, chunk_calls, usage, empty,
+                local_generator, sample));
+        }
+    }
+
+    generator.discard(usage * calls);
+}
+
+/// \endcond
+
+}
+
+#endif
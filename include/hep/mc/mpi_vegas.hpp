@@ -21,14 +21,21 @@
 
 #include "hep/mc/generator_helper.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
 #include "hep/mc/mpi_callback.hpp"
 #include "hep/mc/mpi_helper.hpp"
+#include "hep/mc/mpi_schedule.hpp"
+#include "hep/mc/parallel_helper.hpp"
+#include "hep/mc/parallel_vegas.hpp"
+#include "hep/mc/storage_policy.hpp"
 #include "hep/mc/vegas.hpp"
 #include "hep/mc/vegas_chkpt.hpp"
 #include "hep/mc/vegas_pdf.hpp"
 
 #include <cstddef>
+#include <memory>
 #include <random>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -40,15 +47,24 @@ namespace hep
 /// \addtogroup vegas_group
 /// @{
 
-/// MPI version of \ref vegas.
-template <typename I, typename Checkpoint = default_vegas_chkpt<numeric_type_of<I>>,
+/// MPI version of \ref vegas. The calls of each iteration are distributed among the processes
+/// according to `schedule`. Each process evaluates its calls with `threads` threads, see \ref
+/// thread_pool; if `threads` is zero, the number of hardware threads is used. The results of the
+/// threads are merged before they are summed over the processes. Only the calling thread uses MPI,
+/// which must therefore be initialized with at least `MPI_THREAD_FUNNELED` if `threads` is not one;
+/// otherwise `std::runtime_error` is thrown. The adjustment data is stored as given by `Storage`,
+/// see \ref vegas_iteration.
+template <template <typename> class Storage = storage_policy, typename I,
+    typename Checkpoint = default_vegas_chkpt<numeric_type_of<I>>,
     typename Callback = mpi_callback<Checkpoint>>
 inline Checkpoint mpi_vegas(
     MPI_Comm communicator,
     I&& integrand,
     std::vector<std::size_t> const& iteration_calls,
     Checkpoint chkpt = make_vegas_chkpt<numeric_type_of<I>>(),
-    Callback callback = mpi_callback<Checkpoint>()
+    Callback callback = mpi_callback<Checkpoint>(),
+    mpi_schedule schedule = mpi_schedule::equal_shares,
+    std::size_t threads = 1
 ) {
     using T = numeric_type_of<I>;
 
@@ -62,33 +78,99 @@ inline Checkpoint mpi_vegas(
     auto generator = chkpt.generator();
     auto pdf = chkpt.pdf();
 
-    // reserve a buffer for the MPI call to sum `adjustment_data`, `sum`, and
-    // `sum_of_squares`
-    std::vector<T> buffer(pdf.dimensions() * pdf.bins() + 2);
+    using integrand_type = typename std::decay<I>::type;
+    using adjustment_type = typename Storage<T>::adjustment_type;
+    using chunk_type = chunk_accumulator_type<I, adjustment_type>;
+    using generator_type = decltype (generator);
 
-    std::size_t const usage = pdf.dimensions() * random_number_usage<T, decltype (generator)>();
+    thread_pool pool(threads);
+    mpi_check_thread_level(pool.size());
 
-    // perform iterations
-    for (auto const calls : iteration_calls)
+    std::unique_ptr<mpi_chunk_counter> counter;
+
+    if (schedule == mpi_schedule::dynamic)
     {
+        counter.reset(new mpi_chunk_counter(communicator, iteration_calls.size()));
+    }
+
+    mpi_result_reduction<T> reduction(communicator);
+    mpi_chunk_results<T> chunks(communicator);
+
+    std::size_t const usage = pdf.dimensions() * random_number_usage<T, decltype (generator)>();
+
+    // performs this process' part of the iteration with index `index`
+    auto const iteration = [&](std::size_t index) -> vegas_result<T> {
+        std::size_t const calls = iteration_calls[index];
+
+        if (counter)
+        {
+            auto const store = [&](std::size_t chunk, std::size_t chunk_calls,
+                chunk_type const& buffer) {
+                chunks.add(chunk, buffer.accumulator().result(chunk_calls),
+                    storage_cast<T>(buffer.adjustment_data()));
+            };
+
+            mpi_dynamic_sample(*counter, pool, index, integrand, calls, usage,
+                make_chunk_accumulator<adjustment_type>(integrand, pdf.dimensions() * pdf.bins()),
+                generator,
+                [&](integrand_type& local_integrand, chunk_type& chunk, std::size_t chunk_calls,
+                    generator_type& chunk_generator) {
+                    vegas_sample(local_integrand, chunk.accumulator(), chunk_calls, pdf,
+                        chunk_generator, chunk.adjustment_data());
+            }, store);
+
+            // the chunks are summed after the sampling time has been measured, see below
+            return vegas_result<T>(make_accumulator(integrand).result(calls), pdf,
+                std::vector<T>(pdf.dimensions() * pdf.bins()));
+        }
+
         generator.discard(usage * discard_before(calls, rank, world));
 
         std::size_t const sub_calls = (calls / world) +
             (static_cast <std::size_t> (rank) < (calls % world) ? 1 : 0);
-        auto const sub_result = vegas_iteration(integrand, sub_calls, pdf, generator);
+        auto const result = (pool.size() == 1)
+            ? vegas_iteration<Storage>(integrand, sub_calls, pdf, generator)
+            : parallel_vegas_iteration<Storage>(pool, integrand, sub_calls, pdf, generator);
 
         generator.discard(usage * discard_after(calls, sub_calls, rank, world));
 
-        auto const result = vegas_result<T>{allreduce_result(communicator, sub_result, buffer,
-            sub_result.adjustment_data(), calls), pdf, buffer};
+        return result;
+    };
+
+    stopwatch wall_time;
+
+    // perform iterations
+    for (std::size_t i = 0; i != iteration_calls.size(); ++i)
+    {
+        std::size_t const calls = iteration_calls[i];
+        stopwatch integrand_time;
+        auto sub_result = iteration(i);
+        double const integrand_seconds = integrand_time.seconds();
+
+        stopwatch reduction_time;
+
+        if (counter)
+        {
+            // sum the chunks of all processes in the order of their indices
+            auto adjustment_data = sub_result.adjustment_data();
+            auto const sum = chunks.sum(sub_result, adjustment_data, calls);
+            sub_result = vegas_result<T>(sum, pdf, adjustment_data);
+        }
+
+        auto const result = vegas_result<T>{reduction.reduce(sub_result,
+            sub_result.adjustment_data(), integrand_seconds, calls), pdf,
+            reduction.additional_data()};
 
-        chkpt.add(result, generator);
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(), integrand_seconds,
+            reduction_time.seconds(), reduction.processes(), reduction.slowest_integrand_time(),
+            reduction.total_integrand_time(), reduction.slowest_process()));
 
         if (!callback(communicator, chkpt))
         {
             break;
         }
 
+        wall_time.restart();
         pdf = vegas_refine_pdf(pdf, chkpt.alpha(), result.adjustment_data());
     }
 
@@ -20,15 +20,20 @@
  */
 
 #include "hep/mc/accumulator.hpp"
+#include "hep/mc/batch_integrand.hpp"
 #include "hep/mc/callback.hpp"
 #include "hep/mc/discrete_distribution.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/multi_channel_batch.hpp"
 #include "hep/mc/multi_channel_chkpt.hpp"
 #include "hep/mc/multi_channel_map.hpp"
 #include "hep/mc/multi_channel_point.hpp"
 #include "hep/mc/multi_channel_refine_weights.hpp"
 #include "hep/mc/multi_channel_result.hpp"
+#include "hep/mc/uniform_random.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <random>
@@ -39,35 +44,17 @@
 namespace hep
 {
 
-/// \addtogroup multi_channel_group
-/// @{
+/// \cond INTERNAL
 
-/// Performs exactly one iteration using with multi channel integrator of `integrand` using exactly
-/// `calls` number of integrand evaluations. The parameter `channel_weights` must specify the
-/// weights of each channel. Note that the weights must be normalized, i.e. their sum must be one.
-/// Random numbers are drawn from `generator`.
-template <typename I, typename R>
-inline multi_channel_result<numeric_type_of<I>> multi_channel_iteration(
-    I&& integrand,
-    std::size_t calls,
-    std::vector<numeric_type_of<I>> const& channel_weights,
-    R& generator
+// Returns the indices of all channels whose weights are not zero.
+template <typename T>
+inline std::vector<std::size_t> multi_channel_enabled_channels(
+    std::vector<T> const& channel_weights
 ) {
-    using T = numeric_type_of<I>;
-
-    auto accumulator = make_accumulator(integrand);
-
-    std::size_t const channels = channel_weights.size();
-
-    std::vector<T> random_numbers(integrand.dimensions());
-    std::vector<T> coordinates(integrand.map_dimensions());
-    std::vector<T> densities(channels);
-    std::vector<T> adjustment_data(channels);
-
     std::vector<std::size_t> enabled_channels;
-    enabled_channels.reserve(channels);
+    enabled_channels.reserve(channel_weights.size());
 
-    for (std::size_t i = 0; i != channels; ++i)
+    for (std::size_t i = 0; i != channel_weights.size(); ++i)
     {
         if (channel_weights.at(i) != T())
         {
@@ -75,24 +62,42 @@ inline multi_channel_result<numeric_type_of<I>> multi_channel_iteration(
         }
     }
 
-    // distribution that randomly selects a channel
-    discrete_distribution<std::size_t, T> channel_selector(channel_weights.begin(),
-        channel_weights.end());
+    return enabled_channels;
+}
+
+// Evaluates an integrand created with \ref make_multi_channel_integrand point by point.
+template <typename I, typename A, typename S, typename R>
+inline void multi_channel_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    std::vector<std::size_t> const& enabled_channels,
+    S const& channel_selector,
+    R& generator,
+    std::vector<numeric_type_of<I>>& adjustment_data,
+    std::false_type
+) {
+    using T = numeric_type_of<I>;
+    using map_type = typename std::remove_reference<
+        typename std::remove_reference<I>::type::map_type>::type;
+
+    std::size_t const channels = channel_weights.size();
+
+    std::vector<T> random_numbers(integrand.dimensions());
+    std::vector<T> coordinates(integrand.map_dimensions());
+    auto densities = make_multi_channel_densities<T, map_type>(channels);
 
     for (std::size_t i = 0; i != calls; ++i)
     {
         // generate as many random numbers as we need
-        for (std::size_t j = 0; j != integrand.dimensions(); ++j)
-        {
-            random_numbers[j] = std::generate_canonical<T,
-                std::numeric_limits<T>::digits>(generator);
-        }
+        generate_uniform(generator, random_numbers.data(), random_numbers.data() +
+            random_numbers.size());
 
         // randomly select a channel
         std::size_t const channel = channel_selector(generator);
 
-        using map_type = typename std::remove_reference<
-            typename std::remove_reference<I>::type::map_type>::type;
+        multi_channel_clear_densities(densities);
 
         // calculate `coordinates` and possibly `densities`
         integrand.map()(
@@ -124,11 +129,176 @@ inline multi_channel_result<numeric_type_of<I>> multi_channel_iteration(
         T const square = value * value * point.weight();
 
         // these are the values W that are used to update the alphas
-        for (std::size_t j = 0; j != channels; ++j)
+        multi_channel_adjust(adjustment_data, densities, square);
+    }
+}
+
+// Evaluates an integrand created with \ref make_multi_channel_batch_integrand. The random numbers
+// are drawn in the same order as for the point-by-point evaluation.
+template <typename I, typename A, typename S, typename R>
+inline void multi_channel_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    std::vector<std::size_t> const& enabled_channels,
+    S const& channel_selector,
+    R& generator,
+    std::vector<numeric_type_of<I>>& adjustment_data,
+    std::true_type
+) {
+    using T = numeric_type_of<I>;
+    using map_type = typename std::remove_reference<
+        typename std::remove_reference<I>::type::map_type>::type;
+
+    std::size_t const channels       = channel_weights.size();
+    std::size_t const dimensions     = integrand.dimensions();
+    std::size_t const map_dimensions = integrand.map_dimensions();
+    std::size_t const capacity       = batch_capacity(integrand, calls);
+
+    std::vector<T> random_numbers(dimensions);
+    std::vector<T> coordinates(map_dimensions);
+    auto densities = make_multi_channel_densities<T, map_type>(channels);
+
+    std::vector<T> points(dimensions * capacity);
+    std::vector<T> point_coordinates(map_dimensions * capacity);
+    std::vector<std::size_t> point_channels(capacity);
+    std::vector<T> values(capacity);
+
+    for (std::size_t i = 0; i < calls; i += capacity)
+    {
+        std::size_t const size = std::min(capacity, calls - i);
+
+        for (std::size_t j = 0; j != size; ++j)
         {
-            adjustment_data[j] += densities[j] * square;
+            generate_uniform(generator, random_numbers.data(), random_numbers.data() + dimensions);
+
+            std::size_t const channel = channel_selector(generator);
+
+            multi_channel_clear_densities(densities);
+
+            integrand.map()(
+                channel,
+                random_numbers,
+                coordinates,
+                enabled_channels,
+                densities,
+                multi_channel_map::calculate_coordinates
+            );
+
+            for (std::size_t k = 0; k != dimensions; ++k)
+            {
+                points[k * capacity + j] = random_numbers[k];
+            }
+
+            for (std::size_t k = 0; k != map_dimensions; ++k)
+            {
+                point_coordinates[k * capacity + j] = coordinates[k];
+            }
+
+            point_channels[j] = channel;
+        }
+
+        multi_channel_batch<T> const batch(points, point_coordinates, point_channels, size);
+
+        std::fill(values.begin(), values.end(), T());
+        integrand.function()(batch, values);
+
+        for (std::size_t j = 0; j != size; ++j)
+        {
+            if (values[j] == T())
+            {
+                continue;
+            }
+
+            for (std::size_t k = 0; k != dimensions; ++k)
+            {
+                random_numbers[k] = points[k * capacity + j];
+            }
+
+            for (std::size_t k = 0; k != map_dimensions; ++k)
+            {
+                coordinates[k] = point_coordinates[k * capacity + j];
+            }
+
+            multi_channel_clear_densities(densities);
+
+            // the densities are only needed for points with non-zero values
+            T weight = integrand.map()(
+                point_channels[j],
+                random_numbers,
+                coordinates,
+                enabled_channels,
+                densities,
+                multi_channel_map::calculate_densities
+            );
+
+            weight /= multi_channel_total_density(densities, channel_weights);
+
+            T const value = accumulator.add(values[j] * weight);
+
+            if (value == T())
+            {
+                continue;
+            }
+
+            T const square = value * value * weight;
+
+            // these are the values W that are used to update the alphas
+            multi_channel_adjust(adjustment_data, densities, square);
         }
     }
+}
+
+// Performs `calls` evaluations of `integrand` with channels selected by `channel_selector`, adds
+// them to `accumulator` and the values needed to refine the weights to `adjustment_data`. This is
+// the loop of \ref multi_channel_iteration, which is shared with the parallel integrators.
+template <typename I, typename A, typename S, typename R>
+inline void multi_channel_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    std::vector<std::size_t> const& enabled_channels,
+    S const& channel_selector,
+    R& generator,
+    std::vector<numeric_type_of<I>>& adjustment_data
+) {
+    multi_channel_sample(integrand, accumulator, calls, channel_weights, enabled_channels,
+        channel_selector, generator, adjustment_data, batch_tag_of<I>());
+}
+
+/// \endcond
+
+/// \addtogroup multi_channel_group
+/// @{
+
+/// Performs exactly one iteration using with multi channel integrator of `integrand` using exactly
+/// `calls` number of integrand evaluations. The parameter `channel_weights` must specify the
+/// weights of each channel. Note that the weights must be normalized, i.e. their sum must be one.
+/// Random numbers are drawn from `generator`. The channel of each point is selected with the policy
+/// `Selection`, see \ref cumulative_selection and \ref alias_selection.
+template <typename Selection = cumulative_selection, typename I, typename R>
+inline multi_channel_result<numeric_type_of<I>> multi_channel_iteration(
+    I&& integrand,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+
+    auto accumulator = make_accumulator(integrand);
+
+    std::vector<T> adjustment_data(channel_weights.size());
+
+    auto const enabled_channels = multi_channel_enabled_channels(channel_weights);
+
+    // distribution that randomly selects a channel
+    discrete_distribution<std::size_t, T, Selection> const channel_selector(
+        channel_weights.begin(), channel_weights.end());
+
+    multi_channel_sample(integrand, accumulator, calls, channel_weights, enabled_channels,
+        channel_selector, generator, adjustment_data);
 
     return multi_channel_result<T>(accumulator.result(calls), adjustment_data, channel_weights);
 }
@@ -136,12 +306,14 @@ inline multi_channel_result<numeric_type_of<I>> multi_channel_iteration(
 /// Multi channel integrator. Integrates `integrand` using `iteration_calls.size()` iterations, with
 /// the number of calls for each iteration given in `iteration_calls`. The integration starts from
 /// the default (empty) checkpoint, unless one is explicitly given in `chkpt`. After each successful
-/// iteration the `callback` function is invoked.
+/// iteration the `callback` function is invoked. The channels are selected with the policy
+/// `Selection`, which can be given as the first template argument.
 ///
 /// \see checkpoints
 /// \see integrands
 /// \see callbacks
-template <typename I, typename Checkpoint = default_multi_channel_chkpt<numeric_type_of<I>>,
+template <typename Selection = cumulative_selection, typename I,
+    typename Checkpoint = default_multi_channel_chkpt<numeric_type_of<I>>,
     typename Callback = callback<Checkpoint>>
 inline Checkpoint multi_channel(
     I&& integrand,
@@ -152,18 +324,24 @@ inline Checkpoint multi_channel(
     chkpt.channels(integrand.channels());
 
     auto generator = chkpt.generator();
+    stopwatch wall_time;
 
     for (auto const calls : iteration_calls)
     {
         auto const& weights = chkpt.channel_weights();
-        auto const& result = multi_channel_iteration(integrand, calls, weights, generator);
+        stopwatch integrand_time;
+        auto const& result = multi_channel_iteration<Selection>(integrand, calls, weights,
+            generator);
 
-        chkpt.add(result, generator);
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
 
         if (!callback(chkpt))
         {
             break;
         }
+
+        wall_time.restart();
     }
 
     return chkpt;
@@ -0,0 +1,125 @@
+#ifndef HEP_MC_MULTI_CHANNEL_BATCH_HPP
+#define HEP_MC_MULTI_CHANNEL_BATCH_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup integrands
+/// @{
+
+/// A block of points generated by the multi channel integrator, which is passed to integrands
+/// created with \ref make_multi_channel_batch_integrand. The random numbers and the coordinates
+/// calculated by the map function are stored as structures of arrays, see \ref mc_batch. In
+/// contrast to \ref multi_channel_point the weights are not available, because they are calculated
+/// only for the points where the integrand is not zero.
+template <typename T>
+class multi_channel_batch
+{
+public:
+    /// Constructor. The vectors `points` and `coordinates` must contain the random numbers and
+    /// coordinates of dimension `d` of the point `i` at index `d * channels.size() + i`. The first
+    /// `size` points are the ones of this batch.
+    multi_channel_batch(
+        std::vector<T> const& points,
+        std::vector<T> const& coordinates,
+        std::vector<std::size_t> const& channels,
+        std::size_t size
+    )
+        : points_(points)
+        , coordinates_(coordinates)
+        , channels_(channels)
+        , size_(size)
+    {
+    }
+
+    /// There is no copy constructor.
+    multi_channel_batch(multi_channel_batch<T> const&) = delete;
+
+    /// There is no move constructor.
+    multi_channel_batch(multi_channel_batch<T>&&) = delete;
+
+    /// There is no copy assignment operator.
+    multi_channel_batch& operator=(multi_channel_batch<T> const&) = delete;
+
+    /// There is no move assignment operator.
+    multi_channel_batch& operator=(multi_channel_batch<T>&&) = delete;
+
+    /// Destructor.
+    ~multi_channel_batch() = default;
+
+    /// The number of points in this batch.
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// The largest number of points a batch can have. This is the distance between the
+    /// coordinates of two subsequent dimensions.
+    std::size_t capacity() const
+    {
+        return channels_.size();
+    }
+
+    /// The number of random numbers of each point.
+    std::size_t dimensions() const
+    {
+        return points_.size() / channels_.size();
+    }
+
+    /// The number of coordinates of each point.
+    std::size_t map_dimensions() const
+    {
+        return coordinates_.size() / channels_.size();
+    }
+
+    /// Returns a pointer to the random numbers in `dimension` of all points.
+    T const* point(std::size_t dimension) const
+    {
+        return points_.data() + dimension * channels_.size();
+    }
+
+    /// Returns a pointer to the coordinates in `dimension` of all points.
+    T const* coordinates(std::size_t dimension) const
+    {
+        return coordinates_.data() + dimension * channels_.size();
+    }
+
+    /// Returns a pointer to the channels which were selected for all points.
+    std::size_t const* channels() const
+    {
+        return channels_.data();
+    }
+
+private:
+    std::vector<T> const& points_;
+    std::vector<T> const& coordinates_;
+    std::vector<std::size_t> const& channels_;
+    std::size_t size_;
+};
+
+/// @}
+
+}
+
+#endif
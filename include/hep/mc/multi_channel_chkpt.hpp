@@ -23,12 +23,17 @@
 #include "hep/mc/multi_channel_refine_weights.hpp"
 #include "hep/mc/multi_channel_result.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <iomanip>
 #include <ios>
+#include <istream>
 #include <limits>
+#include <numeric>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace hep
@@ -37,9 +42,11 @@ namespace hep
 /// \addtogroup checkpoints
 /// @{
 
-/// Class capturing the complete internal state of the \ref multi_channel_group.
-template <typename T>
-class multi_channel_chkpt : public chkpt<multi_channel_result<T>>
+/// Class capturing the complete internal state of the \ref multi_channel_group. The type `Result`
+/// is the type of the results of each iteration, which must be \ref multi_channel_result or derived
+/// from it.
+template <typename T, typename Result = multi_channel_result<T>>
+class multi_channel_chkpt : public chkpt<Result>
 {
 public:
     /// Constructor. Do not use directly, but instead use \ref make_multi_channel_chkpt.
@@ -61,7 +68,7 @@ public:
     /// Deserialization constructor. Do not use directly, but instead use \ref
     /// make_multi_channel_chkpt.
     explicit multi_channel_chkpt(std::istream& in)
-        : chkpt<multi_channel_result<T>>{in}
+        : chkpt<Result>{in}
     {
         in >> beta_ >> min_weight_;
 
@@ -78,6 +85,55 @@ public:
                 first_channel_weights_.push_back(weight);
             }
         }
+
+        // the pruning state is only written if pruning was enabled
+        in >> std::ws;
+
+        if (in.peek() == 'p')
+        {
+            std::string keyword;
+            std::size_t channels = 0;
+            in >> keyword >> prune_threshold_ >> prune_iterations_ >> channels;
+
+            pruned_.resize(channels);
+            below_threshold_.resize(channels);
+
+            for (auto& iteration : pruned_)
+            {
+                in >> iteration;
+            }
+
+            for (auto& iterations : below_threshold_)
+            {
+                in >> iterations;
+            }
+        }
+    }
+
+    /// Deserialization constructor for the binary format. Do not use directly, but instead use
+    /// \ref load_chkpt.
+    explicit multi_channel_chkpt(binary_reader& in)
+        : chkpt<Result>{in}
+        , beta_(in.read<T>())
+        , min_weight_(in.read<T>())
+    {
+        if (this->results().empty())
+        {
+            first_channel_weights_ = in.read_vector<T>();
+        }
+
+        if ((in.version() >= 3) && (in.read<std::uint8_t>() != 0))
+        {
+            prune_threshold_ = in.read<T>();
+            prune_iterations_ = in.read_size();
+
+            // sizes are always written with 64 bits
+            auto const pruned = in.read_vector<std::uint64_t>();
+            auto const below_threshold = in.read_vector<std::uint64_t>();
+
+            pruned_.assign(pruned.begin(), pruned.end());
+            below_threshold_.assign(below_threshold.begin(), below_threshold.end());
+        }
     }
 
     /// Returns the channel weights for the next iteration.
@@ -90,8 +146,33 @@ public:
             return first_channel_weights_;
         }
 
-        return multi_channel_refine_weights(results.back().channel_weights(),
+        auto weights = multi_channel_refine_weights(results.back().channel_weights(),
             results.back().adjustment_data(), min_weight_, beta_);
+
+        // disable the channels that were pruned after the last iteration; the ones pruned before
+        // already have a weight of zero, which the refinement keeps
+        bool changed = false;
+
+        for (std::size_t i = 0; i != pruned_.size(); ++i)
+        {
+            if ((pruned_[i] != 0) && (weights[i] != T()))
+            {
+                weights[i] = T();
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            T const sum = std::accumulate(weights.begin(), weights.end(), T());
+
+            for (auto& weight : weights)
+            {
+                weight /= sum;
+            }
+        }
+
+        return weights;
     }
 
     /// Sets the number of channels.
@@ -120,9 +201,57 @@ public:
         return min_weight_;
     }
 
+    /// Returns the threshold below which channels are pruned, see \ref pruning.
+    T prune_threshold() const
+    {
+        return prune_threshold_;
+    }
+
+    /// Returns the number of iterations a channel must be below the threshold to be pruned, see
+    /// \ref pruning.
+    std::size_t prune_iterations() const
+    {
+        return prune_iterations_;
+    }
+
+    /// Enables the pruning of channels. If the contribution of an enabled channel \f$ i \f$ to
+    /// the variance, \f$ \alpha_i W_i / \sum_j \alpha_j W_j \f$, where \f$ \alpha_i \f$ is its
+    /// weight and \f$ W_i \f$ its adjustment data, see \ref multi_channel_refine_weights, is
+    /// smaller than `threshold` in `iterations` consecutive iterations, the channel is disabled
+    /// by setting its weight to zero for all following iterations. The map then no longer has to
+    /// calculate its density, see \ref multi_channel_iteration. The channel with the largest
+    /// contribution is never pruned. A `threshold` of zero, the default, disables pruning. The
+    /// decisions are stored in the checkpoint, so that resumed integrations prune the same
+    /// channels; a \ref rollback makes them again with the current parameters.
+    void pruning(T threshold, std::size_t iterations = 1)
+    {
+        prune_threshold_ = threshold;
+        prune_iterations_ = std::max(iterations, std::size_t(1));
+    }
+
+    /// Returns for each channel the number of iterations after which it was pruned, or zero if it
+    /// is not pruned. The vector is empty before the first iteration.
+    std::vector<std::size_t> const& pruned() const
+    {
+        return pruned_;
+    }
+
+    void rollback(std::size_t iteration) override
+    {
+        chkpt<Result>::rollback(iteration);
+
+        pruned_.clear();
+        below_threshold_.clear();
+
+        for (std::size_t i = 0; i != this->results().size(); ++i)
+        {
+            prune(this->results().at(i), i + 1);
+        }
+    }
+
     void serialize(std::ostream& out) const override
     {
-        chkpt<multi_channel_result<T>>::serialize(out);
+        chkpt<Result>::serialize(out);
 
         out << '\n' << std::scientific
             << std::setprecision(std::numeric_limits<T>::max_digits10 - 1) << beta_ << ' '
@@ -138,12 +267,129 @@ public:
                     << std::setprecision(std::numeric_limits<T>::max_digits10 - 1) << weight;
             }
         }
+
+        if (store_pruning())
+        {
+            out << "\npruning " << prune_threshold_ << ' ' << prune_iterations_ << ' '
+                << pruned_.size();
+
+            for (auto const iteration : pruned_)
+            {
+                out << ' ' << iteration;
+            }
+
+            for (auto const iterations : below_threshold_)
+            {
+                out << ' ' << iterations;
+            }
+        }
+    }
+
+    void serialize(binary_writer& out) const override
+    {
+        chkpt<Result>::serialize(out);
+        out.write(beta_);
+        out.write(min_weight_);
+
+        if (this->results().empty())
+        {
+            out.write(first_channel_weights_);
+        }
+
+        out.write(static_cast <std::uint8_t> (store_pruning() ? 1 : 0));
+
+        if (store_pruning())
+        {
+            out.write(prune_threshold_);
+            out.write_size(prune_iterations_);
+            out.write(std::vector<std::uint64_t>(pruned_.begin(), pruned_.end()));
+            out.write(std::vector<std::uint64_t>(below_threshold_.begin(),
+                below_threshold_.end()));
+        }
+    }
+
+protected:
+    /// Appends `result` and decides which channels are pruned, see \ref pruning.
+    void add_result(Result const& result)
+    {
+        chkpt<Result>::add_result(result);
+        prune(result, this->results().size());
     }
 
 private:
+    // Updates the pruning decisions with `result`, which is the result with index `iteration - 1`
+    void prune(Result const& result, std::size_t iteration)
+    {
+        auto const& weights = result.channel_weights();
+        auto const& adjustment_data = result.adjustment_data();
+        std::size_t const channels = weights.size();
+
+        pruned_.resize(channels);
+        below_threshold_.resize(channels);
+
+        if (prune_threshold_ <= T())
+        {
+            return;
+        }
+
+        T total = T();
+        std::size_t largest = 0;
+
+        for (std::size_t i = 0; i != channels; ++i)
+        {
+            T const contribution = weights[i] * adjustment_data[i];
+            total += contribution;
+
+            if (contribution > weights[largest] * adjustment_data[largest])
+            {
+                largest = i;
+            }
+        }
+
+        // without any non-zero calls there is nothing to compare with
+        if (total <= T())
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i != channels; ++i)
+        {
+            if ((weights[i] == T()) || (pruned_[i] != 0))
+            {
+                continue;
+            }
+
+            if ((i != largest) && (weights[i] * adjustment_data[i] < prune_threshold_ * total))
+            {
+                if (++below_threshold_[i] >= prune_iterations_)
+                {
+                    pruned_[i] = iteration;
+                }
+            }
+            else
+            {
+                below_threshold_[i] = 0;
+            }
+        }
+    }
+
+    bool store_pruning() const
+    {
+        return (prune_threshold_ > T()) || std::any_of(pruned_.begin(), pruned_.end(),
+            [](std::size_t iteration) { return iteration != 0; });
+    }
+
     T beta_;
     T min_weight_;
     std::vector<T> first_channel_weights_;
+    T prune_threshold_ = T();
+    std::size_t prune_iterations_ = 1;
+
+    // the number of iterations after which each channel was pruned, zero if it is enabled
+    std::vector<std::size_t> pruned_;
+
+    // the number of consecutive iterations each channel has been below the threshold
+    std::vector<std::size_t> below_threshold_;
 };
 
 /// Multi channel checkpoint with random number generators.
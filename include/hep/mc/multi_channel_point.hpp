@@ -21,6 +21,7 @@
 
 #include "hep/mc/mc_point.hpp"
 #include "hep/mc/multi_channel_map.hpp"
+#include "hep/mc/sparse_densities.hpp"
 
 #include <cstddef>
 #include <vector>
@@ -82,26 +83,31 @@ private:
 };
 
 /// Point in the unit-hypercube for multi-channel Monte Carlo integration. This type also captures
-/// the map that is used to generate `coordinates`.
+/// the map that is used to generate `coordinates`. The densities are a `std::vector<T>`, or \ref
+/// sparse_densities if the map was created with \ref make_sparse_map.
 template <typename T, typename M>
 class multi_channel_point2 : public multi_channel_point<T>
 {
 public:
-    /// Constructor.
+    /// Constructor. The weight of the point is additionally multiplied with `factor`, which is
+    /// used by \ref multi_channel_vegas_iteration to include the weight of the VEGAS grid of the
+    /// selected channel.
     multi_channel_point2(
         std::vector<T> const& point,
         std::vector<T>& coordinates,
         std::size_t channel,
-        std::vector<T>& densities,
+        multi_channel_densities<T, M>& densities,
         std::vector<T> const& channel_weights,
         std::vector<std::size_t> const& enabled_channels,
-        M& map
+        M& map,
+        T factor = T(1.0)
     )
         : multi_channel_point<T>(point, T(), coordinates, channel)
         , densities_(densities)
         , channel_weights_(channel_weights)
         , enabled_channels_(enabled_channels)
         , map_(map)
+        , factor_(factor)
     {
     }
 
@@ -117,6 +123,8 @@ public:
     {
         if (this->weight_ == T())
         {
+            multi_channel_clear_densities(densities_);
+
             // lazy evaluation of the jacobian of `map` and `densities`
             this->weight_ = map_(
                 this->channel(),
@@ -128,24 +136,19 @@ public:
                 multi_channel_map::calculate_densities
             );
 
-            T total_density = T();
-
-            for (std::size_t j = 0; j != channel_weights_.size(); ++j)
-            {
-                total_density += channel_weights_[j] * densities_[j];
-            }
-
-            this->weight_ /= total_density;
+            this->weight_ /= multi_channel_total_density(densities_, channel_weights_);
+            this->weight_ *= factor_;
         }
 
         return this->weight_;
     }
 
 private:
-    std::vector<T>& densities_;
+    multi_channel_densities<T, M>& densities_;
     std::vector<T> const& channel_weights_;
     std::vector<std::size_t> const& enabled_channels_;
     M& map_;
+    T factor_;
 };
 
 /// @}
@@ -69,6 +69,14 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit multi_channel_result(binary_reader& in)
+        : plain_result<T>(in)
+        , adjustment_data_(in.read_vector<T>())
+        , channel_weights_(in.read_vector<T>())
+    {
+    }
+
     /// Copy constructor.
     multi_channel_result(multi_channel_result<T> const&) = default;
 
@@ -112,6 +120,14 @@ public:
         }
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const override
+    {
+        plain_result<T>::serialize(out);
+        out.write(adjustment_data_);
+        out.write(channel_weights_);
+    }
+
     static char const* result_name()
     {
         return "multi_channel_result";
@@ -19,8 +19,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "hep/mc/multi_channel_chkpt.hpp"
 #include "hep/mc/multi_channel_max_difference.hpp"
+#include "hep/mc/multi_channel_result.hpp"
 #include "hep/mc/multi_channel_weight_info.hpp"
 
 #include <cstddef>
@@ -77,11 +77,10 @@ inline std::string make_list_of_ranges(std::vector<std::size_t> const& indices)
 }
 
 template <typename T>
-inline void multi_channel_summary(multi_channel_chkpt<T> const& chkpt, std::ostream& out)
+inline void multi_channel_summary(multi_channel_result<T> const& result, std::ostream& out)
 {
-    auto const& results = chkpt.results();
-    T const max_difference = multi_channel_max_difference(results.back());
-    multi_channel_weight_info<T> info(results.back());
+    T const max_difference = multi_channel_max_difference(result);
+    multi_channel_weight_info<T> info(result);
     std::size_t const channels = info.channels().size();
     std::size_t const min_channels = info.minimal_weight_count();
 
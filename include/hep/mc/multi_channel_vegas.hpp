@@ -0,0 +1,214 @@
+#ifndef HEP_MC_MULTI_CHANNEL_VEGAS_HPP
+#define HEP_MC_MULTI_CHANNEL_VEGAS_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/accumulator.hpp"
+#include "hep/mc/callback.hpp"
+#include "hep/mc/discrete_distribution.hpp"
+#include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/multi_channel.hpp"
+#include "hep/mc/multi_channel_map.hpp"
+#include "hep/mc/multi_channel_point.hpp"
+#include "hep/mc/multi_channel_result.hpp"
+#include "hep/mc/multi_channel_vegas_chkpt.hpp"
+#include "hep/mc/multi_channel_vegas_result.hpp"
+#include "hep/mc/uniform_random.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup multi_channel_group
+/// @{
+
+/// Performs one iteration of the multi channel integrator with a separate VEGAS grid for each
+/// channel. For each point a channel \f$ i \f$ is selected according to `channel_weights` and
+/// the random numbers are mapped with `pdfs[i]` before they are passed to the map of
+/// `integrand`, see \ref multi_channel_iteration. The weight of the point is the weight of the
+/// multi channel integrator multiplied with the weight of the VEGAS grid of the channel \f$ i \f$.
+/// This can be understood as splitting the integrand into the parts
+/// \f$ \alpha_i p_i ( \vec{y} ) f ( \vec{y} ) / p ( \vec{y} ) \f$, each of which is integrated
+/// with VEGAS in the channel \f$ i \f$, and therefore the map does not have to provide the
+/// inverse of each channel. The random numbers are drawn in the same order as for \ref
+/// multi_channel_iteration, and the channels are selected with the policy `Selection`.
+template <typename Selection = cumulative_selection, typename I, typename R>
+inline multi_channel_vegas_result<numeric_type_of<I>> multi_channel_vegas_iteration(
+    I&& integrand,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    std::vector<vegas_pdf<numeric_type_of<I>>> const& pdfs,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+
+    assert( pdfs.size() == channel_weights.size() );
+
+    std::size_t const channels   = channel_weights.size();
+    std::size_t const dimensions = integrand.dimensions();
+
+    auto accumulator = make_accumulator(integrand);
+
+    std::vector<T> adjustment_data(channels);
+    std::vector<std::vector<T>> pdf_adjustment_data(channels);
+
+    for (std::size_t i = 0; i != channels; ++i)
+    {
+        pdf_adjustment_data[i].resize(pdfs[i].bins() * pdfs[i].dimensions());
+    }
+
+    auto const enabled_channels = multi_channel_enabled_channels(channel_weights);
+
+    // distribution that randomly selects a channel
+    discrete_distribution<std::size_t, T, Selection> const channel_selector(
+        channel_weights.begin(), channel_weights.end());
+
+    std::vector<T> random_numbers(dimensions);
+    std::vector<std::size_t> bin(dimensions);
+    using map_type = typename std::remove_reference<
+        typename std::remove_reference<I>::type::map_type>::type;
+
+    std::vector<T> coordinates(integrand.map_dimensions());
+    auto densities = make_multi_channel_densities<T, map_type>(channels);
+
+    for (std::size_t i = 0; i != calls; ++i)
+    {
+        generate_uniform(generator, random_numbers.data(), random_numbers.data() + dimensions);
+
+        std::size_t const channel = channel_selector(generator);
+
+        auto const& pdf = pdfs[channel];
+        std::size_t const bins = pdf.bins();
+
+        // map the random numbers with the grid of the selected channel
+        T const vegas_weight = vegas_icdf(pdf, random_numbers, bin);
+
+        multi_channel_clear_densities(densities);
+
+        integrand.map()(
+            channel,
+            random_numbers,
+            coordinates,
+            enabled_channels,
+            densities,
+            multi_channel_map::calculate_coordinates
+        );
+
+        multi_channel_point2<T, map_type> const point(
+            random_numbers,
+            coordinates,
+            channel,
+            densities,
+            channel_weights,
+            enabled_channels,
+            integrand.map(),
+            vegas_weight
+        );
+
+        T const value = accumulator.invoke(integrand, point);
+
+        if (value == T())
+        {
+            continue;
+        }
+
+        T const square = value * value;
+
+        // the grid of the selected channel is adapted to its part of the integrand
+        for (std::size_t j = 0; j != dimensions; ++j)
+        {
+            pdf_adjustment_data[channel][j * bins + bin[j]] += square;
+        }
+
+        // the channel weights are adapted as in `multi_channel_iteration`, which multiplies the
+        // square with the weight of the point. The square is the contribution of this point to the
+        // variance and therefore contains the squared weight of the grid, but the additional
+        // weight comes from the derivative of the variance with respect to the channel weights,
+        // i.e. the weight of the map divided by the total density, which must not contain it
+        T const channel_square = square * point.weight() / vegas_weight;
+
+        multi_channel_adjust(adjustment_data, densities, channel_square);
+    }
+
+    return multi_channel_vegas_result<T>(
+        multi_channel_result<T>(accumulator.result(calls), adjustment_data, channel_weights),
+        pdfs,
+        pdf_adjustment_data
+    );
+}
+
+/// Multi channel integrator with a separate VEGAS grid for each channel. Integrates `integrand`
+/// using `iteration_calls.size()` iterations, with the number of calls for each iteration given in
+/// `iteration_calls`. After each iteration both the channel weights and the grids of the channels
+/// are refined, see \ref multi_channel_vegas_iteration. The integration starts from the default
+/// (empty) checkpoint, unless one is explicitly given in `chkpt`, see \ref
+/// make_multi_channel_vegas_chkpt. After each successful iteration the `callback` function is
+/// invoked. Batch integrands are not supported.
+///
+/// \see checkpoints
+/// \see integrands
+/// \see callbacks
+template <typename Selection = cumulative_selection, typename I,
+    typename Checkpoint = default_multi_channel_vegas_chkpt<numeric_type_of<I>>,
+    typename Callback = callback<Checkpoint>>
+inline Checkpoint multi_channel_vegas(
+    I&& integrand,
+    std::vector<std::size_t> const& iteration_calls,
+    Checkpoint chkpt = make_multi_channel_vegas_chkpt<numeric_type_of<I>>(),
+    Callback callback = hep::callback<Checkpoint>()
+) {
+    chkpt.channels(integrand.channels());
+    chkpt.dimensions(integrand.dimensions());
+
+    auto generator = chkpt.generator();
+    stopwatch wall_time;
+
+    for (auto const calls : iteration_calls)
+    {
+        auto const& weights = chkpt.channel_weights();
+        auto const& pdfs = chkpt.pdfs();
+        stopwatch integrand_time;
+        auto const& result = multi_channel_vegas_iteration<Selection>(integrand, calls, weights,
+            pdfs, generator);
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
+
+        if (!callback(chkpt))
+        {
+            break;
+        }
+
+        wall_time.restart();
+    }
+
+    return chkpt;
+}
+
+/// @}
+
+}
+
+#endif
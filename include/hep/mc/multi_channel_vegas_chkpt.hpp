@@ -0,0 +1,262 @@
+#ifndef HEP_MC_MULTI_CHANNEL_VEGAS_CHKPT_HPP
+#define HEP_MC_MULTI_CHANNEL_VEGAS_CHKPT_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/chkpt.hpp"
+#include "hep/mc/multi_channel_chkpt.hpp"
+#include "hep/mc/multi_channel_vegas_result.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup checkpoints
+/// @{
+
+/// Checkpoints created by \ref multi_channel_vegas. This combines \ref multi_channel_chkpt, which
+/// determines the channel weights, with the parameters of \ref vegas_chkpt, which determine the
+/// \ref vegas_pdf of each channel.
+template <typename T>
+class multi_channel_vegas_chkpt : public multi_channel_chkpt<T, multi_channel_vegas_result<T>>
+{
+public:
+    /// Constructor. Do not use directly, but instead use \ref make_multi_channel_vegas_chkpt.
+    multi_channel_vegas_chkpt(std::size_t bins, T alpha, T min_weight, T beta)
+        : multi_channel_chkpt<T, multi_channel_vegas_result<T>>{min_weight, beta}
+        , alpha_{alpha}
+        , bins_{bins}
+    {
+    }
+
+    /// Constructor. Do not use directly, but instead use \ref make_multi_channel_vegas_chkpt.
+    multi_channel_vegas_chkpt(
+        std::vector<T> const& channel_weights,
+        std::size_t bins,
+        T alpha,
+        T min_weight,
+        T beta
+    )
+        : multi_channel_chkpt<T, multi_channel_vegas_result<T>>{channel_weights, min_weight, beta}
+        , alpha_{alpha}
+        , bins_{bins}
+    {
+    }
+
+    /// Deserialization constructor. Do not use directly, but instead use \ref
+    /// make_multi_channel_vegas_chkpt.
+    explicit multi_channel_vegas_chkpt(std::istream& in)
+        : multi_channel_chkpt<T, multi_channel_vegas_result<T>>{in}
+    {
+        in >> alpha_ >> bins_;
+
+        if (this->results().empty())
+        {
+            std::size_t channels = 0;
+            in >> channels;
+            first_pdfs_.reserve(channels);
+
+            for (std::size_t i = 0; i != channels; ++i)
+            {
+                first_pdfs_.emplace_back(in);
+            }
+        }
+    }
+
+    /// Deserialization constructor for the binary format. Do not use directly, but instead use
+    /// \ref load_chkpt.
+    explicit multi_channel_vegas_chkpt(binary_reader& in)
+        : multi_channel_chkpt<T, multi_channel_vegas_result<T>>{in}
+        , alpha_(in.read<T>())
+        , bins_(in.read_size())
+    {
+        if (this->results().empty())
+        {
+            std::size_t const channels = in.read_size();
+            first_pdfs_.reserve(channels);
+
+            for (std::size_t i = 0; i != channels; ++i)
+            {
+                first_pdfs_.emplace_back(in);
+            }
+        }
+    }
+
+    /// Returns the parameter `alpha`, which is used to refine the PDF of each channel after each
+    /// iteration, see \ref vegas_refine_pdf.
+    T alpha() const
+    {
+        return alpha_;
+    }
+
+    /// Sets the number of dimensions of the unit-hypercube each channel samples. This must be
+    /// called after \ref multi_channel_chkpt::channels.
+    void dimensions(std::size_t dimensions)
+    {
+        if (this->results().empty() && first_pdfs_.empty())
+        {
+            first_pdfs_.assign(this->channel_weights().size(), vegas_pdf<T>(dimensions, bins_));
+        }
+
+        assert( this->results().empty() ||
+            (this->results().back().pdfs().front().dimensions() == dimensions) );
+    }
+
+    /// Returns the PDF of each channel for the next iteration. The PDFs of channels that were not
+    /// sampled in the previous iteration are not changed.
+    std::vector<vegas_pdf<T>> pdfs() const
+    {
+        auto const& results = this->results();
+
+        if (results.empty())
+        {
+            return first_pdfs_;
+        }
+
+        auto const& pdfs = results.back().pdfs();
+        auto const& data = results.back().pdf_adjustment_data();
+
+        std::vector<vegas_pdf<T>> new_pdfs;
+        new_pdfs.reserve(pdfs.size());
+
+        for (std::size_t i = 0; i != pdfs.size(); ++i)
+        {
+            bool const sampled = std::any_of(data[i].begin(), data[i].end(), [](T value) {
+                return value != T();
+            });
+
+            new_pdfs.push_back(sampled ? vegas_refine_pdf(pdfs[i], alpha_, data[i]) : pdfs[i]);
+        }
+
+        return new_pdfs;
+    }
+
+    void serialize(std::ostream& out) const override
+    {
+        multi_channel_chkpt<T, multi_channel_vegas_result<T>>::serialize(out);
+
+        out << '\n' << std::scientific
+            << std::setprecision(std::numeric_limits<T>::max_digits10 - 1) << alpha_ << ' '
+            << bins_;
+
+        if (this->results().empty())
+        {
+            out << '\n' << first_pdfs_.size();
+
+            for (auto const& pdf : first_pdfs_)
+            {
+                out << '\n';
+                pdf.serialize(out);
+            }
+        }
+    }
+
+    void serialize(binary_writer& out) const override
+    {
+        multi_channel_chkpt<T, multi_channel_vegas_result<T>>::serialize(out);
+        out.write(alpha_);
+        out.write_size(bins_);
+
+        if (this->results().empty())
+        {
+            out.write_size(first_pdfs_.size());
+
+            for (auto const& pdf : first_pdfs_)
+            {
+                pdf.serialize(out);
+            }
+        }
+    }
+
+private:
+    T alpha_;
+    std::size_t bins_;
+    std::vector<vegas_pdf<T>> first_pdfs_;
+};
+
+/// Checkpoint with random number generators created by \ref multi_channel_vegas.
+template <typename RandomNumberEngine, typename T>
+using multi_channel_vegas_chkpt_with_rng = chkpt_with_rng<RandomNumberEngine,
+    multi_channel_vegas_chkpt<T>>;
+
+/// Creates a checkpoint that can be used to start \ref multi_channel_vegas. The parameters `bins`
+/// and `alpha` are the same as for \ref make_vegas_chkpt and are used for the \ref vegas_pdf of
+/// every channel, the parameters `min_weight` and `beta` are the same as for \ref
+/// make_multi_channel_chkpt.
+template <typename T, typename RandomNumberEngine = std::mt19937>
+multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T> make_multi_channel_vegas_chkpt(
+    std::size_t bins = 128,
+    T alpha = T(1.5),
+    T min_weight = T(),
+    T beta = T(0.25),
+    RandomNumberEngine const& rng = RandomNumberEngine()
+) {
+    return multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T>{rng, bins, alpha, min_weight,
+        beta};
+}
+
+/// Creates a checkpoint that can be used to start \ref multi_channel_vegas with the a-priori
+/// weights given by `channel_weights`.
+template <typename T, typename RandomNumberEngine = std::mt19937>
+multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T> make_multi_channel_vegas_chkpt(
+    std::vector<T> const& channel_weights,
+    std::size_t bins = 128,
+    T alpha = T(1.5),
+    T min_weight = T(),
+    T beta = T(0.25),
+    RandomNumberEngine const& rng = RandomNumberEngine()
+) {
+    return multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T>{rng, channel_weights, bins,
+        alpha, min_weight, beta};
+}
+
+/// Helper function create a checkpoint reading from the stream `in`. The numeric type `T` and
+/// the type of the random number generator `RandomNumberEngine` have to be stated explicitly.
+template <typename T, typename RandomNumberEngine>
+multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T> make_multi_channel_vegas_chkpt(
+    std::istream& in
+) {
+    if (in.peek() == std::istream::traits_type::eof())
+    {
+        return make_multi_channel_vegas_chkpt<T, RandomNumberEngine>();
+    }
+
+    return multi_channel_vegas_chkpt_with_rng<RandomNumberEngine, T>{in};
+}
+
+/// Return type of \ref make_multi_channel_vegas_chkpt with default parameters.
+template <typename T>
+using default_multi_channel_vegas_chkpt = decltype (make_multi_channel_vegas_chkpt<T>());
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef HEP_MC_MULTI_CHANNEL_VEGAS_RESULT_HPP
+#define HEP_MC_MULTI_CHANNEL_VEGAS_RESULT_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/multi_channel_result.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup results
+/// @{
+
+/// The result of a single \ref multi_channel_vegas_iteration. In addition to a \ref
+/// multi_channel_result it stores the \ref vegas_pdf of each channel and the data that is used to
+/// refine them.
+template <typename T>
+class multi_channel_vegas_result : public multi_channel_result<T>
+{
+public:
+    /// Constructor. The vectors `pdfs` and `pdf_adjustment_data` must have one entry for each
+    /// channel.
+    multi_channel_vegas_result(
+        multi_channel_result<T> const& result,
+        std::vector<vegas_pdf<T>> const& pdfs,
+        std::vector<std::vector<T>> const& pdf_adjustment_data
+    )
+        : multi_channel_result<T>(result)
+        , pdfs_(pdfs)
+        , pdf_adjustment_data_(pdf_adjustment_data)
+    {
+        assert( pdfs.size() == result.channel_weights().size() );
+        assert( pdf_adjustment_data.size() == pdfs.size() );
+    }
+
+    /// Deserialization constructor.
+    explicit multi_channel_vegas_result(std::istream& in)
+        : multi_channel_result<T>(in)
+    {
+        std::size_t const channels = this->channel_weights().size();
+
+        pdfs_.reserve(channels);
+        pdf_adjustment_data_.reserve(channels);
+
+        for (std::size_t i = 0; i != channels; ++i)
+        {
+            pdfs_.emplace_back(in);
+            pdf_adjustment_data_.emplace_back(pdfs_.back().bins() * pdfs_.back().dimensions());
+
+            for (auto& value : pdf_adjustment_data_.back())
+            {
+                in >> value;
+            }
+        }
+    }
+
+    /// Deserialization constructor for the binary format.
+    explicit multi_channel_vegas_result(binary_reader& in)
+        : multi_channel_result<T>(in)
+    {
+        std::size_t const channels = this->channel_weights().size();
+
+        pdfs_.reserve(channels);
+        pdf_adjustment_data_.reserve(channels);
+
+        for (std::size_t i = 0; i != channels; ++i)
+        {
+            pdfs_.emplace_back(in);
+            pdf_adjustment_data_.emplace_back(pdfs_.back().bins() * pdfs_.back().dimensions());
+            in.read(pdf_adjustment_data_.back().data(), pdf_adjustment_data_.back().size());
+        }
+    }
+
+    /// Copy constructor.
+    multi_channel_vegas_result(multi_channel_vegas_result<T> const&) = default;
+
+    /// Move constructor.
+    multi_channel_vegas_result(multi_channel_vegas_result<T>&&) noexcept = default;
+
+    /// Assignment operator.
+    multi_channel_vegas_result& operator=(multi_channel_vegas_result<T> const&) = default;
+
+    /// Move assignment operator.
+    multi_channel_vegas_result& operator=(multi_channel_vegas_result<T>&&) noexcept = default;
+
+    /// Destructor.
+    ~multi_channel_vegas_result() override = default;
+
+    /// The PDF of each channel used to obtain this result.
+    std::vector<vegas_pdf<T>> const& pdfs() const
+    {
+        return pdfs_;
+    }
+
+    /// The data used to refine the \ref pdfs for a subsequent iteration. For each channel this has
+    /// the same layout as \ref vegas_result::adjustment_data. For channels that were not sampled
+    /// all entries are zero.
+    std::vector<std::vector<T>> const& pdf_adjustment_data() const
+    {
+        return pdf_adjustment_data_;
+    }
+
+    /// Serializes this object.
+    void serialize(std::ostream& out) const override
+    {
+        multi_channel_result<T>::serialize(out);
+
+        for (std::size_t i = 0; i != pdfs_.size(); ++i)
+        {
+            out << '\n';
+            pdfs_.at(i).serialize(out);
+            out << '\n';
+
+            for (auto const value : pdf_adjustment_data_.at(i))
+            {
+                out << std::scientific
+                    << std::setprecision(std::numeric_limits<T>::max_digits10 - 1) << value << ' ';
+            }
+        }
+    }
+
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const override
+    {
+        multi_channel_result<T>::serialize(out);
+
+        for (std::size_t i = 0; i != pdfs_.size(); ++i)
+        {
+            pdfs_.at(i).serialize(out);
+            out.write(pdf_adjustment_data_.at(i).data(), pdf_adjustment_data_.at(i).size());
+        }
+    }
+
+    static char const* result_name()
+    {
+        return "multi_channel_vegas_result";
+    }
+
+private:
+    std::vector<vegas_pdf<T>> pdfs_;
+    std::vector<std::vector<T>> pdf_adjustment_data_;
+};
+
+/// @}
+
+}
+
+#endif
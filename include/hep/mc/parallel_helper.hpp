@@ -0,0 +1,228 @@
+#ifndef HEP_MC_PARALLEL_HELPER_HPP
+#define HEP_MC_PARALLEL_HELPER_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/accumulator.hpp"
+#include "hep/mc/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hep
+{
+
+/// \cond INTERNAL
+
+// An accumulator together with the data an integrator uses to adapt itself, e.g. the binned squares
+// of VEGAS. Both parts are summed when two objects are merged.
+template <typename A, typename T>
+class chunk_accumulator
+{
+public:
+    chunk_accumulator(A const& accumulator, std::size_t size)
+        : accumulator_(accumulator)
+        , adjustment_data_(size)
+    {
+    }
+
+    A& accumulator()
+    {
+        return accumulator_;
+    }
+
+    A const& accumulator() const
+    {
+        return accumulator_;
+    }
+
+    std::vector<T>& adjustment_data()
+    {
+        return adjustment_data_;
+    }
+
+    std::vector<T> const& adjustment_data() const
+    {
+        return adjustment_data_;
+    }
+
+    void merge(chunk_accumulator<A, T> const& other)
+    {
+        accumulator_.merge(other.accumulator_);
+
+        for (std::size_t i = 0; i != adjustment_data_.size(); ++i)
+        {
+            adjustment_data_[i] += other.adjustment_data_[i];
+        }
+    }
+
+private:
+    A accumulator_;
+    std::vector<T> adjustment_data_;
+};
+
+template <typename I, typename D = typename std::decay<I>::type::numeric_type>
+using chunk_accumulator_type = chunk_accumulator<decltype (make_accumulator(std::declval<I>())),
+    D>;
+
+template <typename I>
+inline chunk_accumulator_type<I> make_chunk_accumulator(I const& integrand, std::size_t size)
+{
+    return chunk_accumulator_type<I>(make_accumulator(integrand), size);
+}
+
+// Creates a chunk whose adjustment data uses the type `D` instead of the numeric type
+template <typename D, typename I>
+inline chunk_accumulator_type<I, D> make_chunk_accumulator(I const& integrand, std::size_t size)
+{
+    return chunk_accumulator_type<I, D>(make_accumulator(integrand), size);
+}
+
+// Returns the number of evaluations each chunk of an iteration with `calls` evaluations has. The
+// size depends only on `calls` so that the results do not depend on the number of threads.
+inline std::size_t parallel_chunk_size(std::size_t calls)
+{
+    // enough chunks to balance the load of many threads, but not so many that merging them costs
+    // more than evaluating them
+    std::size_t const max_chunks = 256;
+    std::size_t const min_chunk_size = 64;
+
+    return std::max(min_chunk_size, (calls + max_chunks - 1) / max_chunks);
+}
+
+// Splits `calls` evaluations into chunks of \ref parallel_chunk_size evaluations, which are
+// processed by the threads of `pool`. For each chunk `sample(integrand, chunk, chunk_calls,
+// chunk_generator)` is called with a thread-local copy of `integrand`, a buffer set to `empty` and
+// a copy of `generator` forwarded to the position the sequential integrator has at the beginning
+// of the chunk. The parameter `usage` must be the number of random numbers drawn by each
+// evaluation. The chunks are merged in their natural order, independently of which thread
+// evaluated them and when, and the merged result is returned. Buffers that have been merged are
+// reused for the next chunks, so that large buffers, e.g. those of distributions, are not
+// allocated for every chunk. Afterwards `generator` is in the same state as if it was used to
+// perform all `calls` evaluations; it is copied from the thread that evaluated the last chunk, so
+// that no random numbers are discarded after the threads finished. Each thread, however, discards
+// the random numbers of the chunks evaluated by the other threads, which for most engines takes a
+// time proportional to their number, see \ref philox4x64 for an engine that avoids this. If `pool`
+// has a single thread, all evaluations are summed into one buffer in a single pass, like the
+// sequential integrators do, instead of resetting and merging a buffer for each chunk.
+template <typename I, typename C, typename R, typename F>
+inline C parallel_sample(
+    thread_pool& pool,
+    I&& integrand,
+    std::size_t calls,
+    std::size_t usage,
+    C const& empty,
+    R& generator,
+    F&& sample
+) {
+    using integrand_type = typename std::decay<I>::type;
+
+    if (pool.size() == 1)
+    {
+        integrand_type local_integrand = integrand;
+        C result = empty;
+
+        sample(local_integrand, result, calls, generator);
+
+        return result;
+    }
+
+    std::size_t const chunk_size = parallel_chunk_size(calls);
+    std::size_t const chunks = (calls + chunk_size - 1) / chunk_size;
+
+    std::atomic<std::size_t> next_chunk{0};
+    std::mutex mutex;
+    std::size_t next_merge = 0;
+    std::map<std::size_t, C> pending;
+    std::vector<C> merged;
+    C result = empty;
+    R last_generator = generator;
+
+    pool.run([&](std::size_t) {
+        integrand_type local_integrand = integrand;
+        R local_generator = generator;
+        std::size_t position = 0;
+
+        C local = empty;
+
+        for (;;)
+        {
+            std::size_t const chunk = next_chunk++;
+
+            if (chunk >= chunks)
+            {
+                break;
+            }
+
+            std::size_t const begin = chunk * chunk_size;
+            std::size_t const chunk_calls = std::min(chunk_size, calls - begin);
+
+            local_generator.discard(usage * (begin - position));
+            position = begin + chunk_calls;
+
+            sample(local_integrand, local, chunk_calls, local_generator);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (chunk == chunks - 1)
+                {
+                    // this generator is at the position after the last evaluation
+                    last_generator = local_generator;
+                }
+
+                pending.emplace(chunk, std::move(local));
+
+                // merge all chunks that are ready in the order of their indices
+                for (auto i = pending.begin(); (i != pending.end()) && (i->first == next_merge);
+                    i = pending.erase(i))
+                {
+                    result.merge(i->second);
+                    merged.push_back(std::move(i->second));
+                    ++next_merge;
+                }
+
+                if (!merged.empty())
+                {
+                    local = std::move(merged.back());
+                    merged.pop_back();
+                }
+            }
+
+            // reset the buffer outside of the lock; this reuses its memory if it was merged before
+            local = empty;
+        }
+    });
+
+    generator = last_generator;
+
+    return result;
+}
+
+/// \endcond
+
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef HEP_MC_PARALLEL_MULTI_CHANNEL_HPP
+#define HEP_MC_PARALLEL_MULTI_CHANNEL_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/callback.hpp"
+#include "hep/mc/discrete_distribution.hpp"
+#include "hep/mc/generator_helper.hpp"
+#include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/multi_channel.hpp"
+#include "hep/mc/multi_channel_chkpt.hpp"
+#include "hep/mc/multi_channel_result.hpp"
+#include "hep/mc/parallel_helper.hpp"
+#include "hep/mc/thread_pool.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup multi_channel_group
+/// @{
+
+/// Multi-threaded version of \ref multi_channel_iteration. The `calls` evaluations are divided into
+/// chunks which are distributed among the threads of `pool` and merged in the order of the chunks.
+/// The result is therefore bitwise identical for any number of threads larger than one and agrees
+/// with the one of \ref multi_channel_iteration up to rounding differences in the summation. A
+/// single thread sums all evaluations in one pass and returns the same result as \ref
+/// multi_channel_iteration. After this function returns `generator` is in the same state as after a
+/// call of \ref multi_channel_iteration.
+template <typename Selection = cumulative_selection, typename I, typename R>
+inline multi_channel_result<numeric_type_of<I>> parallel_multi_channel_iteration(
+    thread_pool& pool,
+    I&& integrand,
+    std::size_t calls,
+    std::vector<numeric_type_of<I>> const& channel_weights,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+    using integrand_type = typename std::decay<I>::type;
+    using chunk_type = chunk_accumulator_type<I>;
+
+    auto const enabled_channels = multi_channel_enabled_channels(channel_weights);
+
+    discrete_distribution<std::size_t, T, Selection> const channel_selector(
+        channel_weights.begin(), channel_weights.end());
+
+    // hep::discrete_distribution consumes as many random numbers as an additional dimension
+    std::size_t const usage = (1 + integrand.dimensions()) * random_number_usage<T, R>();
+
+    auto const result = parallel_sample(pool, integrand, calls, usage,
+        make_chunk_accumulator(integrand, channel_weights.size()), generator,
+        [&](integrand_type& local_integrand, chunk_type& chunk, std::size_t chunk_calls,
+            R& chunk_generator) {
+            multi_channel_sample(local_integrand, chunk.accumulator(), chunk_calls,
+                channel_weights, enabled_channels, channel_selector, chunk_generator,
+                chunk.adjustment_data());
+    });
+
+    return multi_channel_result<T>(result.accumulator().result(calls), result.adjustment_data(),
+        channel_weights);
+}
+
+/// Multi-threaded version of \ref multi_channel, using `threads` threads for each iteration. If
+/// `threads` is zero, the number of hardware threads is used.
+template <typename Selection = cumulative_selection, typename I,
+    typename Checkpoint = default_multi_channel_chkpt<numeric_type_of<I>>,
+    typename Callback = callback<Checkpoint>>
+inline Checkpoint parallel_multi_channel(
+    std::size_t threads,
+    I&& integrand,
+    std::vector<std::size_t> const& iteration_calls,
+    Checkpoint chkpt = make_multi_channel_chkpt<numeric_type_of<I>>(),
+    Callback callback = hep::callback<Checkpoint>()
+) {
+    thread_pool pool(threads);
+
+    chkpt.channels(integrand.channels());
+
+    auto generator = chkpt.generator();
+    stopwatch wall_time;
+
+    for (auto const calls : iteration_calls)
+    {
+        auto const& weights = chkpt.channel_weights();
+        stopwatch integrand_time;
+        auto const& result = parallel_multi_channel_iteration<Selection>(pool, integrand, calls,
+            weights, generator);
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
+
+        if (!callback(chkpt))
+        {
+            break;
+        }
+
+        wall_time.restart();
+    }
+
+    return chkpt;
+}
+
+/// @}
+
+}
+
+#endif
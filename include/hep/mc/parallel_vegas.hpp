@@ -0,0 +1,129 @@
+#ifndef HEP_MC_PARALLEL_VEGAS_HPP
+#define HEP_MC_PARALLEL_VEGAS_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/accumulator.hpp"
+#include "hep/mc/callback.hpp"
+#include "hep/mc/generator_helper.hpp"
+#include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/parallel_helper.hpp"
+#include "hep/mc/storage_policy.hpp"
+#include "hep/mc/thread_pool.hpp"
+#include "hep/mc/vegas.hpp"
+#include "hep/mc/vegas_chkpt.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+#include "hep/mc/vegas_result.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup vegas_group
+/// @{
+
+/// Multi-threaded version of \ref vegas_iteration. The `calls` evaluations are divided into chunks
+/// which are distributed among the threads of `pool`. Each thread evaluates its own copy of
+/// `integrand` and accumulates every chunk into separate buffers, which are merged in the order of
+/// the chunks. Each chunk uses the same random numbers that \ref vegas_iteration would use for the
+/// corresponding evaluations, and after this function returns `generator` is in the same state as
+/// after a call of \ref vegas_iteration. The result is therefore bitwise identical for any number
+/// of threads larger than one. A single thread sums all evaluations in one pass and returns the
+/// same result as \ref vegas_iteration; the results for more threads agree with it up to rounding
+/// differences in the summation. The adjustment data is stored as given by `Storage`.
+template <template <typename> class Storage = storage_policy, typename I, typename R>
+inline vegas_result<numeric_type_of<I>> parallel_vegas_iteration(
+    thread_pool& pool,
+    I&& integrand,
+    std::size_t calls,
+    vegas_pdf<numeric_type_of<I>> const& pdf,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+    using integrand_type = typename std::decay<I>::type;
+    using adjustment_type = typename Storage<T>::adjustment_type;
+    using chunk_type = chunk_accumulator_type<I, adjustment_type>;
+
+    std::size_t const usage = pdf.dimensions() * random_number_usage<T, R>();
+
+    auto const result = parallel_sample(pool, integrand, calls, usage,
+        make_chunk_accumulator<adjustment_type>(integrand, pdf.dimensions() * pdf.bins()),
+        generator,
+        [&](integrand_type& local_integrand, chunk_type& chunk, std::size_t chunk_calls,
+            R& chunk_generator) {
+            vegas_sample(local_integrand, chunk.accumulator(), chunk_calls, pdf, chunk_generator,
+                chunk.adjustment_data());
+    });
+
+    return vegas_result<T>(result.accumulator().result(calls), pdf,
+        storage_cast<T>(result.adjustment_data()));
+}
+
+/// Multi-threaded version of \ref vegas, using `threads` threads for each iteration. If `threads`
+/// is zero, the number of hardware threads is used. Each iteration is performed by \ref
+/// parallel_vegas_iteration, so that the checkpoint returned by this function agrees with the one
+/// returned by \ref vegas up to rounding differences, and is the same for one thread.
+template <template <typename> class Storage = storage_policy, typename I,
+    typename Checkpoint = default_vegas_chkpt<numeric_type_of<I>>,
+    typename Callback = callback<Checkpoint>>
+inline Checkpoint parallel_vegas(
+    std::size_t threads,
+    I&& integrand,
+    std::vector<std::size_t> const& iteration_calls,
+    Checkpoint chkpt = make_vegas_chkpt<numeric_type_of<I>>(),
+    Callback callback = hep::callback<Checkpoint>()
+) {
+    thread_pool pool(threads);
+
+    chkpt.dimensions(integrand.dimensions());
+
+    auto generator = chkpt.generator();
+    stopwatch wall_time;
+
+    // perform iterations
+    for (auto const calls : iteration_calls)
+    {
+        auto const& pdf = chkpt.pdf();
+        stopwatch integrand_time;
+        auto const& result = parallel_vegas_iteration<Storage>(pool, integrand, calls, pdf,
+            generator);
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
+
+        if (!callback(chkpt))
+        {
+            break;
+        }
+
+        wall_time.restart();
+    }
+
+    return chkpt;
+}
+
+/// @}
+
+}
+
+#endif
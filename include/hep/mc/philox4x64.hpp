@@ -0,0 +1,254 @@
+#ifndef HEP_MC_PHILOX4X64_HPP
+#define HEP_MC_PHILOX4X64_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/uniform_random.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace hep
+{
+
+/// \addtogroup random_numbers_group
+/// @{
+
+/// The counter-based random number engine Philox4x64-10 by Salmon et al. \cite Philox, which
+/// satisfies the requirements of a `RandomNumberEngine`. The \f$ n \f$-th block of four 64-bit
+/// integers is obtained by encrypting the 256-bit counter \f$ n \f$ with the key given by the seed
+/// using ten rounds of a bijection. Therefore \ref discard runs in constant time, which makes this
+/// engine well suited for the parallel and the MPI integrators, which discard the random numbers
+/// used by the other threads or processes. Floating-point numbers are generated with the fast
+/// conversion, see \ref fast_uniform_conversion.
+class philox4x64
+{
+public:
+    /// The type of the generated integers.
+    using result_type = std::uint64_t;
+
+    /// The seed used by the default constructor.
+    static constexpr result_type default_seed = 0;
+
+    /// The smallest integer generated by this engine.
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    /// The largest integer generated by this engine.
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /// Constructor. Seeds the engine with `value`, see \ref seed.
+    explicit philox4x64(result_type value = default_seed)
+    {
+        seed(value);
+    }
+
+    /// Uses `value` as the key and resets the counter to zero. Different keys generate
+    /// independent sequences.
+    void seed(result_type value = default_seed)
+    {
+        key_ = {{ value, 0 }};
+        counter_ = {{ 0, 0, 0, 0 }};
+        index_ = 0;
+        generate();
+    }
+
+    /// Generates the next integer.
+    result_type operator()()
+    {
+        result_type const result = block_[index_];
+
+        // always keep the block of the next integer so that the state is unique
+        if (++index_ == block_size)
+        {
+            increment(1);
+            generate();
+            index_ = 0;
+        }
+
+        return result;
+    }
+
+    /// Advances the state by `n` steps in constant time.
+    void discard(unsigned long long n)
+    {
+        unsigned long long const position = index_ + n;
+
+        if (position >= block_size)
+        {
+            increment(position / block_size);
+            generate();
+        }
+
+        index_ = position % block_size;
+    }
+
+    /// Returns `true` if both engines generate the same sequence.
+    friend bool operator==(philox4x64 const& a, philox4x64 const& b)
+    {
+        return (a.key_ == b.key_) && (a.counter_ == b.counter_) && (a.index_ == b.index_);
+    }
+
+    /// Returns `true` if the engines generate different sequences.
+    friend bool operator!=(philox4x64 const& a, philox4x64 const& b)
+    {
+        return !(a == b);
+    }
+
+    /// Writes the key, the counter and the position inside the current block of `engine` to
+    /// `out`.
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>& operator<<(
+        std::basic_ostream<CharT, Traits>& out,
+        philox4x64 const& engine
+    ) {
+        out << engine.key_[0] << ' ' << engine.key_[1];
+
+        for (auto const word : engine.counter_)
+        {
+            out << ' ' << word;
+        }
+
+        out << ' ' << engine.index_;
+
+        return out;
+    }
+
+    /// Reads the state of `engine` from `in`.
+    template <typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>& operator>>(
+        std::basic_istream<CharT, Traits>& in,
+        philox4x64& engine
+    ) {
+        in >> engine.key_[0] >> engine.key_[1];
+
+        for (auto& word : engine.counter_)
+        {
+            in >> word;
+        }
+
+        in >> engine.index_;
+        engine.generate();
+
+        return in;
+    }
+
+private:
+    static constexpr std::size_t block_size = 4;
+
+    // calculates the high and the low 64 bits of the product of `a` and `b`
+    static void multiply(result_type a, result_type b, result_type& high, result_type& low)
+    {
+#ifdef __SIZEOF_INT128__
+        __extension__ typedef unsigned __int128 uint128;
+
+        uint128 const product = uint128(a) * uint128(b);
+
+        high = result_type(product >> 64);
+        low = result_type(product);
+#else
+        result_type const mask = UINT64_C(0xffffffff);
+        result_type const a0 = a & mask;
+        result_type const a1 = a >> 32;
+        result_type const b0 = b & mask;
+        result_type const b1 = b >> 32;
+
+        result_type const p00 = a0 * b0;
+        result_type const p01 = a0 * b1;
+        result_type const p10 = a1 * b0;
+        result_type const p11 = a1 * b1;
+
+        result_type const middle = (p00 >> 32) + (p01 & mask) + (p10 & mask);
+
+        high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+        low = a * b;
+#endif
+    }
+
+    void increment(unsigned long long n)
+    {
+        counter_[0] += n;
+
+        // propagate the carry
+        if (counter_[0] < n)
+        {
+            for (std::size_t i = 1; i != counter_.size(); ++i)
+            {
+                if (++counter_[i] != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    void generate()
+    {
+        std::array<result_type, 4> x = counter_;
+        std::array<result_type, 2> k = key_;
+
+        for (std::size_t round = 0; round != 10; ++round)
+        {
+            if (round != 0)
+            {
+                k[0] += UINT64_C(0x9e3779b97f4a7c15);
+                k[1] += UINT64_C(0xbb67ae8584caa73b);
+            }
+
+            result_type high0;
+            result_type low0;
+            result_type high1;
+            result_type low1;
+
+            multiply(UINT64_C(0xd2e7470ee14c6c93), x[0], high0, low0);
+            multiply(UINT64_C(0xca5a826395121157), x[2], high1, low1);
+
+            x = {{ high1 ^ x[1] ^ k[0], low1, high0 ^ x[3] ^ k[1], low0 }};
+        }
+
+        block_ = x;
+    }
+
+    std::array<result_type, 2> key_;
+    std::array<result_type, 4> counter_;
+    std::array<result_type, 4> block_;
+    std::size_t index_;
+};
+
+/// Enables the fast conversion to floating-point numbers for \ref philox4x64.
+template <>
+struct fast_uniform_conversion<philox4x64> : std::true_type
+{
+};
+
+/// @}
+
+}
+
+#endif
@@ -21,35 +21,38 @@
 
 #include "hep/mc/accumulator.hpp"
 #include "hep/mc/callback.hpp"
+#include "hep/mc/batch_integrand.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/mc_batch.hpp"
 #include "hep/mc/mc_point.hpp"
 #include "hep/mc/plain_chkpt.hpp"
 #include "hep/mc/plain_result.hpp"
+#include "hep/mc/uniform_random.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace hep
 {
 
-/// \addtogroup plain_group
-/// @{
+/// \cond INTERNAL
 
-/// Performs exactly one iteration using the PLAIN Monte Carlo integration algorithm.
-template <typename I, typename R>
-inline plain_result<numeric_type_of<I>> plain_iteration(
-    I&& integrand,
+// Evaluates an integrand created with \ref make_integrand point by point.
+template <typename I, typename A, typename R>
+inline void plain_sample(
+    I& integrand,
+    A& accumulator,
     std::size_t calls,
-    R& generator
+    R& generator,
+    std::false_type
 ) {
     using T = numeric_type_of<I>;
 
-    // the accumulator takes care of the actual evaluation of the integrand and the generation of
-    // possible distribution(s)
-    auto accumulator = make_accumulator(integrand);
-
     // storage for random numbers
     std::vector<T> random_numbers(integrand.dimensions());
 
@@ -57,11 +60,8 @@ inline plain_result<numeric_type_of<I>> plain_iteration(
     for (std::size_t i = 0; i != calls; ++i)
     {
         // fill container with random numbers
-        for (std::size_t j = 0; j != integrand.dimensions(); ++j)
-        {
-            random_numbers[j] = std::generate_canonical<T,
-                std::numeric_limits<T>::digits>(generator);
-        }
+        generate_uniform(generator, random_numbers.data(), random_numbers.data() +
+            random_numbers.size());
 
         mc_point<T> const point(random_numbers);
 
@@ -69,6 +69,75 @@ inline plain_result<numeric_type_of<I>> plain_iteration(
         // requested, take care of them as well
         accumulator.invoke(integrand, point);
     }
+}
+
+// Evaluates an integrand created with \ref make_batch_integrand. The random numbers are drawn in
+// the same order as for the point-by-point evaluation.
+template <typename I, typename A, typename R>
+inline void plain_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    R& generator,
+    std::true_type
+) {
+    using T = numeric_type_of<I>;
+
+    std::size_t const dimensions = integrand.dimensions();
+    std::size_t const capacity = batch_capacity(integrand, calls);
+
+    std::vector<T> random_numbers(dimensions * capacity);
+    std::vector<T> points(dimensions * capacity);
+    std::vector<T> const weights(capacity, T(1.0));
+    std::vector<T> values(capacity);
+
+    for (std::size_t i = 0; i < calls; i += capacity)
+    {
+        std::size_t const size = std::min(capacity, calls - i);
+
+        batch_generate_points(generator, size, capacity, random_numbers, points);
+
+        mc_batch<T> const batch(points, weights, size);
+
+        std::fill(values.begin(), values.end(), T());
+        integrand.function()(batch, values);
+
+        for (std::size_t j = 0; j != size; ++j)
+        {
+            if (values[j] != T())
+            {
+                accumulator.add(values[j]);
+            }
+        }
+    }
+}
+
+// Performs `calls` evaluations of `integrand` at uniformly distributed points and adds them to
+// `accumulator`. This is the loop of \ref plain_iteration, which is shared with the parallel
+// integrators.
+template <typename I, typename A, typename R>
+inline void plain_sample(I& integrand, A& accumulator, std::size_t calls, R& generator)
+{
+    plain_sample(integrand, accumulator, calls, generator, batch_tag_of<I>());
+}
+
+/// \endcond
+
+/// \addtogroup plain_group
+/// @{
+
+/// Performs exactly one iteration using the PLAIN Monte Carlo integration algorithm.
+template <typename I, typename R>
+inline plain_result<numeric_type_of<I>> plain_iteration(
+    I&& integrand,
+    std::size_t calls,
+    R& generator
+) {
+    // the accumulator takes care of the actual evaluation of the integrand and the generation of
+    // possible distribution(s)
+    auto accumulator = make_accumulator(integrand);
+
+    plain_sample(integrand, accumulator, calls, generator);
 
     return accumulator.result(calls);
 }
@@ -84,18 +153,23 @@ inline Checkpoint plain(
     Callback callback = hep::callback<Checkpoint>()
 ) {
     auto generator = chkpt.generator();
+    stopwatch wall_time;
 
     // perform iterations
     for (auto const calls : iteration_calls)
     {
+        stopwatch integrand_time;
         auto const result = plain_iteration(integrand, calls, generator);
 
-        chkpt.add(result, generator);
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
 
         if (!callback(chkpt))
         {
             break;
         }
+
+        wall_time.restart();
     }
 
     return chkpt;
@@ -66,6 +66,20 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit plain_result(binary_reader& in)
+        : mc_result<T>(in)
+    {
+        std::size_t const size = in.read_size();
+
+        distributions_.reserve(size);
+
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            distributions_.emplace_back(in);
+        }
+    }
+
     /// Copy constructor.
     plain_result(plain_result<T> const&) = default;
 
@@ -100,6 +114,18 @@ public:
         }
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const override
+    {
+        mc_result<T>::serialize(out);
+        out.write_size(distributions_.size());
+
+        for (auto const& distribution : distributions_)
+        {
+            distribution.serialize(out);
+        }
+    }
+
     static char const* result_name()
     {
         return "plain_result";
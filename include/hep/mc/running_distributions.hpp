@@ -0,0 +1,185 @@
+#ifndef HEP_MC_RUNNING_DISTRIBUTIONS_HPP
+#define HEP_MC_RUNNING_DISTRIBUTIONS_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/distribution_parameters.hpp"
+#include "hep/mc/distribution_result.hpp"
+#include "hep/mc/mc_result.hpp"
+#include "hep/mc/plain_result.hpp"
+#include "hep/mc/running_statistics.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup results
+/// @{
+
+/// Combines the results of many iterations, including their distributions, by weighting each
+/// result and each bin with its inverse variance. The results are added one after another and only
+/// the sums of each bin are kept, in a single array for all distributions, so that the memory and
+/// the time needed are independent of the number of iterations. The combined result is the same
+/// that \ref accumulate computes with \ref weighted_with_variance, which uses this class.
+template <typename T>
+class running_distributions
+{
+public:
+    /// Numeric type used for the sums.
+    using numeric_type = T;
+
+    /// Constructor. Creates an object without any results.
+    running_distributions() = default;
+
+    /// Adds `result` and its distributions. Throws `std::invalid_argument` if the distributions
+    /// of `result` have different numbers of bins than the ones of the results added before.
+    void add(plain_result<T> const& result)
+    {
+        auto const& distributions = result.distributions();
+
+        if (statistics_.iterations() == 0)
+        {
+            initialize(distributions);
+        }
+        else if (!same_bins(distributions))
+        {
+            throw std::invalid_argument("distributions of `result` have different bins");
+        }
+
+        statistics_.add(result);
+
+        std::size_t bin = 0;
+
+        for (auto const& distribution : distributions)
+        {
+            for (auto const& bin_result : distribution.results())
+            {
+                counters_[3 * bin + 0] += bin_result.calls();
+                counters_[3 * bin + 1] += bin_result.non_zero_calls();
+                counters_[3 * bin + 2] += bin_result.finite_calls();
+
+                if (bin_result.non_zero_calls() != 0)
+                {
+                    T const weight = T(1.0) / bin_result.variance();
+
+                    sums_[2 * bin + 0] += weight;
+                    sums_[2 * bin + 1] += weight * bin_result.value();
+                }
+
+                ++bin;
+            }
+        }
+    }
+
+    /// Returns the number of results that were added.
+    std::size_t iterations() const
+    {
+        return statistics_.iterations();
+    }
+
+    /// Returns the statistics of the integrated results, without their distributions.
+    running_statistics<T> const& statistics() const
+    {
+        return statistics_;
+    }
+
+    /// Returns the combined result together with its distributions.
+    plain_result<T> result() const
+    {
+        std::vector<distribution_result<T>> distributions;
+        distributions.reserve(parameters_.size());
+
+        std::size_t bin = 0;
+
+        for (std::size_t i = 0; i != parameters_.size(); ++i)
+        {
+            std::vector<mc_result<T>> results;
+            results.reserve(bins_[i]);
+
+            for (std::size_t j = 0; j != bins_[i]; ++j)
+            {
+                results.push_back(weighted_result(counters_[3 * bin + 0],
+                    counters_[3 * bin + 1], counters_[3 * bin + 2], sums_[2 * bin + 0],
+                    sums_[2 * bin + 1]));
+                ++bin;
+            }
+
+            distributions.emplace_back(parameters_[i], results);
+        }
+
+        auto const total = statistics_.result();
+
+        return plain_result<T>(distributions, total.calls(), total.non_zero_calls(),
+            total.finite_calls(), total.sum(), total.sum_of_squares());
+    }
+
+private:
+    // Takes the parameters and the number of bins of each distribution from the first result
+    void initialize(std::vector<distribution_result<T>> const& distributions)
+    {
+        std::size_t size = 0;
+
+        for (auto const& distribution : distributions)
+        {
+            parameters_.push_back(distribution.parameters());
+            bins_.push_back(distribution.results().size());
+            size += distribution.results().size();
+        }
+
+        counters_.assign(3 * size, 0);
+        sums_.assign(2 * size, T());
+    }
+
+    bool same_bins(std::vector<distribution_result<T>> const& distributions) const
+    {
+        if (distributions.size() != bins_.size())
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i != bins_.size(); ++i)
+        {
+            if (distributions[i].results().size() != bins_[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    running_statistics<T> statistics_;
+    std::vector<distribution_parameters<T>> parameters_;
+    std::vector<std::size_t> bins_;
+
+    // calls, non-zero calls and finite calls of each bin
+    std::vector<std::size_t> counters_;
+
+    // inverse variances and weighted values of each bin
+    std::vector<T> sums_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef HEP_MC_RUNNING_STATISTICS_HPP
+#define HEP_MC_RUNNING_STATISTICS_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/mc_result.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace hep
+{
+
+/// \cond INTERNAL
+
+// Returns the result of results weighted with their inverse variances from the sums of the
+// inverse variances and of the weighted values, in the same way as \ref weighted_with_variance
+template <typename T>
+inline mc_result<T> weighted_result(
+    std::size_t calls,
+    std::size_t non_zero_calls,
+    std::size_t finite_calls,
+    T inverse_variance,
+    T weighted_sum
+) {
+    using std::sqrt;
+
+    T estimate = weighted_sum;
+    T variance = inverse_variance;
+
+    if (non_zero_calls != 0)
+    {
+        variance = T(1.0) / variance;
+        estimate *= variance;
+    }
+
+    return create_result(calls, non_zero_calls, finite_calls, estimate, sqrt(variance));
+}
+
+/// \endcond
+
+/// \addtogroup results
+/// @{
+
+/// Statistics of a sequence of results that are updated with each result in constant time. The
+/// cumulative result and the \f$ \chi^2 \f$ are the same that \ref weighted_with_variance and
+/// \ref chi_square_dof compute from the entire sequence. Every \ref chkpt keeps these statistics
+/// for each of its iterations, see \ref chkpt::statistics.
+template <typename T>
+class running_statistics
+{
+public:
+    /// Numeric type used for the statistics.
+    using numeric_type = T;
+
+    /// Constructor. Creates the statistics of an empty sequence.
+    running_statistics()
+        : iterations_()
+        , calls_()
+        , non_zero_calls_()
+        , finite_calls_()
+        , inverse_variance_()
+        , weighted_sum_()
+        , mean_()
+        , chi_square_()
+    {
+    }
+
+    /// Adds `result` to the sequence. Results without non-zero calls have no variance and only
+    /// contribute their calls.
+    void add(mc_result<T> const& result)
+    {
+        ++iterations_;
+        calls_ += result.calls();
+        non_zero_calls_ += result.non_zero_calls();
+        finite_calls_ += result.finite_calls();
+
+        if (result.non_zero_calls() == 0)
+        {
+            return;
+        }
+
+        T const weight = T(1.0) / result.variance();
+        T const delta = result.value() - mean_;
+
+        inverse_variance_ += weight;
+        weighted_sum_ += weight * result.value();
+
+        // weighted version of Welford's algorithm, which avoids the cancellation of the sums of
+        // squares
+        mean_ += delta * weight / inverse_variance_;
+        chi_square_ += weight * delta * (result.value() - mean_);
+    }
+
+    /// Returns the number of results in the sequence.
+    std::size_t iterations() const
+    {
+        return iterations_;
+    }
+
+    /// Returns the sum of the calls of all results.
+    std::size_t calls() const
+    {
+        return calls_;
+    }
+
+    /// Returns the sum of the non-zero calls of all results.
+    std::size_t non_zero_calls() const
+    {
+        return non_zero_calls_;
+    }
+
+    /// Returns the sum of the finite calls of all results.
+    std::size_t finite_calls() const
+    {
+        return finite_calls_;
+    }
+
+    /// Returns the sum of the inverse variances \f$ \sum_i 1 / S_i^2 \f$ of all results.
+    T inverse_variance() const
+    {
+        return inverse_variance_;
+    }
+
+    /// Returns the cumulative result, which is identical to the one \ref weighted_with_variance
+    /// computes.
+    mc_result<T> result() const
+    {
+        return weighted_result(calls_, non_zero_calls_, finite_calls_, inverse_variance_,
+            weighted_sum_);
+    }
+
+    /// Returns the \f$ \chi^2 \f$ per degree of freedom of all results with respect to the
+    /// cumulative \ref result. As for \ref chi_square_dof, this is zero without any results and
+    /// infinity for one result.
+    T chi_square_dof() const
+    {
+        switch (iterations_)
+        {
+        case 0:
+            return T();
+
+        case 1:
+            return std::numeric_limits<T>::infinity();
+
+        default:
+            return chi_square_ / T(iterations_ - 1);
+        }
+    }
+
+private:
+    std::size_t iterations_;
+    std::size_t calls_;
+    std::size_t non_zero_calls_;
+    std::size_t finite_calls_;
+    T inverse_variance_;
+    T weighted_sum_;
+    T mean_;
+    T chi_square_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,251 @@
+#ifndef HEP_MC_SPARSE_DENSITIES_HPP
+#define HEP_MC_SPARSE_DENSITIES_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup integrands
+/// @{
+
+/// Densities of the channels that contribute to a point, which a map created with \ref
+/// make_sparse_map writes instead of the densities of all channels. Channels that are not added
+/// have a density of zero.
+template <typename T>
+class sparse_densities
+{
+public:
+    /// Constructor. Creates an object without any densities.
+    sparse_densities() = default;
+
+    /// Sets the density of `channel` to `density`. Each channel must be added at most once for
+    /// each point.
+    void add(std::size_t channel, T density)
+    {
+        channels_.push_back(channel);
+        densities_.push_back(density);
+    }
+
+    /// Returns the number of channels that were added.
+    std::size_t size() const
+    {
+        return channels_.size();
+    }
+
+    /// Returns the channel that was added with the index `index`.
+    std::size_t channel(std::size_t index) const
+    {
+        return channels_[index];
+    }
+
+    /// Returns the density that was added with the index `index`.
+    T density(std::size_t index) const
+    {
+        return densities_[index];
+    }
+
+    /// Removes all densities. The integrators call this function before each call of the map.
+    void clear()
+    {
+        channels_.clear();
+        densities_.clear();
+    }
+
+private:
+    std::vector<std::size_t> channels_;
+    std::vector<T> densities_;
+};
+
+/// Wrapper of a map function, see \ref make_multi_channel_integrand, that passes the densities as
+/// \ref sparse_densities instead of a vector with an element for every channel. Instances should
+/// be created with \ref make_sparse_map.
+template <typename M>
+class sparse_map
+{
+public:
+    /// Constructor.
+    template <typename N>
+    explicit sparse_map(N&& map)
+        : map_(std::forward<N>(map))
+    {
+    }
+
+    /// Calls the wrapped map with the arguments `args`.
+    template <typename... Args>
+    auto operator()(Args&&... args) -> decltype (std::declval<M&>()(std::forward<Args>(args)...))
+    {
+        return map_(std::forward<Args>(args)...);
+    }
+
+    /// Calls the wrapped map with the arguments `args`.
+    template <typename... Args>
+    auto operator()(Args&&... args) const
+        -> decltype (std::declval<M const&>()(std::forward<Args>(args)...))
+    {
+        return map_(std::forward<Args>(args)...);
+    }
+
+private:
+    M map_;
+};
+
+/// Wraps `map` so that the multi channel integrators pass the densities as \ref sparse_densities,
+/// which makes the time needed for each point proportional to the number of channels whose
+/// density is not zero instead of the number of all channels. The map must then be declared as
+/// \code
+/// T map(
+///     std::size_t channel,
+///     std::vector<T> const& random_numbers,
+///     std::vector<T>& coordinates,
+///     std::vector<std::size_t> const& enabled_channels,
+///     hep::sparse_densities<T>& densities,
+///     hep::multi_channel_map action
+/// );
+/// \endcode
+/// and add the density of every enabled channel that is not zero with \ref sparse_densities::add.
+/// The sum over the channels is performed in the order the densities were added, so that the
+/// results can differ from the ones of a dense map by rounding.
+template <typename M>
+inline sparse_map<typename std::decay<M>::type> make_sparse_map(M&& map)
+{
+    return sparse_map<typename std::decay<M>::type>(std::forward<M>(map));
+}
+
+/// @}
+
+/// \cond INTERNAL
+
+// Type of the densities that are passed to a map of type `M`
+template <typename T, typename M>
+struct multi_channel_densities_of
+{
+    using type = std::vector<T>;
+};
+
+template <typename T, typename M>
+struct multi_channel_densities_of<T, sparse_map<M>>
+{
+    using type = sparse_densities<T>;
+};
+
+template <typename T, typename M>
+using multi_channel_densities = typename multi_channel_densities_of<T,
+    typename std::remove_cv<M>::type>::type;
+
+// Dense densities need an element for each channel, sparse ones grow as needed
+template <typename T>
+inline void multi_channel_resize_densities(std::vector<T>& densities, std::size_t channels)
+{
+    densities.resize(channels);
+}
+
+template <typename T>
+inline void multi_channel_resize_densities(sparse_densities<T>&, std::size_t)
+{
+}
+
+// Creates the densities of `channels` channels for a map of type `M`
+template <typename T, typename M>
+inline multi_channel_densities<T, M> make_multi_channel_densities(std::size_t channels)
+{
+    multi_channel_densities<T, M> densities;
+    multi_channel_resize_densities(densities, channels);
+
+    return densities;
+}
+
+// Dense densities are overwritten by the map
+template <typename T>
+inline void multi_channel_clear_densities(std::vector<T>&)
+{
+}
+
+template <typename T>
+inline void multi_channel_clear_densities(sparse_densities<T>& densities)
+{
+    densities.clear();
+}
+
+// Returns the sum of the densities weighted with `channel_weights`
+template <typename T>
+inline T multi_channel_total_density(
+    std::vector<T> const& densities,
+    std::vector<T> const& channel_weights
+) {
+    T total_density = T();
+
+    for (std::size_t j = 0; j != channel_weights.size(); ++j)
+    {
+        total_density += channel_weights[j] * densities[j];
+    }
+
+    return total_density;
+}
+
+template <typename T>
+inline T multi_channel_total_density(
+    sparse_densities<T> const& densities,
+    std::vector<T> const& channel_weights
+) {
+    T total_density = T();
+
+    for (std::size_t j = 0; j != densities.size(); ++j)
+    {
+        total_density += channel_weights[densities.channel(j)] * densities.density(j);
+    }
+
+    return total_density;
+}
+
+// Adds the values W that are used to update the channel weights to `adjustment_data`
+template <typename T>
+inline void multi_channel_adjust(
+    std::vector<T>& adjustment_data,
+    std::vector<T> const& densities,
+    T square
+) {
+    for (std::size_t j = 0; j != adjustment_data.size(); ++j)
+    {
+        adjustment_data[j] += densities[j] * square;
+    }
+}
+
+template <typename T>
+inline void multi_channel_adjust(
+    std::vector<T>& adjustment_data,
+    sparse_densities<T> const& densities,
+    T square
+) {
+    for (std::size_t j = 0; j != densities.size(); ++j)
+    {
+        adjustment_data[densities.channel(j)] += densities.density(j) * square;
+    }
+}
+
+/// \endcond
+
+}
+
+#endif
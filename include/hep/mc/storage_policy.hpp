@@ -0,0 +1,130 @@
+#ifndef HEP_MC_STORAGE_POLICY_HPP
+#define HEP_MC_STORAGE_POLICY_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup distributions
+/// @{
+
+/// Storage used by the integrators for the intermediate sums of an iteration, which uses the
+/// numeric type `T` for everything. This is the default \ref storage_policy.
+template <typename T>
+struct full_storage
+{
+    /// Type of the sums and sums of squares of each bin of a distribution.
+    using bin_type = T;
+
+    /// Type of the numbers of non-zero and finite calls of each bin of a distribution.
+    using counter_type = std::size_t;
+
+    /// Type of the adjustment data that VEGAS accumulates to refine its grid.
+    using adjustment_type = T;
+
+    /// If `true`, the sums of each bin use Kahan summation, which needs an additional number per
+    /// bin.
+    static constexpr bool compensated = true;
+};
+
+/// Storage that needs half the memory of \ref full_storage for distributions with many bins and
+/// for the adjustment data of VEGAS, which increases the number of bins that fit into the
+/// caches of the processor. The bins use single-precision sums with Kahan summation and 32-bit
+/// counters, which limits the number of calls of an iteration that fall into a single bin to
+/// \f$ 2^{32} - 1 \f$. The integrated total is not affected and always uses the type `T`.
+template <typename T>
+struct compact_storage
+{
+    /// Type of the sums and sums of squares of each bin of a distribution.
+    using bin_type = float;
+
+    /// Type of the numbers of non-zero and finite calls of each bin of a distribution.
+    using counter_type = std::uint32_t;
+
+    /// Type of the adjustment data that VEGAS accumulates to refine its grid.
+    using adjustment_type = float;
+
+    /// If `true`, the sums of each bin use Kahan summation, which needs an additional number per
+    /// bin.
+    static constexpr bool compensated = true;
+};
+
+/// Trait that determines how the integrators store the bins of distributions while an iteration
+/// for the numeric type `T` is running, and the adjustment data of VEGAS unless the integrator is
+/// given another policy; the results are always converted to `T`. The default is \ref
+/// full_storage. The adjustment data of a single VEGAS integration is better chosen with the first
+/// template argument of \ref vegas, \ref parallel_vegas or \ref mpi_vegas, for example
+/// `hep::vegas<hep::compact_storage>(integrand, iteration_calls)`.
+///
+/// \warning A specialization of this trait applies to the entire program. It must be declared
+/// before the first use of `storage_policy<T>` in every translation unit, and it must be identical
+/// in all of them; otherwise the program violates the one definition rule and its behaviour is
+/// undefined, e.g. integrators in different translation units may silently use different storage.
+/// Declare it in a single header that is included before `hep/mc.hpp` everywhere.
+///
+/// Programs that are limited by the memory bandwidth may specialize this trait to derive from \ref
+/// compact_storage or from a class with the same members, for example
+/// \code
+/// namespace hep
+/// {
+///
+/// template <>
+/// struct storage_policy<double> : compact_storage<double>
+/// {
+///     // give up the compensation to save another four bytes per bin
+///     static constexpr bool compensated = false;
+/// };
+///
+/// }
+/// \endcode
+template <typename T>
+struct storage_policy : full_storage<T>
+{
+};
+
+/// \cond INTERNAL
+
+// Returns `data`, which already uses the numeric type `T`
+template <typename T>
+inline std::vector<T> const& storage_cast(std::vector<T> const& data)
+{
+    return data;
+}
+
+// Converts `data`, which uses a type of a \ref storage_policy, into the numeric type `T`
+template <typename T, typename D>
+inline typename std::enable_if<!std::is_same<T, D>::value, std::vector<T>>::type storage_cast(
+    std::vector<D> const& data
+) {
+    return std::vector<T>(data.begin(), data.end());
+}
+
+/// \endcond
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef HEP_MC_THREAD_POOL_HPP
+#define HEP_MC_THREAD_POOL_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup parallel_group
+/// @{
+
+/// A fixed-size pool of threads used by the shared-memory integrators, e.g. \ref parallel_vegas.
+/// The thread calling \ref run takes part in the computation, which means that a pool of size one
+/// does not start any additional threads.
+class thread_pool
+{
+public:
+    /// Constructor. Creates a pool which runs functions on `threads` threads. If `threads` is zero,
+    /// the number returned by `std::thread::hardware_concurrency()` is used instead.
+    explicit thread_pool(std::size_t threads = 0)
+        : size_{(threads == 0) ? std::max(1u, std::thread::hardware_concurrency()) : threads}
+        , generation_{0}
+        , pending_{0}
+        , stop_{false}
+    {
+        workers_.reserve(size_ - 1);
+
+        for (std::size_t i = 1; i != size_; ++i)
+        {
+            workers_.emplace_back(&thread_pool::work, this, i);
+        }
+    }
+
+    /// There is no copy constructor.
+    thread_pool(thread_pool const&) = delete;
+
+    /// There is no move constructor.
+    thread_pool(thread_pool&&) = delete;
+
+    /// There is no copy assignment operator.
+    thread_pool& operator=(thread_pool const&) = delete;
+
+    /// There is no move assignment operator.
+    thread_pool& operator=(thread_pool&&) = delete;
+
+    /// Destructor. Waits for all threads to finish.
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        start_.notify_all();
+
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    /// Returns the number of threads of this pool, including the thread calling \ref run.
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /// Calls `function(index)` for every `index` in the interval `[0, size())` concurrently, each
+    /// call on a different thread, and returns after every call has finished. If a call throws an
+    /// exception, the one with the smallest `index` is rethrown. This function must not be called
+    /// concurrently from different threads.
+    template <typename F>
+    void run(F&& function)
+    {
+        if (size_ == 1)
+        {
+            function(std::size_t());
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            task_ = [&function](std::size_t index) { function(index); };
+            exceptions_.assign(size_, nullptr);
+            pending_ = size_ - 1;
+            ++generation_;
+        }
+
+        start_.notify_all();
+        execute(0);
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return pending_ == 0; });
+            task_ = nullptr;
+        }
+
+        for (auto const& exception : exceptions_)
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+private:
+    void execute(std::size_t index)
+    {
+        try
+        {
+            task_(index);
+        }
+        catch (...)
+        {
+            exceptions_[index] = std::current_exception();
+        }
+    }
+
+    void work(std::size_t index)
+    {
+        std::size_t generation = 0;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || (generation_ != generation); });
+
+                if (stop_)
+                {
+                    return;
+                }
+
+                generation = generation_;
+            }
+
+            execute(index);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (--pending_ == 0)
+                {
+                    done_.notify_one();
+                }
+            }
+        }
+    }
+
+    std::size_t size_;
+    std::size_t generation_;
+    std::size_t pending_;
+    bool stop_;
+    std::function<void(std::size_t)> task_;
+    std::vector<std::exception_ptr> exceptions_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    std::vector<std::thread> workers_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef HEP_MC_UNIFORM_RANDOM_HPP
+#define HEP_MC_UNIFORM_RANDOM_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+namespace hep
+{
+
+/// \addtogroup random_numbers_group
+/// @{
+
+/// Trait that determines how \ref generate_uniform converts the integers of a random number engine
+/// of type `R` into floating-point numbers. The default uses `std::generate_canonical`, which
+/// reproduces the results of previous versions of this library. Engines whose `min()` is zero and
+/// whose `max()` is \f$ 2^{64} - 1 \f$ may specialize this trait to derive from
+/// `std::true_type`, in which case each floating-point number is built from the most significant
+/// bits of exactly one integer with a shift and a multiplication, without any division.
+template <typename R>
+struct fast_uniform_conversion : std::false_type
+{
+};
+
+/// \cond INTERNAL
+
+template <typename T, typename R>
+inline T generate_uniform(R& generator, std::false_type)
+{
+    return std::generate_canonical<T, std::numeric_limits<T>::digits>(generator);
+}
+
+template <typename T, typename R>
+inline T generate_uniform(R& generator, std::true_type)
+{
+    static_assert (std::numeric_limits<T>::digits <= 64, "the numeric type has too many digits");
+    static_assert ((R::min() == 0) && (R::max() == std::numeric_limits<std::uint64_t>::max()),
+        "the engine must generate all 64-bit integers");
+
+    std::size_t const digits = std::numeric_limits<T>::digits;
+
+    // the inverse of 2^digits
+    T const scale = T(1.0) / (T(2.0) * T(std::uint64_t(1) << (digits - 1)));
+
+    return T(std::uint64_t(generator()) >> (64 - digits)) * scale;
+}
+
+/// \endcond
+
+/// Returns a random number uniformly distributed in \f$ [0, 1) \f$ generated by `generator`. The
+/// conversion is selected by \ref fast_uniform_conversion.
+template <typename T, typename R>
+inline T generate_uniform(R& generator)
+{
+    return generate_uniform<T>(generator, fast_uniform_conversion<R>());
+}
+
+/// Fills the range given by `first` and `last` with random numbers uniformly distributed in
+/// \f$ [0, 1) \f$, which are the same as if \ref generate_uniform was called for each element.
+template <typename T, typename R>
+inline void generate_uniform(R& generator, T* first, T* last)
+{
+    for (; first != last; ++first)
+    {
+        *first = generate_uniform<T>(generator, fast_uniform_conversion<R>());
+    }
+}
+
+/// @}
+
+}
+
+#endif
@@ -20,59 +20,52 @@
  */
 
 #include "hep/mc/accumulator.hpp"
+#include "hep/mc/batch_integrand.hpp"
 #include "hep/mc/callback.hpp"
 #include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/storage_policy.hpp"
+#include "hep/mc/uniform_random.hpp"
+#include "hep/mc/vegas_batch.hpp"
 #include "hep/mc/vegas_chkpt.hpp"
 #include "hep/mc/vegas_pdf.hpp"
 #include "hep/mc/vegas_point.hpp"
 #include "hep/mc/vegas_result.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace hep
 {
 
-/// \addtogroup vegas_group
-/// @{
+/// \cond INTERNAL
 
-/// Performs one VEGAS iteration. This integrates `function` over the unit-hypercube using `calls`
-/// function evaluations with random numbers generated by `generator`. The generator is not seeded.
-/// The `pdf` is used to implement importance sampling; stratified sampling is not used. The
-/// dimension of the function is determined by `pdf.size()`.
-///
-/// The parameter `total_calls` determines the sample size \f$ N \f$ of the iteration \ref
-/// vegas_iteration performs and therefore usually has usually the same value as `calls`. If VEGAS
-/// is run in parallel, then this function will be called multiple times with a differently seeded
-/// generator and with `calls` parameters each smaller than `total_calls` but their sum being equal
-/// to `total_calls`.
-template <typename I, typename R>
-inline vegas_result<numeric_type_of<I>> vegas_iteration(
-    I&& integrand,
+// Evaluates an integrand created with \ref make_integrand point by point.
+template <typename I, typename A, typename R, typename D>
+inline void vegas_sample(
+    I& integrand,
+    A& accumulator,
     std::size_t calls,
     vegas_pdf<numeric_type_of<I>> const& pdf,
-    R& generator
+    R& generator,
+    std::vector<D>& adjustment_data,
+    std::false_type
 ) {
     using T = numeric_type_of<I>;
 
-    auto accumulator = make_accumulator(integrand);
-
     std::size_t const dimensions = pdf.dimensions();
     std::size_t const bins       = pdf.bins();
 
-    std::vector<T> adjustment_data(dimensions * bins);
     std::vector<T> random_numbers(dimensions);
     std::vector<std::size_t> bin(dimensions);
 
     for (std::size_t i = 0; i != calls; ++i)
     {
-        for (std::size_t j = 0; j != dimensions; ++j)
-        {
-            random_numbers[j] = std::generate_canonical<T,
-                std::numeric_limits<T>::digits>(generator);
-        }
+        generate_uniform(generator, random_numbers.data(), random_numbers.data() + dimensions);
 
         vegas_point<T> const point(random_numbers, bin, pdf);
 
@@ -82,11 +75,122 @@ inline vegas_result<numeric_type_of<I>> vegas_iteration(
         // save square for each bin in order to refine the pdf later
         for (std::size_t j = 0; j != dimensions; ++j)
         {
-            adjustment_data[j * bins + point.bin()[j]] += square;
+            adjustment_data[j * bins + point.bin()[j]] += static_cast <D> (square);
+        }
+    }
+}
+
+// Evaluates an integrand created with \ref make_batch_integrand. The random numbers are drawn in
+// the same order as for the point-by-point evaluation.
+template <typename I, typename A, typename R, typename D>
+inline void vegas_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    vegas_pdf<numeric_type_of<I>> const& pdf,
+    R& generator,
+    std::vector<D>& adjustment_data,
+    std::true_type
+) {
+    using T = numeric_type_of<I>;
+
+    std::size_t const dimensions = pdf.dimensions();
+    std::size_t const bins       = pdf.bins();
+    std::size_t const capacity   = batch_capacity(integrand, calls);
+
+    std::vector<T> random_numbers(dimensions * capacity);
+    std::vector<T> points(dimensions * capacity);
+    std::vector<std::size_t> point_bins(dimensions * capacity);
+    std::vector<T> weights(capacity);
+    std::vector<T> values(capacity);
+
+    for (std::size_t i = 0; i < calls; i += capacity)
+    {
+        std::size_t const size = std::min(capacity, calls - i);
+
+        batch_generate_points(generator, size, capacity, random_numbers, points);
+
+        vegas_icdf_block(pdf, size, capacity, points.data(), point_bins.data(), weights.data());
+
+        vegas_batch<T> const batch(points, weights, point_bins, size);
+
+        std::fill(values.begin(), values.end(), T());
+        integrand.function()(batch, values);
+
+        for (std::size_t j = 0; j != size; ++j)
+        {
+            if (values[j] == T())
+            {
+                continue;
+            }
+
+            T const value = accumulator.add(values[j] * weights[j]);
+            T const square = value * value;
+
+            for (std::size_t k = 0; k != dimensions; ++k)
+            {
+                adjustment_data[k * bins + point_bins[k * capacity + j]] +=
+                    static_cast <D> (square);
+            }
         }
     }
+}
 
-    return vegas_result<T>(accumulator.result(calls), pdf, adjustment_data);
+// Performs `calls` evaluations of `integrand` at points distributed according to `pdf`, adds them
+// to `accumulator` and the squared values to the bins of `adjustment_data`, whose type is given by
+// the storage policy of the integrator. This is the loop of \ref vegas_iteration, which is shared
+// with the parallel integrators.
+template <typename I, typename A, typename R, typename D>
+inline void vegas_sample(
+    I& integrand,
+    A& accumulator,
+    std::size_t calls,
+    vegas_pdf<numeric_type_of<I>> const& pdf,
+    R& generator,
+    std::vector<D>& adjustment_data
+) {
+    vegas_sample(integrand, accumulator, calls, pdf, generator, adjustment_data,
+        batch_tag_of<I>());
+}
+
+/// \endcond
+
+/// \addtogroup vegas_group
+/// @{
+
+/// Performs one VEGAS iteration. This integrates `function` over the unit-hypercube using `calls`
+/// function evaluations with random numbers generated by `generator`. The generator is not seeded.
+/// The `pdf` is used to implement importance sampling; stratified sampling is not used. The
+/// dimension of the function is determined by `pdf.size()`.
+///
+/// The parameter `total_calls` determines the sample size \f$ N \f$ of the iteration \ref
+/// vegas_iteration performs and therefore usually has usually the same value as `calls`. If VEGAS
+/// is run in parallel, then this function will be called multiple times with a differently seeded
+/// generator and with `calls` parameters each smaller than `total_calls` but their sum being equal
+/// to `total_calls`.
+///
+/// The adjustment data of the grid is accumulated in the type `Storage<T>::adjustment_type`, where
+/// `T` is the numeric type of the integrand; the default is given by \ref storage_policy. Passing
+/// \ref compact_storage as the first template argument halves the memory of the adjustment data
+/// for this integration only. The other members of `Storage<T>` are not used; the bins of
+/// distributions are always stored as given by \ref storage_policy.
+template <template <typename> class Storage = storage_policy, typename I, typename R>
+inline vegas_result<numeric_type_of<I>> vegas_iteration(
+    I&& integrand,
+    std::size_t calls,
+    vegas_pdf<numeric_type_of<I>> const& pdf,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+
+    auto accumulator = make_accumulator(integrand);
+
+    std::vector<typename Storage<T>::adjustment_type> adjustment_data(pdf.dimensions() *
+        pdf.bins());
+
+    vegas_sample(integrand, accumulator, calls, pdf, generator, adjustment_data);
+
+    return vegas_result<T>(accumulator.result(calls), pdf, storage_cast<T>(adjustment_data));
 }
 
 /// Integrates `function` by performing `iteration_calls.size()` iterations of the VEGAS algorithm,
@@ -95,8 +199,10 @@ inline vegas_result<numeric_type_of<I>> vegas_iteration(
 /// the \f$ \alpha \f$-parameter given by `alpha`.
 ///
 /// This function can be used to start from an already adapted pdf, e.g. one by \ref
-/// vegas_result.pdf obtained by a previous \ref vegas call.
-template <typename I, typename Checkpoint = default_vegas_chkpt<numeric_type_of<I>>,
+/// vegas_result.pdf obtained by a previous \ref vegas call. The adjustment data of each iteration
+/// is stored as given by `Storage`, see \ref vegas_iteration.
+template <template <typename> class Storage = storage_policy, typename I,
+    typename Checkpoint = default_vegas_chkpt<numeric_type_of<I>>,
     typename Callback = callback<Checkpoint>>
 inline Checkpoint vegas(
     I&& integrand,
@@ -107,19 +213,24 @@ inline Checkpoint vegas(
     chkpt.dimensions(integrand.dimensions());
 
     auto generator = chkpt.generator();
+    stopwatch wall_time;
 
     // perform iterations
     for (auto const calls : iteration_calls)
     {
         auto const& pdf = chkpt.pdf();
-        auto const& result = vegas_iteration(integrand, calls, pdf, generator);
+        stopwatch integrand_time;
+        auto const& result = vegas_iteration<Storage>(integrand, calls, pdf, generator);
 
-        chkpt.add(result, generator);
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
 
         if (!callback(chkpt))
         {
             break;
         }
+
+        wall_time.restart();
     }
 
     return chkpt;
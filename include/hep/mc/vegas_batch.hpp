@@ -0,0 +1,69 @@
+#ifndef HEP_MC_VEGAS_BATCH_HPP
+#define HEP_MC_VEGAS_BATCH_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/mc_batch.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup integrands
+/// @{
+
+/// A block of points generated by VEGAS with the additional information in which bins of the \ref
+/// vegas_pdf each point lies. The bin indices are stored in the same layout as the coordinates.
+template <typename T>
+class vegas_batch : public mc_batch<T>
+{
+public:
+    /// Constructor. See \ref mc_batch::mc_batch for the layout of `points`, which is also used for
+    /// `bins`.
+    vegas_batch(
+        std::vector<T> const& points,
+        std::vector<T> const& weights,
+        std::vector<std::size_t> const& bins,
+        std::size_t size
+    )
+        : mc_batch<T>(points, weights, size)
+        , bins_(bins)
+    {
+    }
+
+    /// Destructor.
+    ~vegas_batch() override = default;
+
+    /// Returns a pointer to the bin indices in `dimension` of all points.
+    std::size_t const* bin(std::size_t dimension) const
+    {
+        return bins_.data() + dimension * this->capacity();
+    }
+
+private:
+    std::vector<std::size_t> const& bins_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -29,6 +29,7 @@
 #include <ios>
 #include <limits>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
 namespace hep
@@ -37,9 +38,29 @@ namespace hep
 /// \addtogroup checkpoints
 /// @{
 
-/// Checkpoints created by the \ref vegas_group.
-template <typename T>
-class vegas_chkpt : public chkpt<vegas_result<T>>
+/// Determines which PDFs a \ref vegas_chkpt keeps for the results of previous iterations. Only the
+/// last result is needed to resume an integration, and long integrations with many bins and
+/// dimensions use much less memory and disk space if older PDFs are discarded.
+enum class vegas_grid_storage
+{
+    /// Every result keeps its \ref vegas_result::pdf and \ref vegas_result::adjustment_data.
+    all,
+
+    /// The results of all iterations except the first and the last one discard their PDF, but keep
+    /// their adjustment data, so that the discarded PDFs can be reconstructed with \ref
+    /// vegas_chkpt::pdf.
+    adjustment_data,
+
+    /// The results of all iterations except the last one discard both their PDF and their
+    /// adjustment data, and only the integrated numbers and distributions remain. Such checkpoints
+    /// can not be rolled back to previous iterations, see \ref vegas_chkpt::rollback.
+    last
+};
+
+/// Checkpoints created by the \ref vegas_group. The type `Result` is the type of the results of
+/// each iteration, which must be \ref vegas_result or derived from it.
+template <typename T, typename Result = vegas_result<T>>
+class vegas_chkpt : public chkpt<Result>
 {
 public:
     /// Constructor. Creates an empty checkpoint with a uniform \ref vegas_pdf with the specified
@@ -60,7 +81,7 @@ public:
 
     /// Deserialization constructor. This creates a checkpoint by reading from the stream `in`.
     explicit vegas_chkpt(std::istream& in)
-        : chkpt<vegas_result<T>>{in}
+        : chkpt<Result>{in}
     {
         in >> alpha_;
 
@@ -70,6 +91,17 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit vegas_chkpt(binary_reader& in)
+        : chkpt<Result>{in}
+        , alpha_(in.read<T>())
+    {
+        if (this->results().empty())
+        {
+            pdf_.emplace_back(in);
+        }
+    }
+
     /// Returns the parameter `alpha`, which is used to refine the PDF of VEGAS after each
     /// iteration.
     T alpha() const
@@ -102,9 +134,121 @@ public:
         return vegas_refine_pdf(results.back().pdf(), alpha_, results.back().adjustment_data());
     }
 
+    /// Returns the PDF which was used in `iteration`; if `iteration` is the number of results this
+    /// is the same as \ref pdf(). PDFs discarded with \ref vegas_grid_storage::adjustment_data
+    /// are reconstructed by refining the last stored PDF before `iteration`, which gives exactly
+    /// the original PDF. Throws `std::runtime_error` if the data needed for that has been
+    /// discarded.
+    vegas_pdf<T> pdf(std::size_t iteration) const
+    {
+        auto const& results = this->results();
+
+        if (iteration > results.size())
+        {
+            throw std::out_of_range("parameter `iteration` too large");
+        }
+
+        if (iteration == results.size())
+        {
+            return pdf();
+        }
+
+        std::size_t stored = iteration;
+
+        while (results.at(stored).pdf().bins() == 0)
+        {
+            if (stored == 0)
+            {
+                throw std::runtime_error("the PDF of the first iteration has been discarded");
+            }
+
+            --stored;
+        }
+
+        vegas_pdf<T> result = results.at(stored).pdf();
+
+        for (std::size_t i = stored; i != iteration; ++i)
+        {
+            auto const& adjustment_data = results.at(i).adjustment_data();
+
+            if (adjustment_data.empty())
+            {
+                throw std::runtime_error("the adjustment data of an iteration has been discarded");
+            }
+
+            result = vegas_refine_pdf(result, alpha_, adjustment_data);
+        }
+
+        return result;
+    }
+
+    /// Removes the results after `iteration`, see \ref chkpt::rollback. The PDF of the result that
+    /// becomes the last one is needed to resume the integration; if it was discarded with \ref
+    /// vegas_grid_storage::adjustment_data it is reconstructed, see \ref pdf(std::size_t). With
+    /// \ref vegas_grid_storage::last this is impossible and `std::runtime_error` is thrown, unless
+    /// `iteration` is zero or the number of results. If an exception is thrown, the checkpoint is
+    /// not changed.
+    void rollback(std::size_t iteration) override
+    {
+        auto const& results = this->results();
+
+        if (iteration < results.size())
+        {
+            if (iteration == 0)
+            {
+                // checkpoints that were read from a file do not store the initial PDF
+                if (pdf_.empty())
+                {
+                    if (results.front().pdf().bins() == 0)
+                    {
+                        throw std::runtime_error("the PDF of the first iteration has been "
+                            "discarded");
+                    }
+
+                    pdf_.push_back(results.front().pdf());
+                }
+            }
+            else if (results.at(iteration - 1).pdf().bins() == 0)
+            {
+                if (grid_storage_ == vegas_grid_storage::last)
+                {
+                    throw std::runtime_error("the PDFs needed to roll back have been discarded");
+                }
+
+                vegas_pdf<T> const pdf = this->pdf(iteration - 1);
+
+                chkpt<Result>::rollback(iteration);
+                this->results_.back().restore_pdf(pdf);
+
+                return;
+            }
+        }
+
+        chkpt<Result>::rollback(iteration);
+    }
+
+    /// Returns which PDFs of previous iterations are stored, see \ref vegas_grid_storage.
+    vegas_grid_storage grid_storage() const
+    {
+        return grid_storage_;
+    }
+
+    /// Sets which PDFs of previous iterations are stored and discards the ones of the existing
+    /// results accordingly. This setting is not serialized and must be set again after a
+    /// checkpoint is read.
+    void grid_storage(vegas_grid_storage grid_storage)
+    {
+        grid_storage_ = grid_storage;
+
+        for (std::size_t i = 0; i != this->results().size(); ++i)
+        {
+            discard_pdf(i);
+        }
+    }
+
     void serialize(std::ostream& out) const override
     {
-        chkpt<vegas_result<T>>::serialize(out);
+        chkpt<Result>::serialize(out);
 
         out << std::scientific << std::setprecision(std::numeric_limits<T>::max_digits10 - 1)
             << '\n' << alpha_;
@@ -116,10 +260,48 @@ public:
         }
     }
 
+    void serialize(binary_writer& out) const override
+    {
+        chkpt<Result>::serialize(out);
+        out.write(alpha_);
+
+        if (this->results().empty())
+        {
+            pdf_.front().serialize(out);
+        }
+    }
+
+protected:
+    /// Appends `result` and discards the PDF of the previous result according to \ref
+    /// grid_storage.
+    void add_result(Result const& result)
+    {
+        chkpt<Result>::add_result(result);
+
+        if (this->results().size() > 1)
+        {
+            discard_pdf(this->results().size() - 2);
+        }
+    }
+
 private:
+    void discard_pdf(std::size_t index)
+    {
+        // the last result is needed to resume the integration, the first one to reconstruct the
+        // PDFs of the others
+        if ((grid_storage_ == vegas_grid_storage::all) || (index + 1 == this->results().size()) ||
+            ((grid_storage_ == vegas_grid_storage::adjustment_data) && (index == 0)))
+        {
+            return;
+        }
+
+        this->results_.at(index).discard_pdf(grid_storage_ == vegas_grid_storage::last);
+    }
+
     T alpha_;
     std::size_t bins_;
     std::vector<vegas_pdf<T>> pdf_;
+    vegas_grid_storage grid_storage_ = vegas_grid_storage::all;
 };
 
 /// Checkpoint with random number generators created by using the \ref plain_group.
@@ -19,6 +19,8 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "hep/mc/binary_stream.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -27,8 +29,21 @@
 #include <istream>
 #include <limits>
 #include <ostream>
+#include <stdexcept>
 #include <vector>
 
+/// \cond INTERNAL
+
+// Tells the compiler that the arrays passed to `vegas_icdf_block` do not overlap, which is needed
+// to vectorize its loops. Compilers that do not support this extension get scalar code.
+#if defined (__GNUC__) || defined (_MSC_VER)
+#define HEP_MC_RESTRICT __restrict
+#else
+#define HEP_MC_RESTRICT
+#endif
+
+/// \endcond
+
 namespace hep
 {
 
@@ -53,6 +68,14 @@ template <typename T>
 class vegas_pdf
 {
 public:
+    /// Default constructor. Constructs an empty PDF without bins and dimensions, which is used by
+    /// results whose PDF has been discarded.
+    vegas_pdf()
+        : bins_(0)
+        , dimensions_(0)
+    {
+    }
+
     /// Constructor. Constructs a piecewise constant PDF with the given `dimensions`, each dimension
     /// subdivided by given number of `bins`. Initialy each bin has the same size and therefore this
     /// PDF generates uniformly distributed random numbers.
@@ -84,12 +107,38 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit vegas_pdf(binary_reader& in)
+    {
+        bins_ = in.read_size();
+        dimensions_ = in.read_size();
+
+        // check the size before allocating memory for it; dividing instead of multiplying avoids an
+        // overflow for corrupt sizes
+        std::size_t const numbers = in.remaining() / sizeof (T);
+
+        if ((dimensions_ != 0) && ((bins_ >= numbers) || (bins_ + 1 > numbers / dimensions_)))
+        {
+            throw std::runtime_error("binary checkpoint is truncated");
+        }
+
+        x.resize((bins_ + 1) * dimensions_);
+        in.read(x.data(), x.size());
+    }
+
     /// Returns the left bin boundary of `bin` in `dimension`.
     T bin_left(std::size_t dimension, std::size_t bin) const
     {
         return x[dimension * (bins_ + 1) + bin];
     }
 
+    /// Returns a pointer to the \ref bins `+ 1` boundaries of `dimension`, so that
+    /// `bin_lefts(dimension)[bin] == bin_left(dimension, bin)`.
+    T const* bin_lefts(std::size_t dimension) const
+    {
+        return x.data() + dimension * (bins_ + 1);
+    }
+
     /// Places the new left boundary of `bin` in `dimension` at `left`. Note that this function does
     /// not try to maintain an internally consistent state, i.e. if you use this function make sure
     /// the first entry is zero, the last one and all entries in between are strictly increasing.
@@ -122,57 +171,82 @@ public:
         }
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const
+    {
+        out.write_size(bins_);
+        out.write_size(dimensions_);
+        out.write(x.data(), x.size());
+    }
+
 private:
     std::vector<T> x;
     std::size_t bins_;
     std::size_t dimensions_;
 };
 
-/// Applies the inverse cumulative distribution function to `random_numbers` and updates it with the
-/// new numbers. The bin indices are written into `bin`. The number returned by this function is the
-/// corresponding weight; a weight of one means that this pdf is a uniform one.
+/// Block version of \ref vegas_icdf, which maps `size` points at once. The random numbers must be
+/// stored as a structure of arrays: the number of dimension `d` of point `i` is found at index `d *
+/// stride + i` of `random_numbers` and is replaced by the new number. The bin index of this number
+/// is written to the same index of `bin`, and the weight of point `i` into `weights[i]`. The
+/// results are identical to the ones of \ref vegas_icdf.
+///
+/// The loops run over the points of each dimension, which are contiguous and independent, so that
+/// they are vectorized if the target supports gathers and conversions to 64-bit integers, e.g. when
+/// compiling with `-march=skylake-avx512`; otherwise they are executed as scalar code. The arrays
+/// must not overlap.
 template <typename T>
-inline T vegas_icdf(
+inline void vegas_icdf_block(
     vegas_pdf<T> const& pdf,
-    std::vector<T>& random_numbers,
-    std::vector<std::size_t>& bin
+    std::size_t size,
+    std::size_t stride,
+    T* HEP_MC_RESTRICT random_numbers,
+    std::size_t* HEP_MC_RESTRICT bin,
+    T* HEP_MC_RESTRICT weights
 ) {
     using std::nexttoward;
 
-    T weight = T(1.0);
-
     std::size_t const dimensions = pdf.dimensions();
     std::size_t const bins       = pdf.bins();
 
+    // avoid bug in common C++ standard libraries, see stackoverflow.com/questions/25668600
+    T const largest = nexttoward(T(1.0), T());
+
+    std::fill(weights, weights + size, T(1.0));
+
     for (std::size_t i = 0; i != dimensions; ++i)
     {
-        // avoid bug in common C++ standard libraries, see stackoverflow.com/questions/25668600
-        if (random_numbers[i] == T(1.0))
+        T const* HEP_MC_RESTRICT left = pdf.bin_lefts(i);
+        T* HEP_MC_RESTRICT numbers = random_numbers + i * stride;
+        std::size_t* HEP_MC_RESTRICT indices = bin + i * stride;
+
+        for (std::size_t j = 0; j != size; ++j)
         {
-            random_numbers[i] = nexttoward(random_numbers[i], T());
+            T const number = numbers[j];
+            T const position = ((number < largest) ? number : largest) * bins;
+            std::size_t const index = position;
+            T const size_of_bin = left[index + 1] - left[index];
+
+            numbers[j] = left[index] + (position - index) * size_of_bin;
+            indices[j] = index;
+            weights[j] *= size_of_bin * bins;
         }
+    }
+}
 
-        T const position = random_numbers[i] * bins;
-
-        // randomly select a bin index (integer part) ...
-        std::size_t const index = position;
-
-        // and the position inside this bin (0 -> left boundary, 1 -> right boundary)
-        T const position_inside_bin = position - index;
-
-        // save the index for later
-        bin[i] = index;
-
-        // determine the left bin boundary and its size
-        T const left = pdf.bin_left(i, index);
-        T const size = pdf.bin_left(i, index + 1) - left;
-
-        // apply the one-dimensional linear inverse CDF
-        random_numbers[i] = left + position_inside_bin * size;
+/// Applies the inverse cumulative distribution function to `random_numbers` and updates it with the
+/// new numbers. The bin indices are written into `bin`. The number returned by this function is the
+/// corresponding weight; a weight of one means that this pdf is a uniform one.
+template <typename T>
+inline T vegas_icdf(
+    vegas_pdf<T> const& pdf,
+    std::vector<T>& random_numbers,
+    std::vector<std::size_t>& bin
+) {
+    T weight;
 
-        // multiply weight for each dimension
-        weight *= size * bins;
-    }
+    // a single point is a block whose dimensions are one number apart
+    vegas_icdf_block(pdf, 1, 1, random_numbers.data(), bin.data(), &weight);
 
     return weight;
 }
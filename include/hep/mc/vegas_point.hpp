@@ -51,6 +51,20 @@ public:
     {
     }
 
+    /// Same as the constructor above, but the weight of the point is additionally multiplied with
+    /// `factor`. This is used by \ref vegas_stratified_iteration to weight the points of each
+    /// hypercube.
+    vegas_point(
+        std::vector<T>& random_numbers,
+        std::vector<std::size_t>& bin,
+        vegas_pdf<T> const& pdf,
+        T factor
+    )
+        : mc_point<T>(random_numbers, vegas_icdf(pdf, random_numbers, bin) * factor)
+        , bin_(bin)
+    {
+    }
+
     /// There is no copy constructor.
     vegas_point(vegas_point<T> const&) = delete;
 
@@ -59,7 +59,14 @@ public:
         : plain_result<T>(in)
         , pdf_(in)
     {
-        adjustment_data_.resize(pdf_.bins() * pdf_.dimensions());
+        std::size_t size = pdf_.bins() * pdf_.dimensions();
+
+        if (pdf_.bins() == 0)
+        {
+            in >> size;
+        }
+
+        adjustment_data_.resize(size);
 
         for (std::size_t i = 0; i != adjustment_data_.size(); ++i)
         {
@@ -67,6 +74,15 @@ public:
         }
     }
 
+    /// Deserialization constructor for the binary format.
+    explicit vegas_result(binary_reader& in)
+        : plain_result<T>(in)
+        , pdf_(in)
+        , adjustment_data_((pdf_.bins() == 0) ? in.read_size() : (pdf_.bins() * pdf_.dimensions()))
+    {
+        in.read(adjustment_data_.data(), adjustment_data_.size());
+    }
+
     /// Copy constructor.
     vegas_result(vegas_result<T> const&) = default;
 
@@ -94,6 +110,26 @@ public:
         return adjustment_data_;
     }
 
+    /// Replaces the \ref pdf of this result with an empty one to save memory. If
+    /// `adjustment_data` is `true`, the \ref adjustment_data is removed as well. See \ref
+    /// vegas_grid_storage.
+    void discard_pdf(bool adjustment_data)
+    {
+        pdf_ = vegas_pdf<T>();
+
+        if (adjustment_data)
+        {
+            std::vector<T>().swap(adjustment_data_);
+        }
+    }
+
+    /// Sets the \ref pdf of a result whose PDF was discarded, e.g. with the one reconstructed by
+    /// \ref vegas_chkpt::pdf.
+    void restore_pdf(vegas_pdf<T> const& pdf)
+    {
+        pdf_ = pdf;
+    }
+
     /// Serializes this object.
     void serialize(std::ostream& out) const override
     {
@@ -102,6 +138,12 @@ public:
         pdf_.serialize(out);
         out << '\n';
 
+        // without a pdf the size of the adjustment data is not known
+        if (pdf_.bins() == 0)
+        {
+            out << adjustment_data_.size() << ' ';
+        }
+
         for (std::size_t i = 0; i != adjustment_data_.size(); ++i)
         {
             out << std::scientific << std::setprecision(std::numeric_limits<T>::max_digits10 - 1)
@@ -109,6 +151,20 @@ public:
         }
     }
 
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const override
+    {
+        plain_result<T>::serialize(out);
+        pdf_.serialize(out);
+
+        if (pdf_.bins() == 0)
+        {
+            out.write_size(adjustment_data_.size());
+        }
+
+        out.write(adjustment_data_.data(), adjustment_data_.size());
+    }
+
     static char const* result_name()
     {
         return "vegas_result";
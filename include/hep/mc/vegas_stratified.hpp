@@ -0,0 +1,200 @@
+#ifndef HEP_MC_VEGAS_STRATIFIED_HPP
+#define HEP_MC_VEGAS_STRATIFIED_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/accumulator.hpp"
+#include "hep/mc/callback.hpp"
+#include "hep/mc/integrand.hpp"
+#include "hep/mc/iteration_timing.hpp"
+#include "hep/mc/uniform_random.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+#include "hep/mc/vegas_point.hpp"
+#include "hep/mc/vegas_result.hpp"
+#include "hep/mc/vegas_stratified_chkpt.hpp"
+#include "hep/mc/vegas_stratified_result.hpp"
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup vegas_group
+/// @{
+
+/// Performs one VEGAS iteration with stratified sampling. The unit-hypercube is divided into
+/// `strata` intervals in each dimension and the hypercube with index `h` (see \ref
+/// vegas_stratified_result::hypercube_variances) is sampled `hypercube_calls[h]` times with points
+/// uniformly distributed inside it. The points are then mapped with `pdf` as in \ref
+/// vegas_iteration. The weight of each point includes the factor \f$ N / (H n_h) \f$, where
+/// \f$ N \f$ is the total number of calls, \f$ H \f$ the number of hypercubes, and
+/// \f$ n_h \f$ the number of calls of the hypercube of the point, so that the weighted sum of all
+/// calls divided by \f$ N \f$ is the estimate of the integral. Its variance is the sum of the
+/// variances of each hypercube. The errors of the distributions do not take stratification into
+/// account and therefore are conservative estimates.
+template <typename I, typename R>
+inline vegas_stratified_result<numeric_type_of<I>> vegas_stratified_iteration(
+    I&& integrand,
+    std::vector<std::size_t> const& hypercube_calls,
+    std::size_t strata,
+    vegas_pdf<numeric_type_of<I>> const& pdf,
+    R& generator
+) {
+    using T = numeric_type_of<I>;
+
+    std::size_t const dimensions = pdf.dimensions();
+    std::size_t const bins       = pdf.bins();
+    std::size_t const hypercubes = hypercube_calls.size();
+    std::size_t const calls      = std::accumulate(hypercube_calls.begin(),
+        hypercube_calls.end(), std::size_t());
+
+    auto accumulator = make_accumulator(integrand);
+
+    std::vector<T> adjustment_data(dimensions * bins);
+    std::vector<T> hypercube_variances(hypercubes);
+    std::vector<T> random_numbers(dimensions);
+    std::vector<std::size_t> bin(dimensions);
+
+    // the interval of each dimension of the current hypercube
+    std::vector<std::size_t> interval(dimensions);
+
+    T variance = T();
+
+    for (std::size_t h = 0; h != hypercubes; ++h)
+    {
+        std::size_t const n = hypercube_calls[h];
+
+        if (n != 0)
+        {
+            T const factor = T(calls) / (T(hypercubes) * T(n));
+            T sum = T();
+            T sum_of_squares = T();
+
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                generate_uniform(generator, random_numbers.data(), random_numbers.data() +
+                    dimensions);
+
+                for (std::size_t j = 0; j != dimensions; ++j)
+                {
+                    random_numbers[j] = (T(interval[j]) + random_numbers[j]) / T(strata);
+                }
+
+                vegas_point<T> const point(random_numbers, bin, pdf, factor);
+
+                T const value = accumulator.invoke(integrand, point);
+                T const square = value * value;
+
+                sum += value;
+                sum_of_squares += square;
+
+                // the squares are divided by `factor` because the grid must be adapted to the
+                // integrand and not to the distribution of the points among the hypercubes
+                for (std::size_t j = 0; j != dimensions; ++j)
+                {
+                    adjustment_data[j * bins + bin[j]] += square / factor;
+                }
+            }
+
+            if (n > 1)
+            {
+                T const sample_variance = (sum_of_squares - sum * sum / T(n)) / T(n - 1);
+                T const hypercube_variance = (sample_variance > T()) ?
+                    T(n) * sample_variance / (T(calls) * T(calls)) : T();
+
+                variance += hypercube_variance;
+                hypercube_variances[h] = T(n) * hypercube_variance;
+            }
+        }
+
+        // move to the next hypercube
+        for (std::size_t j = 0; j != dimensions; ++j)
+        {
+            if (++interval[j] != strata)
+            {
+                break;
+            }
+
+            interval[j] = 0;
+        }
+    }
+
+    return vegas_stratified_result<T>(
+        vegas_result<T>(accumulator.result(calls), pdf, adjustment_data),
+        variance,
+        strata,
+        hypercube_variances
+    );
+}
+
+/// VEGAS integrator with adaptive stratified sampling, which is similar to VEGAS+ \cite VegasPlus.
+/// Like \ref vegas it performs `iteration_calls.size()` iterations and adapts the \ref vegas_pdf
+/// after each iteration. In addition, for each iteration the unit-hypercube is divided into as many
+/// hypercubes as \ref vegas_strata allows, and the calls are distributed among them according to
+/// \ref vegas_hypercube_calls using the variances of the previous iteration. For low-dimensional
+/// integrands and integrands that are not well approximated by the separable VEGAS pdf this usually
+/// needs significantly fewer calls for the same precision. The state of the stratification is
+/// stored in the checkpoint, see \ref make_vegas_stratified_chkpt. Batch integrands are not
+/// supported.
+template <typename I, typename Checkpoint = default_vegas_stratified_chkpt<numeric_type_of<I>>,
+    typename Callback = callback<Checkpoint>>
+inline Checkpoint vegas_stratified(
+    I&& integrand,
+    std::vector<std::size_t> const& iteration_calls,
+    Checkpoint chkpt = make_vegas_stratified_chkpt<numeric_type_of<I>>(),
+    Callback callback = hep::callback<Checkpoint>()
+) {
+    std::size_t const dimensions = integrand.dimensions();
+
+    chkpt.dimensions(dimensions);
+
+    auto generator = chkpt.generator();
+    stopwatch wall_time;
+
+    for (auto const calls : iteration_calls)
+    {
+        std::size_t const strata = vegas_strata(calls, dimensions, chkpt.max_hypercubes());
+
+        auto const& pdf = chkpt.pdf();
+        auto const& hypercube_calls = chkpt.hypercube_calls(calls, strata, dimensions);
+        stopwatch integrand_time;
+        auto const& result = vegas_stratified_iteration(integrand, hypercube_calls, strata, pdf,
+            generator);
+
+        chkpt.add(result, generator, iteration_timing(wall_time.seconds(),
+            integrand_time.seconds()));
+
+        if (!callback(chkpt))
+        {
+            break;
+        }
+
+        wall_time.restart();
+    }
+
+    return chkpt;
+}
+
+/// @}
+
+}
+
+#endif
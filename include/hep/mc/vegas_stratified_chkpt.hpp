@@ -0,0 +1,295 @@
+#ifndef HEP_MC_VEGAS_STRATIFIED_CHKPT_HPP
+#define HEP_MC_VEGAS_STRATIFIED_CHKPT_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/chkpt.hpp"
+#include "hep/mc/vegas_chkpt.hpp"
+#include "hep/mc/vegas_pdf.hpp"
+#include "hep/mc/vegas_stratified_result.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup vegas_group
+/// @{
+
+/// Returns the number of intervals each of the `dimensions` of the unit-hypercube is divided into
+/// by \ref vegas_stratified for an iteration with `calls` evaluations. This is the largest number
+/// \f$ s \f$ such that \f$ s^d \f$ hypercubes do not exceed `max_hypercubes` and each
+/// hypercube can be sampled at least four times on average.
+inline std::size_t vegas_strata(
+    std::size_t calls,
+    std::size_t dimensions,
+    std::size_t max_hypercubes
+) {
+    std::size_t const limit = std::min(calls / 4, max_hypercubes);
+    std::size_t strata = 1;
+
+    for (;;)
+    {
+        std::size_t hypercubes = 1;
+
+        // calculate `(strata + 1)^dimensions` while avoiding overflows
+        for (std::size_t i = 0; (i != dimensions) && (hypercubes <= limit); ++i)
+        {
+            hypercubes *= strata + 1;
+        }
+
+        if (hypercubes > limit)
+        {
+            return strata;
+        }
+
+        ++strata;
+    }
+}
+
+/// Distributes `calls` evaluations among `hypercubes` hypercubes. If `hypercube_variances` has
+/// one entry for each hypercube, the number of calls of each hypercube is proportional to
+/// \f$ \sigma_h^\beta \f$, where \f$ \sigma_h^2 \f$ is the variance of the hypercube and
+/// \f$ \beta \f$ is given by `beta`, as proposed by VEGAS+ \cite VegasPlus; otherwise the
+/// calls are distributed uniformly. If there are enough calls, every hypercube receives at least
+/// two calls so that its variance can be estimated. The sum of the returned numbers is `calls`.
+template <typename T>
+inline std::vector<std::size_t> vegas_hypercube_calls(
+    std::size_t calls,
+    std::size_t hypercubes,
+    std::vector<T> const& hypercube_variances,
+    T beta
+) {
+    using std::pow;
+
+    std::vector<T> damped(hypercubes, T(1.0));
+
+    if (hypercube_variances.size() == hypercubes)
+    {
+        for (std::size_t i = 0; i != hypercubes; ++i)
+        {
+            damped[i] = pow(hypercube_variances[i], T(0.5) * beta);
+        }
+    }
+
+    T total = T();
+
+    for (auto const value : damped)
+    {
+        total += value;
+    }
+
+    if (!(total > T()))
+    {
+        std::fill(damped.begin(), damped.end(), T(1.0));
+        total = T(hypercubes);
+    }
+
+    std::size_t const minimum = (calls >= 2 * hypercubes) ? 2 : 0;
+    std::size_t const remaining = calls - minimum * hypercubes;
+
+    std::vector<std::size_t> result(hypercubes, minimum);
+
+    // distribute the remaining calls using the rounded cumulative sums, which guarantees that
+    // their sum is exactly `remaining`
+    T running = T();
+    std::size_t assigned = 0;
+
+    for (std::size_t i = 0; i != hypercubes; ++i)
+    {
+        running += damped[i];
+
+        std::size_t const cumulative = (i == hypercubes - 1) ? remaining :
+            std::min(remaining, static_cast <std::size_t> (T(remaining) * (running / total)));
+
+        result[i] += cumulative - assigned;
+        assigned = cumulative;
+    }
+
+    return result;
+}
+
+/// @}
+
+/// \addtogroup checkpoints
+/// @{
+
+/// Checkpoints created by \ref vegas_stratified. In addition to the parameters of \ref vegas_chkpt
+/// it stores the parameter \f$ \beta \f$, which controls the adaption of the number of calls
+/// of each hypercube, and the maximum number of hypercubes.
+template <typename T>
+class vegas_stratified_chkpt : public vegas_chkpt<T, vegas_stratified_result<T>>
+{
+public:
+    /// Constructor. Creates an empty checkpoint with a uniform \ref vegas_pdf with the specified
+    /// number of `bins`.
+    vegas_stratified_chkpt(std::size_t bins, T alpha, T beta, std::size_t max_hypercubes)
+        : vegas_chkpt<T, vegas_stratified_result<T>>{bins, alpha}
+        , beta_{beta}
+        , max_hypercubes_{max_hypercubes}
+    {
+    }
+
+    /// Constructor. Creates an empty checkpoint with the user-defined \ref vegas_pdf.
+    vegas_stratified_chkpt(vegas_pdf<T> const& pdf, T alpha, T beta, std::size_t max_hypercubes)
+        : vegas_chkpt<T, vegas_stratified_result<T>>{pdf, alpha}
+        , beta_{beta}
+        , max_hypercubes_{max_hypercubes}
+    {
+    }
+
+    /// Deserialization constructor. This creates a checkpoint by reading from the stream `in`.
+    explicit vegas_stratified_chkpt(std::istream& in)
+        : vegas_chkpt<T, vegas_stratified_result<T>>{in}
+    {
+        in >> beta_ >> max_hypercubes_;
+    }
+
+    /// Deserialization constructor for the binary format.
+    explicit vegas_stratified_chkpt(binary_reader& in)
+        : vegas_chkpt<T, vegas_stratified_result<T>>{in}
+        , beta_(in.read<T>())
+        , max_hypercubes_(in.read_size())
+    {
+    }
+
+    /// Returns the parameter \f$ \beta \f$, see \ref vegas_hypercube_calls.
+    T beta() const
+    {
+        return beta_;
+    }
+
+    /// Returns the maximum number of hypercubes, see \ref vegas_strata.
+    std::size_t max_hypercubes() const
+    {
+        return max_hypercubes_;
+    }
+
+    /// Returns the number of calls of each hypercube for the next iteration with `calls`
+    /// evaluations, if the unit-hypercube is divided into `strata` intervals in each of its
+    /// `dimensions`. If the previous iteration used the same stratification, the numbers are
+    /// adapted to the variances of its hypercubes.
+    std::vector<std::size_t> hypercube_calls(
+        std::size_t calls,
+        std::size_t strata,
+        std::size_t dimensions
+    ) const {
+        std::size_t hypercubes = 1;
+
+        for (std::size_t i = 0; i != dimensions; ++i)
+        {
+            hypercubes *= strata;
+        }
+
+        auto const& results = this->results();
+
+        if (results.empty() || (results.back().strata() != strata))
+        {
+            return vegas_hypercube_calls(calls, hypercubes, std::vector<T>(), beta_);
+        }
+
+        return vegas_hypercube_calls(calls, hypercubes, results.back().hypercube_variances(),
+            beta_);
+    }
+
+    void serialize(std::ostream& out) const override
+    {
+        vegas_chkpt<T, vegas_stratified_result<T>>::serialize(out);
+
+        out << std::scientific << std::setprecision(std::numeric_limits<T>::max_digits10 - 1)
+            << '\n' << beta_ << ' ' << max_hypercubes_;
+    }
+
+    void serialize(binary_writer& out) const override
+    {
+        vegas_chkpt<T, vegas_stratified_result<T>>::serialize(out);
+        out.write(beta_);
+        out.write_size(max_hypercubes_);
+    }
+
+private:
+    T beta_;
+    std::size_t max_hypercubes_;
+};
+
+/// Checkpoint with random number generators created by \ref vegas_stratified.
+template <typename RandomNumberEngine, typename T>
+using vegas_stratified_chkpt_with_rng = chkpt_with_rng<RandomNumberEngine,
+    vegas_stratified_chkpt<T>>;
+
+/// Helper function to create an initial checkpoint to start \ref vegas_stratified. The parameters
+/// `bins` and `alpha` are the same as for \ref make_vegas_chkpt.
+template <typename T, typename RandomNumberEngine = std::mt19937>
+vegas_stratified_chkpt_with_rng<RandomNumberEngine, T> make_vegas_stratified_chkpt(
+    std::size_t bins = 128,
+    T alpha = T(1.5),
+    T beta = T(0.75),
+    std::size_t max_hypercubes = 10000,
+    RandomNumberEngine const& rng = RandomNumberEngine()
+) {
+    return vegas_stratified_chkpt_with_rng<RandomNumberEngine, T>{rng, bins, alpha, beta,
+        max_hypercubes};
+}
+
+/// Helper function to create an initial checkpoint to start \ref vegas_stratified with a
+/// user-defined \ref vegas_pdf.
+template <typename T, typename RandomNumberEngine = std::mt19937>
+vegas_stratified_chkpt_with_rng<RandomNumberEngine, T> make_vegas_stratified_chkpt(
+    vegas_pdf<T> const& pdf,
+    T alpha = T(1.5),
+    T beta = T(0.75),
+    std::size_t max_hypercubes = 10000,
+    RandomNumberEngine const& rng = RandomNumberEngine()
+) {
+    return vegas_stratified_chkpt_with_rng<RandomNumberEngine, T>{rng, pdf, alpha, beta,
+        max_hypercubes};
+}
+
+/// Helper function create a checkpoint reading from the stream `in`. The numeric type `T` and
+/// the type of the random number generator `RandomNumberEngine` have to be stated explicitly.
+template <typename T, typename RandomNumberEngine>
+vegas_stratified_chkpt_with_rng<RandomNumberEngine, T> make_vegas_stratified_chkpt(
+    std::istream& in
+) {
+    if (in.peek() == std::istream::traits_type::eof())
+    {
+        return make_vegas_stratified_chkpt<T, RandomNumberEngine>();
+    }
+
+    return vegas_stratified_chkpt_with_rng<RandomNumberEngine, T>{in};
+}
+
+/// Return type of \ref make_vegas_stratified_chkpt with default arguments.
+template <typename T>
+using default_vegas_stratified_chkpt = decltype (make_vegas_stratified_chkpt<T>());
+
+/// @}
+
+}
+
+#endif
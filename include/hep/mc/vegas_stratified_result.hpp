@@ -0,0 +1,158 @@
+#ifndef HEP_MC_VEGAS_STRATIFIED_RESULT_HPP
+#define HEP_MC_VEGAS_STRATIFIED_RESULT_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/vegas_result.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace hep
+{
+
+/// \addtogroup results
+/// @{
+
+/// The result of a single \ref vegas_stratified_iteration. In addition to a \ref vegas_result it
+/// stores the stratification of the unit-hypercube and the variances of its hypercubes, which
+/// determine the number of calls of each hypercube in the next iteration.
+template <typename T>
+class vegas_stratified_result : public vegas_result<T>
+{
+public:
+    /// Constructor. The parameter `variance` is the variance of the expectation value, which for
+    /// stratified sampling is the sum of the variances of each hypercube.
+    vegas_stratified_result(
+        vegas_result<T> const& result,
+        T variance,
+        std::size_t strata,
+        std::vector<T> const& hypercube_variances
+    )
+        : vegas_result<T>(result)
+        , variance_(variance)
+        , strata_(strata)
+        , hypercube_variances_(hypercube_variances)
+    {
+    }
+
+    /// Deserialization constructor.
+    explicit vegas_stratified_result(std::istream& in)
+        : vegas_result<T>(in)
+    {
+        std::size_t size;
+        in >> variance_ >> strata_ >> size;
+
+        hypercube_variances_.resize(size);
+
+        for (std::size_t i = 0; i != hypercube_variances_.size(); ++i)
+        {
+            in >> hypercube_variances_.at(i);
+        }
+    }
+
+    /// Deserialization constructor for the binary format.
+    explicit vegas_stratified_result(binary_reader& in)
+        : vegas_result<T>(in)
+        , variance_(in.read<T>())
+        , strata_(in.read_size())
+        , hypercube_variances_(in.read_vector<T>())
+    {
+    }
+
+    /// Copy constructor.
+    vegas_stratified_result(vegas_stratified_result<T> const&) = default;
+
+    /// Move constructor.
+    vegas_stratified_result(vegas_stratified_result<T>&&) noexcept = default;
+
+    /// Assignment operator.
+    vegas_stratified_result& operator=(vegas_stratified_result<T> const&) = default;
+
+    /// Move assignment operator.
+    vegas_stratified_result& operator=(vegas_stratified_result<T>&&) noexcept = default;
+
+    /// Destructor.
+    ~vegas_stratified_result() override = default;
+
+    /// Variance of the expectation value, which is the sum of the variances of each hypercube.
+    T variance() const override
+    {
+        return variance_;
+    }
+
+    /// The number of intervals each dimension of the unit-hypercube was divided into.
+    std::size_t strata() const
+    {
+        return strata_;
+    }
+
+    /// For each hypercube the variance of the integrand multiplied with the volume of the
+    /// hypercube and the jacobian of the \ref vegas_pdf. The index of the hypercube with the
+    /// interval \f$ i_d \f$ in dimension \f$ d \f$ is \f$ \sum_d i_d s^d \f$, where \f$ s \f$
+    /// is \ref strata.
+    std::vector<T> const& hypercube_variances() const
+    {
+        return hypercube_variances_;
+    }
+
+    /// Serializes this object.
+    void serialize(std::ostream& out) const override
+    {
+        vegas_result<T>::serialize(out);
+
+        out << std::scientific << std::setprecision(std::numeric_limits<T>::max_digits10 - 1)
+            << '\n' << variance_ << ' ' << strata_ << ' ' << hypercube_variances_.size();
+
+        for (std::size_t i = 0; i != hypercube_variances_.size(); ++i)
+        {
+            out << ' ' << hypercube_variances_.at(i);
+        }
+    }
+
+    /// Serializes this object using the binary format.
+    void serialize(binary_writer& out) const override
+    {
+        vegas_result<T>::serialize(out);
+        out.write(variance_);
+        out.write_size(strata_);
+        out.write(hypercube_variances_);
+    }
+
+    static char const* result_name()
+    {
+        return "vegas_stratified_result";
+    }
+
+private:
+    T variance_;
+    std::size_t strata_;
+    std::vector<T> hypercube_variances_;
+};
+
+/// @}
+
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef HEP_MC_XOSHIRO256PP_HPP
+#define HEP_MC_XOSHIRO256PP_HPP
+
+/*
+ * hep-mc - A Template Library for Monte Carlo Integration
+ * Copyright (C) 2019  Christopher Schwan
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hep/mc/uniform_random.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace hep
+{
+
+/// \addtogroup random_numbers_group
+/// @{
+
+/// The xoshiro256++ random number engine by Blackman and Vigna \cite Xoshiro, which satisfies the
+/// requirements of a `RandomNumberEngine`. It generates 64-bit integers with a period of
+/// \f$ 2^{256} - 1 \f$ using only a few shifts, rotations, and additions, and its state is four
+/// 64-bit integers. Floating-point numbers are generated from its integers with the fast
+/// conversion, see \ref fast_uniform_conversion.
+class xoshiro256pp
+{
+public:
+    /// The type of the generated integers.
+    using result_type = std::uint64_t;
+
+    /// The seed used by the default constructor.
+    static constexpr result_type default_seed = 0;
+
+    /// The smallest integer generated by this engine.
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    /// The largest integer generated by this engine.
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /// Constructor. Seeds the engine with `value`, see \ref seed.
+    explicit xoshiro256pp(result_type value = default_seed)
+    {
+        seed(value);
+    }
+
+    /// Seeds the engine with `value`. The state is initialized with the splitmix64 generator as
+    /// recommended by the authors.
+    void seed(result_type value = default_seed)
+    {
+        for (auto& word : state_)
+        {
+            value += UINT64_C(0x9e3779b97f4a7c15);
+
+            result_type z = value;
+            z = (z ^ (z >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+            z = (z ^ (z >> 27)) * UINT64_C(0x94d049bb133111eb);
+            word = z ^ (z >> 31);
+        }
+    }
+
+    /// Generates the next integer.
+    result_type operator()()
+    {
+        result_type const result = rotl(state_[0] + state_[3], 23) + state_[0];
+        result_type const t = state_[1] << 17;
+
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+
+        return result;
+    }
+
+    /// Advances the state by `n` steps.
+    void discard(unsigned long long n)
+    {
+        for (; n != 0; --n)
+        {
+            operator()();
+        }
+    }
+
+    /// Advances the state by \f$ 2^{128} \f$ steps in constant time. This can be used to generate
+    /// \f$ 2^{128} \f$ non-overlapping sequences.
+    void jump()
+    {
+        result_type const polynomial[] = {
+            UINT64_C(0x180ec6d33cfd0aba),
+            UINT64_C(0xd5a61266f0c9392c),
+            UINT64_C(0xa9582618e03fc9aa),
+            UINT64_C(0x39abdc4529b1661c)
+        };
+
+        std::array<result_type, 4> state{};
+
+        for (auto const word : polynomial)
+        {
+            for (unsigned bit = 0; bit != 64; ++bit)
+            {
+                if (word & (UINT64_C(1) << bit))
+                {
+                    for (std::size_t i = 0; i != state.size(); ++i)
+                    {
+                        state[i] ^= state_[i];
+                    }
+                }
+
+                operator()();
+            }
+        }
+
+        state_ = state;
+    }
+
+    /// Returns `true` if both engines generate the same sequence.
+    friend bool operator==(xoshiro256pp const& a, xoshiro256pp const& b)
+    {
+        return a.state_ == b.state_;
+    }
+
+    /// Returns `true` if the engines generate different sequences.
+    friend bool operator!=(xoshiro256pp const& a, xoshiro256pp const& b)
+    {
+        return !(a == b);
+    }
+
+    /// Writes the state of `engine` to `out`.
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>& operator<<(
+        std::basic_ostream<CharT, Traits>& out,
+        xoshiro256pp const& engine
+    ) {
+        out << engine.state_[0];
+
+        for (std::size_t i = 1; i != engine.state_.size(); ++i)
+        {
+            out << ' ' << engine.state_[i];
+        }
+
+        return out;
+    }
+
+    /// Reads the state of `engine` from `in`.
+    template <typename CharT, typename Traits>
+    friend std::basic_istream<CharT, Traits>& operator>>(
+        std::basic_istream<CharT, Traits>& in,
+        xoshiro256pp& engine
+    ) {
+        for (auto& word : engine.state_)
+        {
+            in >> word;
+        }
+
+        return in;
+    }
+
+private:
+    static result_type rotl(result_type x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::array<result_type, 4> state_;
+};
+
+/// Enables the fast conversion to floating-point numbers for \ref xoshiro256pp.
+template <>
+struct fast_uniform_conversion<xoshiro256pp> : std::true_type
+{
+};
+
+/// @}
+
+}
+
+#endif
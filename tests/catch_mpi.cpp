@@ -1,11 +1,23 @@
 #define CATCH_CONFIG_RUNNER
 #include "catch2/catch.hpp"
 
+#include <iostream>
+
 #include <mpi.h>
 
 int main(int argc, char* argv[])
 {
-    MPI_Init(&argc, &argv);
+    // the hybrid integrators use threads, but only the main thread calls MPI
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+        std::cerr << "the MPI library does not support MPI_THREAD_FUNNELED\n";
+        MPI_Finalize();
+
+        return 1;
+    }
 
     int result = Catch::Session().run(argc, argv);
 
@@ -0,0 +1,132 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+
+    return f;
+}
+
+template <typename T>
+std::string filename(std::string const& name)
+{
+    std::string const result = "test_async_chkpt_writer_" + name + "_" +
+        std::to_string(sizeof (T));
+    std::remove(result.c_str());
+
+    return result;
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("asynchronous callback", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"));
+
+    for (auto const format : { hep::chkpt_format::text, hep::chkpt_format::binary,
+        hep::chkpt_format::journal })
+    {
+        std::string const name = filename<T>("callback");
+
+        auto const chkpt = hep::vegas(
+            integrand,
+            std::vector<std::size_t>(5, 1000),
+            hep::make_vegas_chkpt<T>(),
+            hep::callback<chkpt_type>(hep::callback_mode::silent_and_write_chkpt, name, T(),
+                format, true)
+        );
+
+        // the last checkpoint has been written when the integrator returns
+        CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpt) );
+
+        std::remove(name.c_str());
+    }
+}
+
+TEMPLATE_TEST_CASE("async_chkpt_writer", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    std::string const name = filename<T>("writer");
+
+    std::vector<chkpt_type> chkpts;
+    chkpts.push_back(hep::make_vegas_chkpt<T>());
+    chkpts.back().dimensions(2);
+
+    for (std::size_t i = 0; i != 5; ++i)
+    {
+        chkpts.push_back(hep::vegas(
+            hep::make_integrand<T>(function<T>, 2, hep::make_dist_params<T>(4, T(0.0), T(1.0),
+                "x")),
+            std::vector<std::size_t>(1, 1000),
+            chkpts.back(),
+            hep::callback<chkpt_type>(hep::callback_mode::silent)
+        ));
+    }
+
+    for (auto const format : { hep::chkpt_format::binary, hep::chkpt_format::journal })
+    {
+        {
+            hep::async_chkpt_writer<chkpt_type> writer(name, format);
+
+            // all checkpoints but the first are handed over as single iterations
+            for (auto const& chkpt : chkpts)
+            {
+                writer.write(chkpt);
+            }
+
+            writer.flush();
+
+            // after a flush the newest checkpoint is on disk
+            CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpts.back()) );
+
+            // a rollback replaces the copy of the writer, and later iterations are added to it
+            writer.write(chkpts.at(2));
+            writer.write(chkpts.at(3));
+            writer.flush();
+
+            CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpts.at(3)) );
+
+            writer.write(chkpts.front());
+        }
+
+        // the destructor writes the last checkpoint
+        CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpts.front()) );
+
+        std::remove(name.c_str());
+    }
+
+    // errors are reported by the next call of `flush` or `write`
+    hep::async_chkpt_writer<chkpt_type> writer("non-existing-directory/chkpt",
+        hep::chkpt_format::text);
+
+    writer.write(chkpts.back());
+
+    CHECK_THROWS_AS( writer.flush(), std::runtime_error );
+    CHECK_NOTHROW( writer.flush() );
+}
@@ -0,0 +1,212 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T value(T x, T y)
+{
+    // vanishes in a part of the hypercube to check that zero values are handled correctly
+    return (x < T(0.1)) ? T() : T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    return value(point.point()[0], point.point()[1]);
+}
+
+template <typename T>
+void batch_function(hep::mc_batch<T> const& batch, std::vector<T>& values)
+{
+    REQUIRE( batch.size() <= batch.capacity() );
+    REQUIRE( values.size() == batch.capacity() );
+    REQUIRE( batch.dimensions() == 2 );
+
+    T const* x = batch.point(0);
+    T const* y = batch.point(1);
+
+    for (std::size_t i = 0; i != batch.size(); ++i)
+    {
+        values[i] = value(x[i], y[i]);
+    }
+}
+
+template <typename T>
+void vegas_batch_function(hep::vegas_batch<T> const& batch, std::vector<T>& values)
+{
+    for (std::size_t i = 0; i != batch.size(); ++i)
+    {
+        CHECK( batch.bin(0)[i] < 8 );
+        CHECK( batch.bin(1)[i] < 8 );
+    }
+
+    batch_function(batch, values);
+}
+
+template <typename T>
+T multi_channel_function(hep::multi_channel_point<T> const& point)
+{
+    return value(point.coordinates()[0], point.coordinates()[1]);
+}
+
+template <typename T>
+void multi_channel_batch_function(
+    hep::multi_channel_batch<T> const& batch,
+    std::vector<T>& values
+) {
+    REQUIRE( batch.map_dimensions() == 2 );
+
+    T const* x = batch.coordinates(0);
+    T const* y = batch.coordinates(1);
+
+    for (std::size_t i = 0; i != batch.size(); ++i)
+    {
+        CHECK( batch.channels()[i] < 3 );
+        CHECK( batch.point(1)[i] == y[i] );
+
+        values[i] = value(x[i], y[i]);
+    }
+}
+
+template <typename T>
+T densities(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t const enabled : enabled_channels)
+        {
+            densities[enabled] = (enabled == 2) ? T(2.0) * coordinates[0] : T(1.0);
+        }
+
+        return T(1.0) / densities[channel];
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    if (channel == 2)
+    {
+        // map with the density `2 * x`
+        coordinates[0] = std::sqrt(random_numbers[0]);
+    }
+
+    return T(1.0);
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("batch integrand with plain", "", float, double)
+{
+    using T = TestType;
+
+    // the last batch of each iteration is not full
+    std::vector<std::size_t> const calls(3, 1000);
+
+    auto const reference = hep::plain(
+        hep::make_integrand<T>(function<T>, 2),
+        calls,
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    for (std::size_t const batch_size : { 1, 96, 1000, 4096 })
+    {
+        auto const chkpt = hep::plain(
+            hep::make_batch_integrand<T>(batch_function<T>, 2, batch_size),
+            calls,
+            hep::make_plain_chkpt<T>(),
+            hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        CHECK( chkpt.results().back().non_zero_calls() < 1000 );
+        CHECK( serialize(chkpt) == serialize(reference) );
+    }
+
+    auto const parallel = hep::parallel_plain(
+        2,
+        hep::make_batch_integrand<T>(batch_function<T>, 2, 96),
+        calls,
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    CHECK( serialize(parallel) == serialize(hep::parallel_plain(
+        2,
+        hep::make_integrand<T>(function<T>, 2),
+        calls,
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    )) );
+}
+
+TEMPLATE_TEST_CASE("batch integrand with vegas", "", float, double)
+{
+    using T = TestType;
+
+    std::vector<std::size_t> const calls(5, 1000);
+
+    auto const reference = hep::vegas(
+        hep::make_integrand<T>(function<T>, 2),
+        calls,
+        hep::make_vegas_chkpt<T>(8),
+        hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    for (std::size_t const batch_size : { 1, 96, 1000, 4096 })
+    {
+        auto const chkpt = hep::vegas(
+            hep::make_batch_integrand<T>(vegas_batch_function<T>, 2, batch_size),
+            calls,
+            hep::make_vegas_chkpt<T>(8),
+            hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        CHECK( serialize(chkpt) == serialize(reference) );
+    }
+}
+
+TEMPLATE_TEST_CASE("batch integrand with multi_channel", "", float, double)
+{
+    using T = TestType;
+
+    std::vector<std::size_t> const calls(5, 1000);
+    std::vector<T> const weights = { T(1.0), T(1.0), T(1.0) };
+
+    auto const reference = hep::multi_channel(
+        hep::make_multi_channel_integrand<T>(multi_channel_function<T>, 2, densities<T>, 2, 3),
+        calls,
+        hep::make_multi_channel_chkpt<T>(weights),
+        hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    for (std::size_t const batch_size : { 1, 96, 1000, 4096 })
+    {
+        auto const chkpt = hep::multi_channel(
+            hep::make_multi_channel_batch_integrand<T>(multi_channel_batch_function<T>, 2,
+                densities<T>, 2, 3, batch_size),
+            calls,
+            hep::make_multi_channel_chkpt<T>(weights),
+            hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        CHECK( serialize(chkpt) == serialize(reference) );
+    }
+}
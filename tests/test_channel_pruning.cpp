@@ -0,0 +1,148 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// the channels with indices smaller than `stripes` sample a stripe of the unit interval each, the
+// last one samples the entire interval
+std::size_t const stripes = 10;
+
+template <typename T>
+T function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.coordinates().at(0);
+
+    // the stripes in the upper half contribute very little
+    return (x < T(0.5)) ? T(24.0) * x * x : T(1e-3);
+}
+
+template <typename T>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_coordinates)
+    {
+        T const x = random_numbers.at(0);
+        coordinates.at(0) = (channel == stripes) ? x : ((T(channel) + x) / T(stripes));
+
+        return T(1.0);
+    }
+
+    T const x = coordinates.at(0);
+    std::size_t const stripe = std::min(static_cast <std::size_t> (x * T(stripes)), stripes - 1);
+
+    // only the densities of the enabled channels are needed
+    for (std::size_t const channel : enabled_channels)
+    {
+        densities.at(channel) = (channel == stripes) ? T(1.0) :
+            ((channel == stripe) ? T(stripes) : T());
+    }
+
+    return T(1.0);
+}
+
+template <typename T>
+hep::default_multi_channel_chkpt<T> integrate(
+    hep::default_multi_channel_chkpt<T> const& chkpt,
+    std::size_t iterations
+) {
+    return hep::multi_channel(
+        hep::make_multi_channel_integrand<T>(function<T>, 1, map<T>, 1, stripes + 1),
+        std::vector<std::size_t>(iterations, 10000),
+        chkpt,
+        hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+    );
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+template <typename C>
+std::string serialize_binary(C const& chkpt)
+{
+    std::ostringstream out;
+    hep::binary_writer writer(out);
+    chkpt.serialize(writer);
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("pruning of channels", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_chkpt<T>;
+
+    auto initial = hep::make_multi_channel_chkpt<T>(T(0.01));
+
+    // without pruning the channels of the upper half keep the minimum weight
+    auto const unpruned = integrate<T>(initial, 4);
+
+    CHECK( unpruned.pruned() == std::vector<std::size_t>(stripes + 1) );
+    CHECK( unpruned.channel_weights().at(stripes - 1) > T() );
+    CHECK( serialize(unpruned).find("pruning") == std::string::npos );
+
+    initial.pruning(T(1e-3), 2);
+
+    CHECK( initial.prune_threshold() == T(1e-3) );
+    CHECK( initial.prune_iterations() == 2 );
+
+    auto const chkpt = integrate<T>(initial, 6);
+    auto const& results = chkpt.results();
+
+    // the channels in the upper half are pruned after their second iteration with a negligible
+    // contribution, and disabled in the third one
+    for (std::size_t i = 0; i != stripes + 1; ++i)
+    {
+        bool const upper = (i >= stripes / 2) && (i != stripes);
+
+        CHECK( chkpt.pruned().at(i) == (upper ? 2 : 0) );
+        CHECK( (results.at(1).channel_weights().at(i) == T()) == false );
+        CHECK( (results.at(2).channel_weights().at(i) == T()) == upper );
+        CHECK( (chkpt.channel_weights().at(i) == T()) == upper );
+    }
+
+    for (auto const& result : results)
+    {
+        CHECK_THAT( result.value(), Catch::WithinAbs(T(1.0005), T(5.0) * result.error()) );
+    }
+
+    // resuming from a serialized checkpoint reproduces the pruning and the results
+    auto const first = integrate<T>(initial, 2);
+
+    std::istringstream in(serialize(first));
+    chkpt_type const text(in);
+
+    std::string const data = serialize_binary(first);
+    hep::binary_reader reader(data.data(), data.size());
+    chkpt_type const binary(reader);
+
+    for (auto const* copy : { &text, &binary })
+    {
+        CHECK( copy->prune_threshold() == T(1e-3) );
+        CHECK( copy->prune_iterations() == 2 );
+        CHECK( copy->pruned() == first.pruned() );
+        CHECK( copy->channel_weights() == first.channel_weights() );
+        CHECK( serialize(integrate<T>(*copy, 4)) == serialize(chkpt) );
+    }
+
+    // the decisions are made again after a rollback
+    auto rolled_back = chkpt;
+    rolled_back.rollback(1);
+
+    CHECK( rolled_back.pruned() == std::vector<std::size_t>(stripes + 1) );
+    CHECK( serialize(integrate<T>(rolled_back, 5)) == serialize(chkpt) );
+}
@@ -0,0 +1,112 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+T function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+
+    // channel zero has a weight of zero and must never be selected
+    CHECK( point.channel() != 0 );
+
+    return T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+T densities(
+    std::size_t /*channel*/,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t channel : enabled_channels)
+        {
+            densities[channel] = T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    return T(1.0);
+}
+
+TEST_CASE("multi_channel with alias tables")
+{
+    using T = double;
+    using chkpt_type = hep::default_multi_channel_chkpt<T>;
+
+    std::vector<T> const weights = { T(), T(1.0), T(2.0), T(4.0), T(1.0) };
+    auto integrand = hep::make_multi_channel_integrand<T>(function<T>, 2, densities<T>, 2,
+        weights.size());
+    std::vector<std::size_t> const iteration_calls(4, 10000);
+    auto const chkpt = hep::make_multi_channel_chkpt<T>(weights);
+    hep::callback<chkpt_type> callback(hep::callback_mode::silent);
+
+    auto const sequential = hep::multi_channel<hep::alias_selection>(integrand, iteration_calls,
+        chkpt, callback);
+
+    for (auto const& result : sequential.results())
+    {
+        CHECK( result.calls() == 10000 );
+        CHECK_THAT( result.value(), Catch::WithinAbs(1.0, 5.0 * result.error()) );
+    }
+
+    // the parallel integrator selects the same channels with any number of threads
+    auto const two = hep::parallel_multi_channel<hep::alias_selection>(2, integrand,
+        iteration_calls, chkpt, callback);
+    auto const three = hep::parallel_multi_channel<hep::alias_selection>(3, integrand,
+        iteration_calls, chkpt, callback);
+
+    REQUIRE( two.results().size() == sequential.results().size() );
+    REQUIRE( three.results().size() == sequential.results().size() );
+
+    for (std::size_t i = 0; i != sequential.results().size(); ++i)
+    {
+        CHECK( two.results().at(i).value() == three.results().at(i).value() );
+        CHECK( two.results().at(i).error() == three.results().at(i).error() );
+        double const expected = sequential.results().at(i).value();
+
+        CHECK_THAT( two.results().at(i).value(),
+            Catch::WithinAbs(expected, 1e-12 * std::abs(expected)) );
+    }
+
+    // a single thread uses the same policy as the sequential integrator
+    auto const one = hep::parallel_multi_channel<hep::alias_selection>(1, integrand,
+        iteration_calls, chkpt, callback);
+
+    CHECK( one.results().back().value() == sequential.results().back().value() );
+
+    // the policy is chosen for each integration, and the default selects other channels
+    std::vector<std::size_t> alias_channels;
+    std::vector<std::size_t> cumulative_channels;
+
+    auto const record = [](std::vector<std::size_t>& channels) {
+        return hep::make_multi_channel_integrand<T>(
+            [&](hep::multi_channel_point<T> const& point) {
+                channels.push_back(point.channel());
+                return T(1.0);
+            }, 2, densities<T>, 2, 5);
+    };
+
+    hep::multi_channel<hep::alias_selection>(record(alias_channels), iteration_calls, chkpt,
+        callback);
+    hep::multi_channel(record(cumulative_channels), iteration_calls, chkpt, callback);
+
+    CHECK( alias_channels.size() == cumulative_channels.size() );
+    CHECK( alias_channels != cumulative_channels );
+}
@@ -0,0 +1,361 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+
+    return f;
+}
+
+template <typename T>
+T multi_channel_function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.coordinates()[0];
+    T const y = point.coordinates()[1];
+
+    return T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t const enabled : enabled_channels)
+        {
+            densities[enabled] = (enabled == 1) ? T(2.0) * coordinates[0] : T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    if (channel == 1)
+    {
+        coordinates[0] = std::sqrt(random_numbers[0]);
+    }
+
+    return T(1.0);
+}
+
+template <typename T>
+std::string filename(std::string const& name)
+{
+    std::string const result = "test_chkpt_io_" + name + "_" + std::to_string(sizeof (T));
+    std::remove(result.c_str());
+
+    return result;
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+std::string read_file(std::string const& name)
+{
+    std::ifstream in(name, std::ios::binary);
+
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// saves `chkpt` in both formats and checks that both are loaded into identical checkpoints
+template <typename C>
+void check_round_trip(C const& chkpt, std::string const& name)
+{
+    hep::save_chkpt(chkpt, name + ".txt");
+    hep::save_chkpt(chkpt, name + ".bin", hep::chkpt_format::binary);
+
+    auto const from_text = hep::load_chkpt<C>(name + ".txt");
+    auto const from_binary = hep::load_chkpt<C>(name + ".bin");
+
+    CHECK( serialize(from_text) == serialize(chkpt) );
+    CHECK( serialize(from_binary) == serialize(chkpt) );
+
+    // binary checkpoints with results are smaller than text checkpoints
+    if (!chkpt.results().empty())
+    {
+        CHECK( read_file(name + ".bin").size() < read_file(name + ".txt").size() );
+    }
+
+    // converting a text checkpoint into a binary one and back does not change it
+    hep::convert_chkpt<C>(name + ".txt", name + ".converted.bin", hep::chkpt_format::binary);
+    hep::convert_chkpt<C>(name + ".converted.bin", name + ".converted.txt",
+        hep::chkpt_format::text);
+
+    CHECK( read_file(name + ".converted.bin") == read_file(name + ".bin") );
+    CHECK( read_file(name + ".converted.txt") == read_file(name + ".txt") );
+
+    for (auto const& suffix : { ".txt", ".bin", ".converted.bin", ".converted.txt" })
+    {
+        std::remove((name + suffix).c_str());
+    }
+}
+
+TEMPLATE_TEST_CASE("binary checkpoints of vegas", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"));
+
+    // an empty checkpoint stores the grid once its dimensions are known
+    auto empty = hep::make_vegas_chkpt<T>(16);
+    empty.dimensions(2);
+
+    check_round_trip(empty, filename<T>("vegas_empty"));
+
+    auto const chkpt = hep::vegas(
+        integrand,
+        std::vector<std::size_t>(3, 1000),
+        hep::make_vegas_chkpt<T>(16),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    std::string const name = filename<T>("vegas");
+
+    check_round_trip(chkpt, name);
+
+    hep::save_chkpt(chkpt, name, hep::chkpt_format::binary);
+    auto const restored = hep::load_chkpt<chkpt_type>(name);
+    std::remove(name.c_str());
+
+    CHECK( restored.results().back().distributions().at(0).parameters().name() == "x" );
+
+    // resuming from a binary checkpoint gives the same results as performing all iterations at once
+    auto const resumed = hep::vegas(
+        integrand,
+        std::vector<std::size_t>(2, 1000),
+        restored,
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const complete = hep::vegas(
+        integrand,
+        std::vector<std::size_t>(5, 1000),
+        hep::make_vegas_chkpt<T>(16),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    CHECK( serialize(resumed) == serialize(complete) );
+}
+
+TEMPLATE_TEST_CASE("binary checkpoints of other integrators", "", float, double)
+{
+    using T = TestType;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2,
+        hep::make_dist_params<T>(4, T(0.0), T(1.0), "x"));
+    auto multi_channel_integrand = hep::make_multi_channel_integrand<T>(multi_channel_function<T>,
+        2, map<T>, 2, 2);
+    std::vector<T> const weights = { T(1.0), T(1.0) };
+
+    check_round_trip(hep::plain(
+        integrand,
+        std::vector<std::size_t>(2, 1000),
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    ), filename<T>("plain"));
+
+    check_round_trip(hep::vegas_stratified(
+        integrand,
+        std::vector<std::size_t>(2, 1000),
+        hep::make_vegas_stratified_chkpt<T>(8),
+        hep::callback<hep::default_vegas_stratified_chkpt<T>>(hep::callback_mode::silent)
+    ), filename<T>("vegas_stratified"));
+
+    check_round_trip(hep::make_multi_channel_chkpt<T>(weights),
+        filename<T>("multi_channel_empty"));
+
+    check_round_trip(hep::multi_channel(
+        multi_channel_integrand,
+        std::vector<std::size_t>(2, 1000),
+        hep::make_multi_channel_chkpt<T>(weights),
+        hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+    ), filename<T>("multi_channel"));
+
+    auto empty = hep::make_multi_channel_vegas_chkpt<T>(weights, 8);
+    empty.dimensions(2);
+
+    check_round_trip(empty, filename<T>("multi_channel_vegas_empty"));
+
+    check_round_trip(hep::multi_channel_vegas(
+        multi_channel_integrand,
+        std::vector<std::size_t>(2, 1000),
+        hep::make_multi_channel_vegas_chkpt<T>(weights, 8),
+        hep::callback<hep::default_multi_channel_vegas_chkpt<T>>(hep::callback_mode::silent)
+    ), filename<T>("multi_channel_vegas"));
+}
+
+TEMPLATE_TEST_CASE("callback writing binary checkpoints", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    std::string const name = filename<T>("callback");
+
+    auto const chkpt = hep::vegas(
+        hep::make_integrand<T>(function<T>, 2, hep::make_dist_params<T>(4, T(0.0), T(1.0))),
+        std::vector<std::size_t>(2, 1000),
+        hep::make_vegas_chkpt<T>(),
+        hep::callback<chkpt_type>(hep::callback_mode::silent_and_write_chkpt, name, T(),
+            hep::chkpt_format::binary)
+    );
+
+    std::string const contents = read_file(name);
+
+    CHECK( hep::is_binary_chkpt(contents.data(), contents.size()) );
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpt) );
+
+    std::remove(name.c_str());
+}
+
+TEMPLATE_TEST_CASE("binary checkpoints with errors", "", float, double)
+{
+    using T = TestType;
+
+    std::string const name = filename<T>("errors");
+
+    auto const chkpt = hep::plain(
+        hep::make_integrand<T>(function<T>, 2, hep::make_dist_params<T>(4, T(0.0), T(1.0))),
+        std::vector<std::size_t>(1, 100),
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    hep::save_chkpt(chkpt, name, hep::chkpt_format::binary);
+
+    // the type of the checkpoint is checked
+    CHECK_THROWS_AS( hep::load_chkpt<hep::default_vegas_chkpt<T>>(name), std::runtime_error );
+    CHECK_THROWS_AS( hep::load_chkpt<hep::default_plain_chkpt<long double>>(name),
+        std::runtime_error );
+
+    // truncated files are detected
+    std::string const contents = read_file(name);
+
+    for (std::size_t size : { std::size_t(12), std::size_t(20), contents.size() / 2 })
+    {
+        std::ofstream(name, std::ios::binary).write(contents.data(), size);
+
+        CHECK_THROWS_AS( hep::load_chkpt<hep::default_plain_chkpt<T>>(name), std::runtime_error );
+    }
+
+    std::ofstream(name, std::ios::binary);
+
+    CHECK_THROWS_AS( hep::load_chkpt<hep::default_plain_chkpt<T>>(name), std::runtime_error );
+    CHECK_THROWS_AS( hep::load_chkpt<hep::default_plain_chkpt<T>>(name + ".missing"),
+        std::runtime_error );
+
+    std::remove(name.c_str());
+}
+
+template <typename U>
+void append_swapped(std::string& data, U value)
+{
+    char bytes[sizeof (U)];
+    std::memcpy(bytes, &value, sizeof (U));
+    std::reverse(bytes, bytes + sizeof (U));
+    data.append(bytes, sizeof (U));
+}
+
+TEMPLATE_TEST_CASE("binary_reader", "", float, double)
+{
+    using T = TestType;
+
+    std::vector<T> const values = { T(1.0), T(-0.125), T(3e10) };
+
+    std::ostringstream out;
+    hep::binary_writer writer(out);
+    writer.write(T(0.5));
+    writer.write(values);
+    writer.write(std::string("name"));
+
+    std::string const data = out.str();
+    hep::binary_reader reader(data.data(), data.size());
+
+    CHECK( !reader.swap_bytes() );
+    CHECK( reader.read<T>() == T(0.5) );
+    CHECK( reader.read_vector<T>() == values );
+    CHECK( reader.read_string() == "name" );
+    CHECK( reader.remaining() == 0 );
+    CHECK_THROWS_AS( reader.read<T>(), std::runtime_error );
+
+    // the same data written on a machine with the opposite byte order
+    std::string swapped = data.substr(0, 8);
+    append_swapped(swapped, std::uint32_t(0x01020304));
+    append_swapped(swapped, std::uint32_t(1));
+    append_swapped(swapped, T(0.5));
+    append_swapped(swapped, std::uint64_t(values.size()));
+
+    for (T const value : values)
+    {
+        append_swapped(swapped, value);
+    }
+
+    append_swapped(swapped, std::uint64_t(4));
+    swapped += "name";
+
+    hep::binary_reader swapped_reader(swapped.data(), swapped.size());
+
+    CHECK( swapped_reader.swap_bytes() );
+    CHECK( swapped_reader.read<T>() == T(0.5) );
+    CHECK( swapped_reader.read_vector<T>() == values );
+    CHECK( swapped_reader.read_string() == "name" );
+
+    // older versions are accepted, unknown versions are rejected
+    std::string past = data;
+    past[12] = char(1);
+
+    CHECK( hep::binary_reader(past.data(), past.size()).version() == 1 );
+
+    std::string future = data;
+    future[12] = char(hep::binary_chkpt_version + 1);
+
+    CHECK_THROWS_AS( hep::binary_reader(future.data(), future.size()), std::runtime_error );
+
+    // corrupt sizes whose number of bytes overflows are detected before allocating memory
+    std::ostringstream corrupt;
+    hep::binary_writer corrupt_writer(corrupt);
+    corrupt_writer.write_size(std::numeric_limits<std::size_t>::max() / 2 + 1);
+    corrupt_writer.write_size(2);
+    corrupt_writer.write(values);
+
+    std::string const corrupt_data = corrupt.str();
+    hep::binary_reader vector_reader(corrupt_data.data(), corrupt_data.size());
+    hep::binary_reader pdf_reader(corrupt_data.data(), corrupt_data.size());
+
+    CHECK_THROWS_AS( vector_reader.read_vector<T>(), std::runtime_error );
+    CHECK_THROWS_AS( hep::vegas_pdf<T>(pdf_reader), std::runtime_error );
+}
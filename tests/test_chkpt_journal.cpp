@@ -0,0 +1,177 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+
+    return f;
+}
+
+template <typename T>
+std::string filename(std::string const& name)
+{
+    std::string const result = "test_chkpt_journal_" + name + "_" + std::to_string(sizeof (T));
+    std::remove(result.c_str());
+
+    return result;
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+std::string read_file(std::string const& name)
+{
+    std::ifstream in(name, std::ios::binary);
+
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_file(std::string const& name, std::string const& contents)
+{
+    std::ofstream(name, std::ios::binary).write(contents.data(), contents.size());
+}
+
+TEMPLATE_TEST_CASE("journal written by callback", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"));
+
+    auto const run = [&](std::size_t iterations, chkpt_type const& chkpt, std::string const& name) {
+        return hep::vegas(
+            integrand,
+            std::vector<std::size_t>(iterations, 1000),
+            chkpt,
+            name.empty()
+                ? hep::callback<chkpt_type>(hep::callback_mode::silent)
+                : hep::callback<chkpt_type>(hep::callback_mode::silent_and_write_chkpt, name, T(),
+                    hep::chkpt_format::journal)
+        );
+    };
+
+    std::string const name = filename<T>("vegas");
+
+    auto const chkpt = run(5, hep::make_vegas_chkpt<T>(16), name);
+    std::string const journal = read_file(name);
+
+    CHECK( hep::is_chkpt_journal(journal.data(), journal.size()) );
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpt) );
+
+    // the journal contains a single snapshot with one result and four appended results, which is
+    // smaller than the binary checkpoint written after the last iteration
+    std::string const binary_name = filename<T>("vegas_binary");
+    hep::save_chkpt(chkpt, binary_name, hep::chkpt_format::binary);
+
+    CHECK( journal.size() < read_file(binary_name).size() + read_file(binary_name).size() / 4 );
+
+    std::remove(binary_name.c_str());
+
+    auto const four_iterations = run(4, hep::make_vegas_chkpt<T>(16), "");
+
+    // a record that was not written completely is ignored
+    write_file(name, journal.substr(0, journal.size() - 10));
+
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(four_iterations) );
+
+    // a record whose contents are damaged is ignored as well
+    std::string damaged = journal;
+    damaged[damaged.size() - 100] ^= 1;
+    write_file(name, damaged);
+
+    auto const restored = hep::load_chkpt<chkpt_type>(name);
+
+    CHECK( serialize(restored) == serialize(four_iterations) );
+
+    // resuming from the journal first writes a snapshot and then appends again
+    auto const resumed = run(2, restored, name);
+    auto const complete = run(6, hep::make_vegas_chkpt<T>(16), "");
+
+    CHECK( serialize(resumed) == serialize(complete) );
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(complete) );
+
+    // a journal without a complete snapshot can not be loaded
+    write_file(name, journal.substr(0, 100));
+
+    CHECK_THROWS_AS( hep::load_chkpt<chkpt_type>(name), std::runtime_error );
+
+    std::remove(name.c_str());
+}
+
+TEMPLATE_TEST_CASE("journal of multi_channel_vegas", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_vegas_chkpt<T>;
+
+    auto integrand = hep::make_multi_channel_integrand<T>(
+        [](hep::multi_channel_point<T> const& point) {
+            return point.coordinates()[0] * point.coordinates()[1];
+        },
+        2,
+        [](std::size_t, std::vector<T> const& random_numbers, std::vector<T>& coordinates,
+            std::vector<std::size_t> const& enabled_channels, std::vector<T>& densities,
+            hep::multi_channel_map action) {
+            if (action == hep::multi_channel_map::calculate_densities)
+            {
+                for (std::size_t const enabled : enabled_channels)
+                {
+                    densities[enabled] = T(1.0);
+                }
+            }
+            else
+            {
+                coordinates = random_numbers;
+            }
+
+            return T(1.0);
+        },
+        2,
+        2
+    );
+
+    std::string const name = filename<T>("multi_channel_vegas");
+
+    auto const chkpt = hep::multi_channel_vegas(
+        integrand,
+        std::vector<std::size_t>(3, 1000),
+        hep::make_multi_channel_vegas_chkpt<T>(8),
+        hep::callback<chkpt_type>(hep::callback_mode::silent_and_write_chkpt, name, T(),
+            hep::chkpt_format::journal)
+    );
+
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpt) );
+
+    // journals can be converted into the other formats and back
+    std::string const text_name = filename<T>("multi_channel_vegas_text");
+    hep::convert_chkpt<chkpt_type>(name, text_name, hep::chkpt_format::text);
+
+    CHECK( read_file(text_name) == serialize(chkpt) );
+
+    hep::convert_chkpt<chkpt_type>(text_name, name, hep::chkpt_format::journal);
+
+    CHECK( serialize(hep::load_chkpt<chkpt_type>(name)) == serialize(chkpt) );
+
+    std::remove(text_name.c_str());
+    std::remove(name.c_str());
+}
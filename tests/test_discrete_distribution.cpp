@@ -2,9 +2,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <cmath>
 #include <cstddef>
 #include <limits>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 TEMPLATE_TEST_CASE("discrete_distribution with no bins", "", float, double, long double)
@@ -74,3 +76,68 @@ TEMPLATE_TEST_CASE("discrete_distribution with two bins", "", float, double, lon
     CHECK( distribution(rng) == 1u );
     CHECK( distribution(rng) == 0u );
 }
+
+TEMPLATE_TEST_CASE("alias_distribution with no bins and one bin", "", float, double, long double)
+{
+    using T = TestType;
+
+    std::mt19937_64 rng;
+    std::vector<T> no_weights;
+    std::vector<T> weights{T(1.0)};
+
+    hep::alias_distribution<std::size_t, T> none{no_weights.begin(), no_weights.end()};
+    hep::alias_distribution<std::size_t, T> one{weights.begin(), weights.end()};
+
+    for (std::size_t i = 0; i != 5; ++i)
+    {
+        CHECK( none(rng) == 0u );
+        CHECK( one(rng) == 0u );
+    }
+}
+
+TEMPLATE_TEST_CASE("alias_distribution frequencies", "", float, double, long double)
+{
+    using std::sqrt;
+    using T = TestType;
+
+    std::mt19937_64 rng;
+    std::vector<T> weights{T(1.0), T(0.0), T(5.0), T(0.5), T(2.5), T(0.0), T(1.0)};
+    std::vector<std::size_t> counts(weights.size());
+
+    hep::alias_distribution<std::size_t, T> distribution{weights.begin(), weights.end()};
+
+    std::size_t const samples = 100000;
+
+    // each integer uses a single random number, which the multi channel integrators rely on
+    auto copy = rng;
+
+    for (std::size_t i = 0; i != samples; ++i)
+    {
+        ++counts.at(distribution(rng));
+        hep::generate_uniform<T>(copy);
+    }
+
+    CHECK( rng == copy );
+
+    for (std::size_t i = 0; i != weights.size(); ++i)
+    {
+        double const p = double(weights.at(i)) / 10.0;
+        double const expected = p * samples;
+        double const sigma = sqrt(samples * p * (1.0 - p));
+
+        CHECK( double(counts.at(i)) >= expected - 5.0 * sigma );
+        CHECK( double(counts.at(i)) <= expected + 5.0 * sigma );
+    }
+
+    // channels with zero weight are never selected
+    CHECK( counts.at(1) == 0u );
+    CHECK( counts.at(5) == 0u );
+}
+
+TEST_CASE("selection policies")
+{
+    CHECK( std::is_same<hep::discrete_distribution<std::size_t, double>,
+        hep::cumulative_distribution<std::size_t, double>>::value );
+    CHECK( std::is_same<hep::discrete_distribution<std::size_t, double, hep::alias_selection>,
+        hep::alias_distribution<std::size_t, double>>::value );
+}
@@ -0,0 +1,314 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <typename T>
+T value(T x, T y)
+{
+    // vanishes in a part of the hypercube so that not every point is an event
+    return (x < T(0.25)) ? T() : T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    return value(point.point()[0], point.point()[1]);
+}
+
+template <typename T>
+T function_with_distribution(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const f = function(point);
+
+    projector.add(0, point.point()[0], f);
+
+    return f;
+}
+
+template <typename T>
+T multi_channel_function(hep::multi_channel_point<T> const& point)
+{
+    return value(point.coordinates()[0], point.coordinates()[1]);
+}
+
+template <typename T>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t const enabled : enabled_channels)
+        {
+            densities[enabled] = (enabled == 1) ? T(2.0) * coordinates[0] : T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    if (channel == 1)
+    {
+        // map with the density `2 * x`
+        coordinates[0] = std::sqrt(random_numbers[0]);
+    }
+
+    return T(1.0);
+}
+
+template <typename T>
+std::string filename(std::string const& name)
+{
+    std::string const result = "test_event_writer_" + name + "_" + std::to_string(sizeof (T)) +
+        ".bin";
+    std::remove(result.c_str());
+
+    return result;
+}
+
+template <typename T>
+T sum_of_weights(std::vector<hep::event<T>> const& events)
+{
+    long double sum = 0.0;
+
+    for (auto const& event : events)
+    {
+        sum += event.weight;
+    }
+
+    return T(sum);
+}
+
+TEMPLATE_TEST_CASE("event_writer with plain", "", float, double)
+{
+    using T = TestType;
+
+    std::string const file = filename<T>("plain");
+    std::size_t non_zero_calls = 0;
+
+    T result_value;
+
+    {
+        hep::event_writer<T> writer(file, 2, 1000);
+
+        auto const chkpt = hep::plain(
+            hep::make_integrand<T>(hep::make_event_function(function<T>, writer), 2),
+            std::vector<std::size_t>{ 10000 },
+            hep::make_plain_chkpt<T>(),
+            hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        non_zero_calls = chkpt.results().front().non_zero_calls();
+        result_value = chkpt.results().front().value();
+
+        CHECK( writer.events() == non_zero_calls );
+    }
+
+    auto const events = hep::read_events<T>(file);
+
+    REQUIRE( events.size() == non_zero_calls );
+    CHECK( non_zero_calls < 10000 );
+
+    for (auto const& event : events)
+    {
+        CHECK( event.channel == 0 );
+        CHECK( event.coordinates.size() == 2 );
+        CHECK( event.value == value(event.coordinates[0], event.coordinates[1]) );
+        CHECK( event.value != T() );
+    }
+
+    // the weights of the events add up to the integral
+    CHECK_THAT( sum_of_weights(events) / T(10000.0),
+        Catch::WithinAbs(result_value, T(1e-4) * std::abs(result_value)) );
+
+    // a second writer appends to the same file
+    {
+        hep::event_writer<T> writer(file, 2);
+
+        hep::vegas(
+            hep::make_integrand<T>(hep::make_event_function(function_with_distribution<T>, writer),
+                2, hep::make_dist_params<T>(10, T(0.0), T(1.0))),
+            std::vector<std::size_t>{ 100 },
+            hep::make_vegas_chkpt<T>(),
+            hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        writer.flush();
+
+        CHECK( hep::read_events<T>(file).size() == non_zero_calls + writer.events() );
+    }
+
+    std::remove(file.c_str());
+}
+
+TEMPLATE_TEST_CASE("event_writer with multi_channel", "", float, double)
+{
+    using T = TestType;
+
+    std::string const file = filename<T>("multi_channel");
+    std::vector<T> const weights = { T(1.0), T(1.0) };
+
+    T result_value;
+
+    {
+        hep::event_writer<T> writer(file, 2);
+
+        auto const chkpt = hep::multi_channel(
+            hep::make_multi_channel_integrand<T>(
+                hep::make_event_function(multi_channel_function<T>, writer), 2, map<T>, 2, 2),
+            std::vector<std::size_t>{ 10000 },
+            hep::make_multi_channel_chkpt<T>(weights),
+            hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        result_value = chkpt.results().front().value();
+    }
+
+    auto const events = hep::read_events<T>(file);
+
+    std::size_t channel_events[2] = {};
+
+    for (auto const& event : events)
+    {
+        REQUIRE( event.channel < 2 );
+        ++channel_events[event.channel];
+
+        // the coordinates are the ones generated by the map
+        CHECK( event.value == value(event.coordinates[0], event.coordinates[1]) );
+    }
+
+    CHECK( channel_events[0] > 0 );
+    CHECK( channel_events[1] > 0 );
+    CHECK_THAT( sum_of_weights(events) / T(10000.0),
+        Catch::WithinAbs(result_value, T(1e-4) * std::abs(result_value)) );
+
+    std::remove(file.c_str());
+}
+
+TEMPLATE_TEST_CASE("event_unweighter", "", float, double)
+{
+    using T = TestType;
+
+    std::string const file = filename<T>("unweighted");
+
+    // the largest value of the integrand
+    T const max_weight = T(3.0);
+
+    std::size_t trials = 0;
+    std::size_t accepted = 0;
+    T result_value;
+
+    {
+        hep::event_writer<T> writer(file, 2);
+        hep::event_unweighter<T, hep::event_writer<T>> unweighter(writer, max_weight);
+
+        auto const chkpt = hep::parallel_plain(
+            2,
+            hep::make_integrand<T>(hep::make_event_function(function<T>, unweighter), 2),
+            std::vector<std::size_t>{ 100000 },
+            hep::make_plain_chkpt<T>(),
+            hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+        );
+
+        trials = unweighter.trials();
+        accepted = unweighter.accepted();
+        result_value = chkpt.results().front().value();
+
+        CHECK( trials == chkpt.results().front().non_zero_calls() );
+        CHECK( unweighter.max_weight() == max_weight );
+        CHECK( writer.events() == accepted );
+    }
+
+    auto const events = hep::read_events<T>(file);
+
+    REQUIRE( events.size() == accepted );
+
+    for (auto const& event : events)
+    {
+        CHECK( event.weight == max_weight );
+    }
+
+    // the efficiency of the unweighting is the average weight divided by the maximum weight
+    T const efficiency = T(accepted) / T(100000.0);
+    T const error = std::sqrt(efficiency * (T(1.0) - efficiency) / T(100000.0));
+
+    CHECK( std::fabs(efficiency * max_weight - result_value) < T(4.0) * error * max_weight );
+
+    std::remove(file.c_str());
+}
+
+TEST_CASE("event_writer with an existing file")
+{
+    std::string const file = filename<double>("existing");
+    std::vector<double> const coordinates(2);
+
+    {
+        hep::event_writer<double> writer(file, 2);
+        writer.add(0, 1.0, 1.0, coordinates);
+    }
+
+    // appending events with a different numeric type or dimension would corrupt the file
+    CHECK_THROWS_AS( hep::event_writer<float>(file, 2), std::runtime_error );
+    CHECK_THROWS_AS( hep::event_writer<double>(file, 3), std::runtime_error );
+
+    {
+        hep::event_writer<double> writer(file, 2);
+        writer.add(1, 2.0, 2.0, coordinates);
+    }
+
+    auto const events = hep::read_events<double>(file);
+
+    REQUIRE( events.size() == 2 );
+    CHECK( events.at(0).channel == 0 );
+    CHECK( events.at(1).channel == 1 );
+
+    // a file that is not an event file is rejected as well
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out << "not an event file";
+    }
+
+    CHECK_THROWS_AS( hep::event_writer<double>(file, 2), std::runtime_error );
+
+    std::remove(file.c_str());
+}
+
+TEST_CASE("event_writer with a full disk")
+{
+    std::string const file = "/dev/full";
+
+    // only test this on systems that have a device which is always full
+    if (!std::ifstream(file))
+    {
+        return;
+    }
+
+    std::vector<double> const coordinates(2);
+
+    {
+        hep::event_writer<double> writer(file, 2);
+
+        writer.add(0, 1.0, 1.0, coordinates);
+
+        CHECK_THROWS_AS( writer.flush(), std::runtime_error );
+    }
+
+    // the destructor must not throw, which would terminate the program
+    hep::event_writer<double> writer(file, 2);
+
+    writer.add(0, 1.0, 1.0, coordinates);
+}
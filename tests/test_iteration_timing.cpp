@@ -0,0 +1,189 @@
+#ifndef HEP_USE_MPI
+#include "hep/mc.hpp"
+#else
+#include "hep/mc-mpi.hpp"
+#endif
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+
+    return T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+template <typename C>
+std::string serialize_binary(C const& chkpt)
+{
+    std::ostringstream out;
+    hep::binary_writer writer(out);
+    chkpt.serialize(writer);
+    return out.str();
+}
+
+template <typename T>
+hep::default_vegas_chkpt<T> integrate(hep::default_vegas_chkpt<T> const& chkpt)
+{
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+#ifndef HEP_USE_MPI
+    return hep::vegas(
+#else
+    return hep::mpi_vegas(
+        MPI_COMM_WORLD,
+#endif
+        hep::make_integrand<T>(function<T>, 2),
+        std::vector<std::size_t>(5, 10000),
+        chkpt,
+#ifndef HEP_USE_MPI
+        hep::callback<chkpt_type>(hep::callback_mode::verbose)
+#else
+        hep::mpi_callback<chkpt_type>(hep::callback_mode::verbose)
+#endif
+    );
+}
+
+TEST_CASE("iteration_timing")
+{
+    hep::iteration_timing const unknown;
+
+    CHECK( unknown.wall_time() == 0.0 );
+    CHECK( unknown.calls_per_second(1000) == 0.0 );
+    CHECK( unknown.imbalance() == 1.0 );
+
+    CHECK( unknown.processes() == 0 );
+
+    hep::iteration_timing const timing(2.0, 1.5, 0.25, 4, 2.0, 6.0, 1);
+
+    CHECK( timing.overhead_time() == 0.25 );
+    CHECK( timing.calls_per_second(1000) == 500.0 );
+    CHECK( timing.imbalance() == 4.0 / 3.0 );
+    CHECK( timing.slowest_process() == 1 );
+}
+
+TEMPLATE_TEST_CASE("timings of integrators", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto const chkpt = integrate<T>(hep::make_vegas_chkpt<T>());
+
+    REQUIRE( chkpt.timings().size() == chkpt.results().size() );
+
+#ifdef HEP_USE_MPI
+    int world = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &world);
+#endif
+
+    for (auto const& timing : chkpt.timings())
+    {
+        CHECK( timing.integrand_time() > 0.0 );
+        CHECK( timing.wall_time() >= timing.integrand_time() + timing.reduction_time() );
+
+#ifndef HEP_USE_MPI
+        CHECK( timing.reduction_time() == 0.0 );
+        CHECK( timing.processes() == 0 );
+#else
+        CHECK( timing.processes() == std::size_t(world) );
+        CHECK( timing.slowest_process() < std::size_t(world) );
+        CHECK( timing.slowest_integrand_time() >= timing.integrand_time() );
+        CHECK( timing.total_integrand_time() >= timing.slowest_integrand_time() );
+        CHECK( timing.imbalance() >= 1.0 );
+#endif
+    }
+
+    // by default the timings are not written, so that checkpoints of the same integration agree
+    CHECK_FALSE( chkpt.store_timings() );
+    CHECK( serialize(integrate<T>(hep::make_vegas_chkpt<T>())) == serialize(chkpt) );
+
+    std::istringstream in(serialize(chkpt));
+    chkpt_type const read(in);
+
+    CHECK_FALSE( read.store_timings() );
+    REQUIRE( read.timings().size() == chkpt.results().size() );
+    CHECK( read.timings().front().wall_time() == 0.0 );
+
+    // the rollback removes the timings of the discarded iterations
+    auto rolled_back = chkpt;
+    rolled_back.rollback(2);
+
+    CHECK( rolled_back.timings().size() == 2 );
+}
+
+TEMPLATE_TEST_CASE("serialization of timings", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto initial = hep::make_vegas_chkpt<T>();
+    initial.store_timings(true);
+
+    auto const chkpt = integrate<T>(initial);
+
+    REQUIRE( chkpt.store_timings() );
+
+    std::istringstream in(serialize(chkpt));
+    chkpt_type const text(in);
+
+    std::string const data = serialize_binary(chkpt);
+    hep::binary_reader reader(data.data(), data.size());
+    chkpt_type const binary(reader);
+
+#ifndef HEP_USE_MPI
+    std::string const filename = "test_iteration_timing_journal_" + std::to_string(sizeof (T));
+    std::remove(filename.c_str());
+
+    // the journal appends each timing to the results after the first snapshot
+    auto const journaled = hep::vegas(
+        hep::make_integrand<T>(function<T>, 2),
+        std::vector<std::size_t>(5, 10000),
+        initial,
+        hep::callback<chkpt_type>(hep::callback_mode::silent_and_write_chkpt, filename, T(),
+            hep::chkpt_format::journal)
+    );
+
+    auto const replayed = hep::load_chkpt<chkpt_type>(filename);
+    std::remove(filename.c_str());
+
+    CHECK( replayed.store_timings() );
+    CHECK( serialize(replayed) == serialize(journaled) );
+#endif
+
+    for (auto const* copy : { &text, &binary })
+    {
+        CHECK( copy->store_timings() );
+        CHECK( serialize(*copy) == serialize(chkpt) );
+        REQUIRE( copy->timings().size() == chkpt.timings().size() );
+
+        for (std::size_t i = 0; i != chkpt.timings().size(); ++i)
+        {
+            auto const& timing = copy->timings().at(i);
+            auto const& expected = chkpt.timings().at(i);
+
+            CHECK( timing.wall_time() == expected.wall_time() );
+            CHECK( timing.integrand_time() == expected.integrand_time() );
+            CHECK( timing.reduction_time() == expected.reduction_time() );
+            CHECK( timing.processes() == expected.processes() );
+            CHECK( timing.slowest_integrand_time() == expected.slowest_integrand_time() );
+            CHECK( timing.total_integrand_time() == expected.total_integrand_time() );
+            CHECK( timing.slowest_process() == expected.slowest_process() );
+        }
+    }
+}
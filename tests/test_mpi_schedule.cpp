@@ -0,0 +1,219 @@
+#include "hep/mc-mpi.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+// makes the process with rank one slower, so that the dynamic schedule assigns it fewer calls
+inline void waste_time()
+{
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    if (rank == 1)
+    {
+        volatile double sum = 0.0;
+
+        for (int i = 0; i != 200; ++i)
+        {
+            sum = sum + std::sqrt(double(i));
+        }
+    }
+}
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    waste_time();
+    projector.add(0, x, f);
+
+    return f;
+}
+
+template <typename T>
+T multi_channel_function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.coordinates()[0];
+    T const y = point.coordinates()[1];
+
+    waste_time();
+
+    return T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t const enabled : enabled_channels)
+        {
+            densities[enabled] = (enabled == 1) ? T(2.0) * coordinates[0] : T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    if (channel == 1)
+    {
+        coordinates[0] = std::sqrt(random_numbers[0]);
+    }
+
+    return T(1.0);
+}
+
+template <typename R>
+std::string state(R const& generator)
+{
+    std::ostringstream out;
+    out << generator;
+    return out.str();
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+// checks that both checkpoints contain the same results up to rounding differences
+template <typename C>
+void check_equal(C const& reference, C const& chkpt)
+{
+    using T = typename C::result_type::numeric_type;
+
+    REQUIRE( reference.results().size() == chkpt.results().size() );
+
+    for (std::size_t i = 0; i != chkpt.results().size(); ++i)
+    {
+        auto const& expected = reference.results().at(i);
+        auto const& result = chkpt.results().at(i);
+
+        CHECK( result.calls() == expected.calls() );
+        CHECK( result.non_zero_calls() == expected.non_zero_calls() );
+        CHECK( result.finite_calls() == expected.finite_calls() );
+        CHECK_THAT( result.value(),
+            Catch::WithinAbs(expected.value(), T(1e-4) * std::abs(expected.value())) );
+        CHECK_THAT( result.error(),
+            Catch::WithinAbs(expected.error(), T(1e-3) * std::abs(expected.error())) );
+    }
+
+    CHECK( state(chkpt.generator()) == state(reference.generator()) );
+}
+
+TEMPLATE_TEST_CASE("schedules and threads of mpi_plain", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_plain_chkpt<T>;
+
+    auto const run = [](hep::mpi_schedule schedule, std::size_t threads) {
+        return hep::mpi_plain(
+            MPI_COMM_WORLD,
+            hep::make_integrand<T>(function<T>, 2, hep::make_dist_params<T>(4, T(0.0), T(1.0))),
+            std::vector<std::size_t>{ 10000, 3333, 17 },
+            hep::make_plain_chkpt<T>(),
+            hep::mpi_callback<chkpt_type>(hep::callback_mode::silent),
+            schedule,
+            threads
+        );
+    };
+
+    auto const equal_shares = run(hep::mpi_schedule::equal_shares, 1);
+    auto const dynamic = run(hep::mpi_schedule::dynamic, 1);
+
+    check_equal(equal_shares, dynamic);
+
+    // the chunks are summed in the same order, whichever process evaluated them
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 1)) == serialize(dynamic) );
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 3)) ==
+        serialize(run(hep::mpi_schedule::dynamic, 3)) );
+    check_equal(equal_shares, run(hep::mpi_schedule::equal_shares, 3));
+    check_equal(equal_shares, run(hep::mpi_schedule::dynamic, 3));
+
+    auto const& bins = dynamic.results().back().distributions().at(0).results();
+    auto const& expected_bins = equal_shares.results().back().distributions().at(0).results();
+
+    for (std::size_t i = 0; i != bins.size(); ++i)
+    {
+        CHECK( bins.at(i).non_zero_calls() == expected_bins.at(i).non_zero_calls() );
+    }
+}
+
+TEMPLATE_TEST_CASE("schedules and threads of mpi_vegas", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto const run = [](hep::mpi_schedule schedule, std::size_t threads) {
+        return hep::mpi_vegas(
+            MPI_COMM_WORLD,
+            hep::make_integrand<T>(function<T>, 2, hep::make_dist_params<T>(4, T(0.0), T(1.0))),
+            std::vector<std::size_t>(4, 5000),
+            hep::make_vegas_chkpt<T>(16),
+            hep::mpi_callback<chkpt_type>(hep::callback_mode::silent),
+            schedule,
+            threads
+        );
+    };
+
+    auto const equal_shares = run(hep::mpi_schedule::equal_shares, 1);
+    auto const dynamic = run(hep::mpi_schedule::dynamic, 1);
+
+    check_equal(equal_shares, dynamic);
+    check_equal(equal_shares, run(hep::mpi_schedule::equal_shares, 3));
+    check_equal(equal_shares, run(hep::mpi_schedule::dynamic, 3));
+
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 1)) == serialize(dynamic) );
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 3)) ==
+        serialize(run(hep::mpi_schedule::dynamic, 3)) );
+}
+
+TEMPLATE_TEST_CASE("schedules and threads of mpi_multi_channel", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_chkpt<T>;
+
+    auto const run = [](hep::mpi_schedule schedule, std::size_t threads) {
+        return hep::mpi_multi_channel(
+            MPI_COMM_WORLD,
+            hep::make_multi_channel_integrand<T>(multi_channel_function<T>, 2, map<T>, 2, 2),
+            std::vector<std::size_t>(4, 5000),
+            hep::make_multi_channel_chkpt<T>(),
+            hep::mpi_callback<chkpt_type>(hep::callback_mode::silent),
+            schedule,
+            threads
+        );
+    };
+
+    auto const equal_shares = run(hep::mpi_schedule::equal_shares, 1);
+    auto const dynamic = run(hep::mpi_schedule::dynamic, 1);
+
+    check_equal(equal_shares, dynamic);
+    check_equal(equal_shares, run(hep::mpi_schedule::equal_shares, 3));
+    check_equal(equal_shares, run(hep::mpi_schedule::dynamic, 3));
+
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 1)) == serialize(dynamic) );
+    CHECK( serialize(run(hep::mpi_schedule::dynamic, 3)) ==
+        serialize(run(hep::mpi_schedule::dynamic, 3)) );
+}
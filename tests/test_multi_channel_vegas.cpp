@@ -0,0 +1,160 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.coordinates().at(0) - T(0.5);
+    T const y = point.coordinates().at(1) - T(0.5);
+    T const sigma = T(0.05);
+
+    // normalized gaussian peak whose tails outside of the unit-square are negligible
+    return std::exp(-(x * x + y * y) / (T(2.0) * sigma * sigma)) /
+        (T(2.0) * T(std::acos(-1.0)) * sigma * sigma);
+}
+
+template <typename T>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t const enabled : enabled_channels)
+        {
+            CHECK( enabled != 2 );
+
+            // the second channel has the density `1 / (2 * sqrt(x))`
+            densities[enabled] = (enabled == 1) ? T(0.5) / std::sqrt(coordinates[0]) : T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    CHECK( channel != 2 );
+
+    coordinates[0] = (channel == 1) ? random_numbers[0] * random_numbers[0] : random_numbers[0];
+    coordinates[1] = random_numbers[1];
+
+    return T(1.0);
+}
+
+template <typename C>
+std::string serialize(C const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("multi_channel_vegas integration", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_vegas_chkpt<T>;
+
+    // the third channel is disabled
+    std::vector<T> const weights = { T(1.0), T(1.0), T() };
+    std::vector<std::size_t> const iteration_calls(10, 10000);
+
+    auto integrand = hep::make_multi_channel_integrand<T>(function<T>, 2, map<T>, 2, 3);
+
+    auto const chkpt = hep::multi_channel_vegas(
+        integrand,
+        iteration_calls,
+        hep::make_multi_channel_vegas_chkpt<T>(weights, 32),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const reference = hep::multi_channel(
+        integrand,
+        iteration_calls,
+        hep::make_multi_channel_chkpt<T>(weights),
+        hep::callback<hep::default_multi_channel_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    auto const& results = chkpt.results();
+
+    REQUIRE( results.size() == 10 );
+
+    for (auto const& result : results)
+    {
+        CHECK( result.calls() == 10000 );
+        CHECK( result.pdfs().size() == 3 );
+        CHECK( result.pdf_adjustment_data().size() == 3 );
+        CHECK( result.channel_weights().at(2) == T() );
+        CHECK( std::fabs(result.value() - T(1.0)) < T(4.0) * result.error() );
+    }
+
+    // the grids adapt to the peak, which the channels do not describe
+    CHECK( results.back().error() < T(0.5) * reference.results().back().error() );
+
+    // the grid of the disabled channel is never changed
+    CHECK( serialize(chkpt.pdfs().at(2)) == serialize(hep::vegas_pdf<T>(2, 32)) );
+    CHECK( serialize(chkpt.pdfs().at(0)) != serialize(hep::vegas_pdf<T>(2, 32)) );
+
+    // the random numbers are used in the same way as by `multi_channel`
+    CHECK( chkpt.generator() == reference.generator() );
+}
+
+TEMPLATE_TEST_CASE("multi_channel_vegas checkpoints", "", float, double, long double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_vegas_chkpt<T>;
+
+    auto integrand = hep::make_multi_channel_integrand<T>(function<T>, 2, map<T>, 2, 2);
+
+    // an empty checkpoint stores the initial grids
+    auto empty = hep::make_multi_channel_vegas_chkpt<T>(8, T(1.0), T(0.01), T(0.5));
+    empty.channels(2);
+    empty.dimensions(2);
+
+    std::istringstream empty_in(serialize(empty));
+    auto const empty_restored = hep::make_multi_channel_vegas_chkpt<T, std::mt19937>(empty_in);
+
+    CHECK( empty_restored.alpha() == T(1.0) );
+    CHECK( empty_restored.min_weight() == T(0.01) );
+    CHECK( empty_restored.beta() == T(0.5) );
+    CHECK( empty_restored.pdfs().size() == 2 );
+    CHECK( serialize(empty_restored) == serialize(empty) );
+
+    auto const chkpt = hep::multi_channel_vegas(
+        integrand,
+        std::vector<std::size_t>(3, 1000),
+        hep::make_multi_channel_vegas_chkpt<T>(8, T(1.0), T(0.01), T(0.5)),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    std::istringstream in(serialize(chkpt));
+    auto const restored = hep::make_multi_channel_vegas_chkpt<T, std::mt19937>(in);
+
+    CHECK( serialize(restored) == serialize(chkpt) );
+
+    // resuming from a checkpoint gives the same results as performing all iterations at once
+    auto const resumed = hep::multi_channel_vegas(
+        integrand,
+        std::vector<std::size_t>(2, 1000),
+        restored,
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const complete = hep::multi_channel_vegas(
+        integrand,
+        std::vector<std::size_t>(5, 1000),
+        hep::make_multi_channel_vegas_chkpt<T>(8, T(1.0), T(0.01), T(0.5)),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    CHECK( serialize(resumed) == serialize(complete) );
+}
@@ -0,0 +1,116 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    return f;
+}
+
+template <typename T>
+T densities(
+    std::size_t /*channel*/,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& enabled_channels,
+    std::vector<T>& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_densities)
+    {
+        for (std::size_t channel : enabled_channels)
+        {
+            densities[channel] = T(1.0);
+        }
+
+        return T(1.0);
+    }
+
+    std::copy(random_numbers.begin(), random_numbers.end(), coordinates.begin());
+
+    return T(1.0);
+}
+
+template <typename Checkpoint>
+std::string serialize(Checkpoint const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("parallel multi_channel integration", "", float, double)
+{
+    using T = TestType;
+
+    // make sure that one random number suffices for all floating point types - otherwise the test
+    // results depend on the numeric type
+    REQUIRE( std::numeric_limits<std::mt19937_64::result_type>::digits >=
+        std::numeric_limits<T>::digits );
+
+    std::vector<T> const weights = { T(), T(1.0), T(1.0), T(1.0) };
+    auto const chkpt = hep::make_multi_channel_chkpt<T>(weights, T(0.01), T(0.25),
+        std::mt19937_64());
+    auto const callback = hep::callback<decltype (chkpt)>(hep::callback_mode::silent);
+
+    auto const reference = hep::parallel_multi_channel(
+        2,
+        hep::make_multi_channel_integrand<T>(function<T>, 2, densities<T>, 2, 4),
+        std::vector<std::size_t>(5, 10000),
+        chkpt,
+        callback
+    );
+
+    auto const& results = reference.results();
+
+    // these are the same numbers as in the sequential test
+    CHECK_THAT( results.at(0).value() , Catch::WithinULP(T(1.000889500971818506844e+00), 256) );
+    CHECK_THAT( results.at(1).value() , Catch::WithinULP(T(1.007360827957602174439e+00), 256) );
+    CHECK_THAT( results.at(2).value() , Catch::WithinULP(T(9.993263442793500384736e-01), 256) );
+    CHECK_THAT( results.at(3).value() , Catch::WithinULP(T(9.991312981071902387764e-01), 256) );
+    CHECK_THAT( results.at(4).value() , Catch::WithinULP(T(1.008099287068812917106e+00), 256) );
+
+    auto const sequential = hep::multi_channel(
+        hep::make_multi_channel_integrand<T>(function<T>, 2, densities<T>, 2, 4),
+        std::vector<std::size_t>(5, 10000),
+        chkpt,
+        callback
+    );
+
+    CHECK( reference.generator() == sequential.generator() );
+
+    // a single thread sums all evaluations in one pass like the sequential integrator
+    CHECK( serialize(sequential) == serialize(hep::parallel_multi_channel(
+        1,
+        hep::make_multi_channel_integrand<T>(function<T>, 2, densities<T>, 2, 4),
+        std::vector<std::size_t>(5, 10000),
+        chkpt,
+        callback
+    )) );
+
+    // the results must be bitwise identical for any number of threads larger than one
+    for (std::size_t threads = 3; threads != 6; ++threads)
+    {
+        CHECK( serialize(reference) == serialize(hep::parallel_multi_channel(
+            threads,
+            hep::make_multi_channel_integrand<T>(function<T>, 2, densities<T>, 2, 4),
+            std::vector<std::size_t>(5, 10000),
+            chkpt,
+            callback
+        )) );
+    }
+}
@@ -0,0 +1,102 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+    projector.add(1, x, y, f);
+
+    return f;
+}
+
+template <typename T>
+hep::plain_chkpt_with_rng<std::mt19937_64, T> integrate(std::size_t threads)
+{
+    auto integrand = hep::make_integrand<T>(
+        function<T>,
+        2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"),
+        hep::distribution_parameters<T>(4, 4, T(0.0), T(1.0), T(0.0), T(1.0), "x-y")
+    );
+
+    auto chkpt = hep::make_plain_chkpt<T>(std::mt19937_64());
+    auto callback = hep::callback<decltype (chkpt)>(hep::callback_mode::silent);
+
+    // zero threads means sequential
+    if (threads == 0)
+    {
+        return hep::plain(integrand, std::vector<std::size_t>{ 10000, 1000, 10 }, chkpt, callback);
+    }
+
+    return hep::parallel_plain(threads, integrand, std::vector<std::size_t>{ 10000, 1000, 10 },
+        chkpt, callback);
+}
+
+template <typename Checkpoint>
+std::string serialize(Checkpoint const& chkpt)
+{
+    std::ostringstream out;
+    chkpt.serialize(out);
+
+    return out.str();
+}
+
+TEMPLATE_TEST_CASE("parallel plain integration", "", float, double)
+{
+    using T = TestType;
+
+    auto const sequential = integrate<T>(0);
+    auto const reference = integrate<T>(2);
+
+    // a single thread sums all evaluations in one pass like the sequential integrator
+    CHECK( serialize(integrate<T>(1)) == serialize(sequential) );
+
+    auto const& results = reference.results();
+
+    REQUIRE( results.size() == sequential.results().size() );
+
+    for (std::size_t i = 0; i != results.size(); ++i)
+    {
+        auto const& result = results.at(i);
+        auto const& expected = sequential.results().at(i);
+
+        CHECK( result.calls()          == expected.calls() );
+        CHECK( result.non_zero_calls() == expected.non_zero_calls() );
+        CHECK( result.finite_calls()   == expected.finite_calls() );
+        CHECK_THAT( result.value() , Catch::WithinULP(expected.value(), 256) );
+        CHECK_THAT( result.error() , Catch::WithinULP(expected.error(), 256) );
+
+        for (std::size_t j = 0; j != result.distributions().size(); ++j)
+        {
+            auto const& bins = result.distributions().at(j).results();
+            auto const& expected_bins = expected.distributions().at(j).results();
+
+            for (std::size_t k = 0; k != bins.size(); ++k)
+            {
+                CHECK( bins.at(k).non_zero_calls() == expected_bins.at(k).non_zero_calls() );
+                CHECK_THAT( bins.at(k).value() , Catch::WithinULP(expected_bins.at(k).value(),
+                    256) );
+            }
+        }
+    }
+
+    CHECK( reference.generator() == sequential.generator() );
+
+    // the results must be bitwise identical for any number of threads larger than one
+    for (std::size_t threads = 3; threads != 6; ++threads)
+    {
+        CHECK( serialize(integrate<T>(threads)) == serialize(reference) );
+    }
+}
@@ -0,0 +1,196 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    return f;
+}
+
+template <typename T>
+T function_with_distribution(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point().at(0);
+    T const f = function(point);
+
+    projector.add(0, x, f);
+
+    return f;
+}
+
+TEMPLATE_TEST_CASE("parallel vegas integration", "", float, double)
+{
+    using T = TestType;
+
+    // make sure that one random number suffices for all floating point types - otherwise the test
+    // results depend on the numeric type
+    REQUIRE( std::numeric_limits<std::mt19937_64::result_type>::digits >=
+        std::numeric_limits<T>::digits );
+
+    using chkpt_type = hep::vegas_chkpt_with_rng<std::mt19937_64, T>;
+
+    std::ostringstream sequential;
+
+    hep::vegas(
+        hep::make_integrand<T>(function<T>, 2),
+        std::vector<std::size_t>(5, 10000),
+        hep::make_vegas_chkpt<T>(8, T(1.5), std::mt19937_64()),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    ).serialize(sequential);
+
+    std::string const reference = sequential.str();
+    std::string two_threads;
+
+    for (std::size_t threads = 1; threads != 5; ++threads)
+    {
+        auto const chkpt = hep::parallel_vegas(
+            threads,
+            hep::make_integrand<T>(function<T>, 2),
+            std::vector<std::size_t>(5, 10000),
+            hep::make_vegas_chkpt<T>(8, T(1.5), std::mt19937_64()),
+            hep::callback<chkpt_type>(hep::callback_mode::silent)
+        );
+
+        auto const& results = chkpt.results();
+
+        for (auto const& result : results)
+        {
+            CHECK( result.calls()          == 10000 );
+            CHECK( result.non_zero_calls() == 10000 );
+            CHECK( result.finite_calls()   == 10000 );
+        }
+
+        // these are the same numbers as in the sequential test
+        CHECK_THAT( results.at(0).value() , Catch::WithinULP(T(1.00174442996819830119e+00), 256) );
+        CHECK_THAT( results.at(1).value() , Catch::WithinULP(T(1.00237281522120332683e+00), 256) );
+        CHECK_THAT( results.at(2).value() , Catch::WithinULP(T(1.00096173351515851154e+00), 256) );
+        CHECK_THAT( results.at(3).value() , Catch::WithinULP(T(9.98733376891225725115e-01), 256) );
+        CHECK_THAT( results.at(4).value() , Catch::WithinULP(T(9.98414891829362159009e-01), 256) );
+
+        CHECK_THAT( results.at(0).error() , Catch::WithinULP(T(6.33329853753390638773e-03), 256) );
+        CHECK_THAT( results.at(1).error() , Catch::WithinULP(T(2.51428830094928175573e-03), 256) );
+        CHECK_THAT( results.at(2).error() , Catch::WithinULP(T(2.21815471345527884809e-03), 256) );
+        CHECK_THAT( results.at(3).error() , Catch::WithinULP(T(2.20202856630089260614e-03), 256) );
+        CHECK_THAT( results.at(4).error() , Catch::WithinULP(T(2.22194654802565982583e-03), 256) );
+
+        // a single thread sums all evaluations in one pass like the sequential integrator, and
+        // more threads must give the same checkpoint, including the state of the generator
+        std::ostringstream out;
+        chkpt.serialize(out);
+
+        if (threads == 1)
+        {
+            CHECK( out.str() == reference );
+        }
+        else if (threads == 2)
+        {
+            two_threads = out.str();
+        }
+        else
+        {
+            CHECK( out.str() == two_threads );
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("parallel vegas with distributions", "", float, double)
+{
+    using T = TestType;
+
+    auto integrand = hep::make_integrand<T>(
+        function_with_distribution<T>,
+        2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0))
+    );
+
+    auto const sequential = hep::vegas(
+        integrand,
+        std::vector<std::size_t>(3, 1000),
+        hep::make_vegas_chkpt<T>(8),
+        hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+    ).results();
+
+    auto const run = [&](std::size_t threads) {
+        return hep::parallel_vegas(
+            threads,
+            integrand,
+            std::vector<std::size_t>(3, 1000),
+            hep::make_vegas_chkpt<T>(8),
+            hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+        ).results();
+    };
+
+    auto const parallel = run(3);
+    auto const two_threads = run(2);
+
+    REQUIRE( parallel.size() == sequential.size() );
+
+    for (std::size_t i = 0; i != parallel.size(); ++i)
+    {
+        CHECK_THAT( parallel.at(i).value() , Catch::WithinULP(sequential.at(i).value(), 256) );
+        CHECK_THAT( parallel.at(i).error() , Catch::WithinULP(sequential.at(i).error(), 256) );
+        CHECK( parallel.at(i).value() == two_threads.at(i).value() );
+        CHECK( parallel.at(i).error() == two_threads.at(i).error() );
+
+        auto const& parallel_bins = parallel.at(i).distributions().at(0).results();
+        auto const& sequential_bins = sequential.at(i).distributions().at(0).results();
+        auto const& two_threads_bins = two_threads.at(i).distributions().at(0).results();
+
+        REQUIRE( parallel_bins.size() == sequential_bins.size() );
+
+        for (std::size_t j = 0; j != parallel_bins.size(); ++j)
+        {
+            CHECK( parallel_bins.at(j).non_zero_calls() == sequential_bins.at(j).non_zero_calls() );
+            CHECK_THAT( parallel_bins.at(j).value() , Catch::WithinULP(
+                sequential_bins.at(j).value(), 256) );
+            CHECK( parallel_bins.at(j).value() == two_threads_bins.at(j).value() );
+            CHECK( parallel_bins.at(j).error() == two_threads_bins.at(j).error() );
+        }
+
+        CHECK( parallel.at(i).adjustment_data() == two_threads.at(i).adjustment_data() );
+    }
+}
+
+TEST_CASE("thread pool", "[thread_pool]")
+{
+    hep::thread_pool pool(4);
+
+    CHECK( pool.size() == 4 );
+
+    std::vector<std::size_t> indices(pool.size());
+
+    for (std::size_t i = 0; i != 3; ++i)
+    {
+        pool.run([&](std::size_t index) { indices.at(index) += index; });
+    }
+
+    for (std::size_t i = 0; i != indices.size(); ++i)
+    {
+        CHECK( indices.at(i) == 3 * i );
+    }
+
+    CHECK_THROWS_AS( pool.run([](std::size_t index) {
+        if (index == 2)
+        {
+            throw std::runtime_error("error in thread");
+        }
+    }), std::runtime_error );
+
+    // the pool must be usable after an exception was thrown
+    pool.run([&](std::size_t index) { indices.at(index) = 0; });
+
+    CHECK( indices == std::vector<std::size_t>(pool.size()) );
+}
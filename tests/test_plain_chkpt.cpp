@@ -125,3 +125,43 @@ TEMPLATE_TEST_CASE("plain_chkpt series", "", float, double, long double)
 
     CHECK( stream1.str() == stream2.str() );
 }
+
+TEMPLATE_TEST_CASE("plain_chkpt rollback", "", float, double, long double)
+{
+    using T = TestType;
+
+    auto integrand = hep::make_integrand<T>(
+        linear_function<T>,
+        1,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "distribution #1")
+    );
+
+    auto const chkpt2 = hep::plain(integrand, std::vector<std::size_t>(2, 1000));
+    auto const chkpt5 = hep::plain(integrand, std::vector<std::size_t>(3, 1000), chkpt2);
+
+    // after rolling back to the second iteration the generator must be the one that continues it
+    auto rolled_back = chkpt5;
+    rolled_back.rollback(2);
+
+    REQUIRE( rolled_back.results().size() == 2 );
+    CHECK( rolled_back.generator() == chkpt2.generator() );
+
+    // the rolled back checkpoint can be serialized and gives the same checkpoint when continued
+    std::ostringstream stream1;
+    std::ostringstream stream2;
+
+    rolled_back.serialize(stream1);
+    chkpt2.serialize(stream2);
+
+    CHECK( stream1.str() == stream2.str() );
+
+    auto const continued = hep::plain(integrand, std::vector<std::size_t>(3, 1000), rolled_back);
+
+    std::ostringstream stream3;
+    std::ostringstream stream4;
+
+    continued.serialize(stream3);
+    chkpt5.serialize(stream4);
+
+    CHECK( stream3.str() == stream4.str() );
+}
@@ -0,0 +1,104 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+    projector.add(1, x, y, f);
+
+    return f;
+}
+
+template <typename T>
+std::vector<hep::plain_result<T>> integrate()
+{
+    auto const chkpt = hep::plain(
+        hep::make_integrand<T>(
+            function<T>,
+            2,
+            hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"),
+            hep::distribution_parameters<T>(4, 4, T(0.0), T(1.0), T(0.0), T(1.0), "xy")
+        ),
+        std::vector<std::size_t>(6, 1000),
+        hep::make_plain_chkpt<T>(),
+        hep::callback<hep::default_plain_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    return chkpt.results();
+}
+
+template <typename T>
+void check_result(hep::mc_result<T> const& result, hep::mc_result<T> const& expected)
+{
+    CHECK( result.calls() == expected.calls() );
+    CHECK( result.non_zero_calls() == expected.non_zero_calls() );
+    CHECK( result.finite_calls() == expected.finite_calls() );
+    CHECK( result.value() == expected.value() );
+    CHECK( result.error() == expected.error() );
+}
+
+TEMPLATE_TEST_CASE("running_distributions", "", float, double)
+{
+    using T = TestType;
+
+    auto const results = integrate<T>();
+    hep::running_distributions<T> distributions;
+
+    for (std::size_t i = 0; i != results.size(); ++i)
+    {
+        distributions.add(results.at(i));
+
+        CHECK( distributions.iterations() == (i + 1) );
+
+        auto const result = distributions.result();
+
+        // each bin is combined like a sequence of results without distributions
+        check_result<T>(result, hep::accumulate<hep::weighted_with_variance>(results.begin(),
+            results.begin() + i + 1));
+        REQUIRE( result.distributions().size() == 2 );
+
+        for (std::size_t j = 0; j != 2; ++j)
+        {
+            auto const& bins = result.distributions().at(j).results();
+
+            CHECK( result.distributions().at(j).parameters().name() ==
+                results.front().distributions().at(j).parameters().name() );
+            REQUIRE( bins.size() == ((j == 0) ? 10 : 16) );
+
+            for (std::size_t k = 0; k != bins.size(); ++k)
+            {
+                std::vector<hep::mc_result<T>> bin_results;
+
+                for (std::size_t l = 0; l <= i; ++l)
+                {
+                    bin_results.push_back(results.at(l).distributions().at(j).results().at(k));
+                }
+
+                check_result<T>(bins.at(k), hep::accumulate<hep::weighted_with_variance>(
+                    bin_results.begin(), bin_results.end()));
+            }
+        }
+    }
+
+    // `accumulate` uses the same class
+    auto const accumulated = hep::accumulate<hep::weighted_with_variance>(results.begin(),
+        results.end());
+
+    CHECK( accumulated.distributions().at(1).results().at(5).value() ==
+        distributions.result().distributions().at(1).results().at(5).value() );
+
+    // results with different distributions can not be combined
+    auto const other = hep::plain_result<T>({}, 1000, 1000, 1000, T(1000.0), T(2000.0));
+
+    CHECK_THROWS_AS( distributions.add(other), std::invalid_argument );
+}
@@ -0,0 +1,124 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+
+    return T(3.0) / T(2.0) * (x * x + y * y);
+}
+
+template <typename T>
+void check_statistics(hep::running_statistics<T> const& statistics,
+    std::vector<hep::plain_result<T>> const& results)
+{
+    auto const begin = results.begin();
+    auto const end = results.end();
+    auto const expected = hep::accumulate<hep::weighted_with_variance>(begin, end);
+    auto const result = statistics.result();
+
+    CHECK( statistics.iterations() == results.size() );
+    CHECK( result.calls() == expected.calls() );
+    CHECK( result.non_zero_calls() == expected.non_zero_calls() );
+    CHECK( result.finite_calls() == expected.finite_calls() );
+
+    T const chi = hep::chi_square_dof<hep::weighted_with_variance>(begin, end);
+
+    if (results.size() < 2)
+    {
+        CHECK( statistics.chi_square_dof() == chi );
+    }
+    else
+    {
+        CHECK_THAT( statistics.chi_square_dof(), Catch::WithinAbs(chi, T(1e-3) * std::abs(chi)) );
+    }
+
+    // without results both value and error are undefined
+    if (!results.empty())
+    {
+        CHECK( result.value() == expected.value() );
+        CHECK( result.error() == expected.error() );
+    }
+}
+
+TEMPLATE_TEST_CASE("running_statistics of few results", "", float, double)
+{
+    using T = TestType;
+
+    hep::running_statistics<T> statistics;
+
+    CHECK( statistics.iterations() == 0 );
+    CHECK( statistics.chi_square_dof() == T() );
+
+    statistics.add(hep::mc_result<T>(100, 99, 98, T(100.0), T(10000.0)));
+
+    CHECK( statistics.chi_square_dof() == std::numeric_limits<T>::infinity() );
+
+    statistics.add(hep::mc_result<T>(100, 99, 98, T(200.0), T(40000.0)));
+
+    CHECK( statistics.calls() == 200 );
+    CHECK( statistics.non_zero_calls() == 198 );
+    CHECK( statistics.finite_calls() == 196 );
+    CHECK_THAT( statistics.result().sum(), Catch::WithinULP(T(240.0), 4) );
+    CHECK_THAT( statistics.result().sum_of_squares(), Catch::WithinULP(T(32128.0), 4) );
+
+    // results without non-zero calls only add their calls
+    statistics.add(hep::mc_result<T>(100, 0, 0, T(), T()));
+
+    CHECK( statistics.iterations() == 3 );
+    CHECK( statistics.calls() == 300 );
+    CHECK( statistics.non_zero_calls() == 198 );
+    CHECK_THAT( statistics.result().value(), Catch::WithinULP(T(1.2), 4) );
+}
+
+TEMPLATE_TEST_CASE("statistics of checkpoints", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_plain_chkpt<T>;
+
+    auto const chkpt = hep::plain(
+        hep::make_integrand<T>(function<T>, 2),
+        std::vector<std::size_t>(8, 1000),
+        hep::make_plain_chkpt<T>(),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const& results = chkpt.results();
+
+    REQUIRE( results.size() == 8 );
+
+    for (std::size_t i = 0; i <= results.size(); ++i)
+    {
+        check_statistics(chkpt.statistics(i), std::vector<hep::plain_result<T>>(results.begin(),
+            results.begin() + i));
+    }
+
+    CHECK( &chkpt.statistics() == &chkpt.statistics(results.size()) );
+
+    // the statistics of a rolled back checkpoint agree with the ones it had before
+    auto rolled_back = chkpt;
+    rolled_back.rollback(3);
+
+    check_statistics(rolled_back.statistics(), std::vector<hep::plain_result<T>>(results.begin(),
+        results.begin() + 3));
+    CHECK_THROWS( rolled_back.statistics(4) );
+
+    // deserialized checkpoints compute the statistics of the results they read
+    std::ostringstream out;
+    chkpt.serialize(out);
+
+    std::istringstream in(out.str());
+    chkpt_type const read(in);
+
+    check_statistics(read.statistics(), results);
+}
@@ -0,0 +1,141 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// number of channels that each sample a single stripe of the unit interval; the last channel
+// samples the entire interval
+std::size_t const stripes = 100;
+
+template <typename T>
+T function(hep::multi_channel_point<T> const& point)
+{
+    T const x = point.coordinates().at(0);
+
+    return T(3.0) * x * x;
+}
+
+template <typename T>
+void batch_function(hep::multi_channel_batch<T> const& batch, std::vector<T>& values)
+{
+    T const* x = batch.coordinates(0);
+
+    for (std::size_t i = 0; i != batch.size(); ++i)
+    {
+        values[i] = T(3.0) * x[i] * x[i];
+    }
+}
+
+template <typename T>
+std::size_t stripe(T x)
+{
+    return std::min(static_cast <std::size_t> (x * T(stripes)), stripes - 1);
+}
+
+template <typename T>
+void set_densities(std::vector<T>& densities, T x)
+{
+    std::fill(densities.begin(), densities.end(), T());
+    densities[stripe(x)] = T(stripes);
+    densities[stripes] = T(1.0);
+}
+
+template <typename T>
+void set_densities(hep::sparse_densities<T>& densities, T x)
+{
+    // adding the channels in ascending order gives the same sums as the dense densities
+    densities.add(stripe(x), T(stripes));
+    densities.add(stripes, T(1.0));
+}
+
+template <typename T, typename Densities>
+T map(
+    std::size_t channel,
+    std::vector<T> const& random_numbers,
+    std::vector<T>& coordinates,
+    std::vector<std::size_t> const& /*enabled_channels*/,
+    Densities& densities,
+    hep::multi_channel_map action
+) {
+    if (action == hep::multi_channel_map::calculate_coordinates)
+    {
+        T const x = random_numbers.at(0);
+        coordinates.at(0) = (channel == stripes) ? x : ((T(channel) + x) / T(stripes));
+    }
+    else
+    {
+        set_densities(densities, coordinates.at(0));
+    }
+
+    return T(1.0);
+}
+
+template <typename T, typename C>
+void check_equal(C const& sparse, C const& dense)
+{
+    REQUIRE( sparse.results().size() == dense.results().size() );
+
+    for (std::size_t i = 0; i != sparse.results().size(); ++i)
+    {
+        CHECK( sparse.results().at(i).value() == dense.results().at(i).value() );
+        CHECK( sparse.results().at(i).error() == dense.results().at(i).error() );
+    }
+
+    CHECK( sparse.channel_weights() == dense.channel_weights() );
+    CHECK_THAT( sparse.results().back().value(),
+        Catch::WithinAbs(T(1.0), T(5.0) * sparse.results().back().error()) );
+}
+
+TEMPLATE_TEST_CASE("sparse_densities", "", float, double)
+{
+    using T = TestType;
+
+    hep::sparse_densities<T> densities;
+    densities.add(5, T(2.0));
+    densities.add(2, T(4.0));
+
+    REQUIRE( densities.size() == 2 );
+    CHECK( densities.channel(0) == 5 );
+    CHECK( densities.density(1) == T(4.0) );
+
+    densities.clear();
+
+    CHECK( densities.size() == 0 );
+}
+
+TEMPLATE_TEST_CASE("multi_channel with sparse densities", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_multi_channel_chkpt<T>;
+    using vegas_chkpt_type = hep::default_multi_channel_vegas_chkpt<T>;
+
+    std::vector<std::size_t> const iteration_calls(4, 10000);
+    std::size_t const channels = stripes + 1;
+    auto const chkpt = hep::make_multi_channel_chkpt<T>();
+    auto const vegas_chkpt = hep::make_multi_channel_vegas_chkpt<T>(8);
+    hep::callback<chkpt_type> callback(hep::callback_mode::silent);
+    hep::callback<vegas_chkpt_type> vegas_callback(hep::callback_mode::silent);
+
+    auto dense = hep::make_multi_channel_integrand<T>(function<T>, 1,
+        map<T, std::vector<T>>, 1, channels);
+    auto sparse = hep::make_multi_channel_integrand<T>(function<T>, 1,
+        hep::make_sparse_map(map<T, hep::sparse_densities<T>>), 1, channels);
+
+    check_equal<T>(hep::multi_channel(sparse, iteration_calls, chkpt, callback),
+        hep::multi_channel(dense, iteration_calls, chkpt, callback));
+    check_equal<T>(hep::parallel_multi_channel(3, sparse, iteration_calls, chkpt, callback),
+        hep::parallel_multi_channel(3, dense, iteration_calls, chkpt, callback));
+    check_equal<T>(hep::multi_channel_vegas(sparse, iteration_calls, vegas_chkpt, vegas_callback),
+        hep::multi_channel_vegas(dense, iteration_calls, vegas_chkpt, vegas_callback));
+
+    auto dense_batch = hep::make_multi_channel_batch_integrand<T>(batch_function<T>, 1,
+        map<T, std::vector<T>>, 1, channels, 64);
+    auto sparse_batch = hep::make_multi_channel_batch_integrand<T>(batch_function<T>, 1,
+        hep::make_sparse_map(map<T, hep::sparse_densities<T>>), 1, channels, 64);
+
+    check_equal<T>(hep::multi_channel(sparse_batch, iteration_calls, chkpt, callback),
+        hep::multi_channel(dense_batch, iteration_calls, chkpt, callback));
+}
@@ -0,0 +1,141 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace hep
+{
+
+// all integrations with `double` use the compact storage, those with `long double` the default one
+// unless the integrator is given another storage
+template <>
+struct storage_policy<double> : compact_storage<double>
+{
+};
+
+}
+
+template <typename T>
+T function(hep::mc_point<T> const& point, hep::projector<T>& projector)
+{
+    T const x = point.point()[0];
+    T const y = point.point()[1];
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    projector.add(0, x, f);
+    projector.add(1, x, y, f);
+
+    return f;
+}
+
+template <typename T, template <typename> class Storage = hep::storage_policy>
+hep::default_vegas_chkpt<T> integrate(std::size_t threads)
+{
+    auto integrand = hep::make_integrand<T>(
+        function<T>,
+        2,
+        hep::make_dist_params<T>(10, T(0.0), T(1.0), "x"),
+        hep::distribution_parameters<T>(4, 4, T(0.0), T(1.0), T(0.0), T(1.0), "xy")
+    );
+
+    std::vector<std::size_t> const iteration_calls(4, 10000);
+    auto const chkpt = hep::make_vegas_chkpt<T>(16);
+    hep::callback<hep::default_vegas_chkpt<T>> callback(hep::callback_mode::silent);
+
+    return (threads == 0)
+        ? hep::vegas<Storage>(integrand, iteration_calls, chkpt, callback)
+        : hep::parallel_vegas<Storage>(threads, integrand, iteration_calls, chkpt, callback);
+}
+
+TEST_CASE("storage policies")
+{
+    CHECK( std::is_same<hep::storage_policy<double>::bin_type, float>::value );
+    CHECK( std::is_same<hep::storage_policy<double>::counter_type, std::uint32_t>::value );
+    CHECK( std::is_same<hep::storage_policy<double>::adjustment_type, float>::value );
+    CHECK( std::is_same<hep::storage_policy<long double>::bin_type, long double>::value );
+    CHECK( std::is_same<hep::storage_policy<long double>::counter_type, std::size_t>::value );
+}
+
+TEST_CASE("vegas with compact storage")
+{
+    auto const reference = integrate<long double>(0);
+
+    for (std::size_t const threads : { 0, 3 })
+    {
+        auto const chkpt = integrate<double>(threads);
+
+        REQUIRE( chkpt.results().size() == reference.results().size() );
+
+        // the totals are summed in double precision, only the grid adjustments differ slightly
+        for (std::size_t i = 0; i != chkpt.results().size(); ++i)
+        {
+            auto const& result = chkpt.results().at(i);
+            auto const& expected = reference.results().at(i);
+
+            CHECK( result.non_zero_calls() == expected.non_zero_calls() );
+            CHECK_THAT( result.value(), Catch::WithinAbs(double(expected.value()),
+                1e-6 * std::abs(double(expected.value()))) );
+            CHECK_THAT( result.error(), Catch::WithinAbs(double(expected.error()),
+                1e-4 * std::abs(double(expected.error()))) );
+        }
+
+        // in the first iteration both use the same grid, so that the bins contain the same points
+        auto const& distributions = chkpt.results().front().distributions();
+        auto const& expected_distributions = reference.results().front().distributions();
+
+        for (std::size_t i = 0; i != distributions.size(); ++i)
+        {
+            auto const& bins = distributions.at(i).results();
+            auto const& expected_bins = expected_distributions.at(i).results();
+
+            REQUIRE( bins.size() == expected_bins.size() );
+
+            for (std::size_t j = 0; j != bins.size(); ++j)
+            {
+                CHECK( bins.at(j).non_zero_calls() == expected_bins.at(j).non_zero_calls() );
+                CHECK( bins.at(j).finite_calls() == expected_bins.at(j).finite_calls() );
+                double const value = expected_bins.at(j).value();
+                double const error = expected_bins.at(j).error();
+
+                CHECK_THAT( bins.at(j).value(), Catch::WithinAbs(value, 1e-5 * std::abs(value)) );
+                CHECK_THAT( bins.at(j).error(), Catch::WithinAbs(error, 1e-4 * std::abs(error)) );
+            }
+        }
+    }
+}
+
+TEST_CASE("vegas with compact storage for a single integration")
+{
+    using T = long double;
+
+    // `long double` uses the default storage, but this integration only stores the adjustment data
+    // in single precision
+    auto const reference = integrate<T>(0);
+    auto const compact = integrate<T, hep::compact_storage>(0);
+    auto const parallel = integrate<T, hep::compact_storage>(3);
+
+    REQUIRE( compact.results().size() == reference.results().size() );
+    REQUIRE( parallel.results().size() == reference.results().size() );
+
+    // the first iteration uses the same grid and sums the totals in `T`
+    CHECK( compact.results().front().value() == reference.results().front().value() );
+    CHECK( compact.results().front().error() == reference.results().front().error() );
+
+    // the refined grids differ by the rounding of the adjustment data
+    CHECK( compact.results().back().value() != reference.results().back().value() );
+
+    for (std::size_t i = 0; i != compact.results().size(); ++i)
+    {
+        double const value = reference.results().at(i).value();
+
+        CHECK_THAT( double(compact.results().at(i).value()),
+            Catch::WithinAbs(value, 1e-6 * std::abs(value)) );
+        CHECK_THAT( double(parallel.results().at(i).value()),
+            Catch::WithinAbs(value, 1e-6 * std::abs(value)) );
+    }
+}
@@ -0,0 +1,244 @@
+#ifndef HEP_USE_MPI
+#include "hep/mc.hpp"
+#else
+#include "hep/mc-mpi.hpp"
+#endif
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+template <typename T>
+T function(hep::mc_point<T> const& point)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    return f;
+}
+
+TEST_CASE("xoshiro256pp reference values", "[xoshiro256pp]")
+{
+    hep::xoshiro256pp generator;
+
+    std::istringstream in("1 2 3 4");
+    in >> generator;
+
+    // the reference values are obtained from the reference implementation
+    CHECK( generator() == UINT64_C(41943041) );
+    CHECK( generator() == UINT64_C(58720359) );
+    CHECK( generator() == UINT64_C(3588806011781223) );
+
+    // the state must be initialized with splitmix64
+    generator.seed();
+
+    std::ostringstream out;
+    out << generator;
+
+    CHECK( out.str() == "16294208416658607535 7960286522194355700 487617019471545679 "
+        "17909611376780542444" );
+    CHECK( generator() == UINT64_C(5987356902031041503) );
+
+    hep::xoshiro256pp copy;
+    copy.discard(1);
+
+    CHECK( copy == generator );
+
+    copy.discard(9999);
+
+    CHECK( copy != generator );
+    CHECK( copy() == UINT64_C(2641371893274237850) );
+
+    hep::xoshiro256pp jumped;
+    jumped.jump();
+
+    CHECK( jumped() == UINT64_C(2380102097514288011) );
+}
+
+TEST_CASE("philox4x64 reference values", "[philox4x64]")
+{
+    hep::philox4x64 generator;
+
+    // the first block encrypts the counter zero with the key zero; the values are the known-answer
+    // test vectors of the reference implementation
+    CHECK( generator() == UINT64_C(0x16554d9eca36314c) );
+    CHECK( generator() == UINT64_C(0xdb20fe9d672d0fdc) );
+    CHECK( generator() == UINT64_C(0xd7e772cee186176b) );
+    CHECK( generator() == UINT64_C(0x7e68b68aec7ba23b) );
+    CHECK( generator() == UINT64_C(213000021201967259) );
+
+    std::istringstream in("18446744073709551615 18446744073709551615 18446744073709551615 "
+        "18446744073709551615 18446744073709551615 18446744073709551615 0");
+    in >> generator;
+
+    CHECK( generator() == UINT64_C(0x87b092c3013fe90b) );
+    CHECK( generator() == UINT64_C(0x438c3c67be8d0224) );
+    CHECK( generator() == UINT64_C(0x9cc7d7c69cd777b6) );
+    CHECK( generator() == UINT64_C(0xa09caebf594f0ba0) );
+
+    // discarding is the same as generating
+    hep::philox4x64 a(42);
+    hep::philox4x64 b(42);
+
+    for (std::size_t i = 0; i != 11; ++i)
+    {
+        a();
+    }
+
+    b.discard(11);
+
+    CHECK( a == b );
+    CHECK( a() == b() );
+
+    b.discard(3);
+
+    CHECK( a != b );
+
+    a.discard(1);
+    a.discard(2);
+
+    CHECK( a == b );
+
+    hep::philox4x64 c(42);
+    c.discard(1000003);
+
+    CHECK( c() == UINT64_C(13684501107778012875) );
+
+    // the carry must be propagated into the next word of the counter
+    std::istringstream carry("7 0 18446744073709551615 0 0 0 3");
+    carry >> c;
+    c.discard(1);
+
+    CHECK( c() == UINT64_C(2600818924746953099) );
+
+    // serialization restores the position inside a block
+    std::stringstream stream;
+    stream << a;
+
+    hep::philox4x64 d;
+    stream >> d;
+
+    CHECK( d == a );
+    CHECK( d() == a() );
+}
+
+TEMPLATE_TEST_CASE("generate_uniform", "", float, double)
+{
+    using T = TestType;
+
+    hep::xoshiro256pp generator(42);
+    hep::xoshiro256pp reference = generator;
+
+    std::vector<T> numbers(1000);
+    hep::generate_uniform(generator, numbers.data(), numbers.data() + numbers.size());
+
+    T const scale = T(1.0) / T(std::uint64_t(1) << std::numeric_limits<T>::digits);
+
+    for (auto const number : numbers)
+    {
+        CHECK( number >= T() );
+        CHECK( number < T(1.0) );
+
+        // the fast conversion uses the most significant bits of exactly one integer
+        CHECK( number == T(reference() >> (64 - std::numeric_limits<T>::digits)) * scale );
+    }
+
+    CHECK( reference == generator );
+
+    std::mt19937 mt;
+    std::mt19937 mt_copy = mt;
+
+    // other generators use `std::generate_canonical`
+    for (std::size_t i = 0; i != 100; ++i)
+    {
+        CHECK( hep::generate_uniform<T>(mt) ==
+            std::generate_canonical<T, std::numeric_limits<T>::digits>(mt_copy) );
+    }
+}
+
+TEMPLATE_TEST_CASE("vegas with xoshiro256pp", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::vegas_chkpt_with_rng<hep::xoshiro256pp, T>;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2);
+
+    auto const chkpt = hep::vegas(
+        integrand,
+        std::vector<std::size_t>(5, 10000),
+        hep::make_vegas_chkpt<T>(8, T(1.5), hep::xoshiro256pp()),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const result = hep::accumulate<hep::weighted_with_variance>(chkpt.results().begin() + 1,
+        chkpt.results().end());
+
+    CHECK( std::fabs(result.value() - T(1.0)) < T(3.0) * result.error() );
+
+    // the parallel integrator must forward the generator correctly
+    auto const parallel = hep::parallel_vegas(
+        3,
+        integrand,
+        std::vector<std::size_t>(5, 10000),
+        hep::make_vegas_chkpt<T>(8, T(1.5), hep::xoshiro256pp()),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    CHECK( parallel.generator() == chkpt.generator() );
+
+    // checkpoints with this generator can be written and read
+    std::stringstream stream;
+    chkpt.serialize(stream);
+
+    auto const restored = hep::make_vegas_chkpt<T, hep::xoshiro256pp>(stream);
+
+    CHECK( restored.generator() == chkpt.generator() );
+    CHECK( restored.results().size() == chkpt.results().size() );
+}
+
+TEMPLATE_TEST_CASE("plain with philox4x64", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::plain_chkpt_with_rng<hep::philox4x64, T>;
+
+    std::vector<std::size_t> const calls = { 10000, 20001, 999 };
+
+    auto const chkpt = hep::plain(
+        hep::make_integrand<T>(function<T>, 2),
+        calls,
+        hep::make_plain_chkpt<T>(hep::philox4x64(7)),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    // the generator is forwarded by the number of random numbers used
+    hep::philox4x64 reference(7);
+    reference.discard(2 * (10000 + 20001 + 999));
+
+    CHECK( chkpt.generator() == reference );
+
+#ifdef HEP_USE_MPI
+    // each process positions its generator in constant time
+    auto const mpi_chkpt = hep::mpi_plain(
+        MPI_COMM_WORLD,
+        hep::make_integrand<T>(function<T>, 2),
+        calls,
+        hep::make_plain_chkpt<T>(hep::philox4x64(7)),
+        hep::mpi_callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    CHECK( mpi_chkpt.generator() == reference );
+
+    for (std::size_t i = 0; i != calls.size(); ++i)
+    {
+        CHECK_THAT( mpi_chkpt.results().at(i).value() ,
+            Catch::WithinULP(chkpt.results().at(i).value(), 16) );
+    }
+#endif
+}
@@ -1,3 +1,4 @@
+#include "hep/mc/callback.hpp"
 #include "hep/mc/distribution_parameters.hpp"
 #include "hep/mc/integrand.hpp"
 #include "hep/mc/vegas.hpp"
@@ -8,6 +9,7 @@
 #include <cstddef>
 #include <random>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 template <typename T>
@@ -156,3 +158,187 @@ TEMPLATE_TEST_CASE("series", "[vegas_chkpt]", float, double, long double)
 
     CHECK( stream1.str() == stream2.str() );
 }
+
+TEMPLATE_TEST_CASE("grid storage", "[vegas_chkpt]", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto const run = [](std::size_t iterations, chkpt_type const& chkpt) {
+        return hep::vegas(
+            hep::make_integrand<T>(
+                linear_function<T>,
+                1,
+                hep::make_dist_params<T>(10, T(0.0), T(1.0), "distribution #1")
+            ),
+            std::vector<std::size_t>(iterations, 1000),
+            chkpt,
+            hep::callback<chkpt_type>(hep::callback_mode::silent)
+        );
+    };
+
+    auto const serialize = [](hep::vegas_pdf<T> const& pdf) {
+        std::ostringstream out;
+        pdf.serialize(out);
+        return out.str();
+    };
+
+    auto const full = run(6, hep::make_vegas_chkpt<T>());
+
+    auto compact = hep::make_vegas_chkpt<T>();
+    compact.grid_storage(hep::vegas_grid_storage::adjustment_data);
+    compact = run(6, compact);
+
+    auto minimal = hep::make_vegas_chkpt<T>();
+    minimal.grid_storage(hep::vegas_grid_storage::last);
+    minimal = run(6, minimal);
+
+    REQUIRE( compact.results().size() == 6 );
+    REQUIRE( minimal.results().size() == 6 );
+
+    for (std::size_t i = 0; i != 6; ++i)
+    {
+        // discarding the grids does not change the results
+        CHECK( compact.results().at(i).value() == full.results().at(i).value() );
+        CHECK( minimal.results().at(i).value() == full.results().at(i).value() );
+
+        bool const kept = (i == 0) || (i == 5);
+
+        CHECK( (compact.results().at(i).pdf().bins() != 0) == kept );
+        CHECK( compact.results().at(i).adjustment_data().size() == 128 );
+        CHECK( (minimal.results().at(i).pdf().bins() != 0) == (i == 5) );
+        CHECK( minimal.results().at(i).adjustment_data().empty() == (i != 5) );
+
+        // the discarded grids are reconstructed exactly
+        CHECK( serialize(compact.pdf(i)) == serialize(full.results().at(i).pdf()) );
+        CHECK( serialize(full.pdf(i)) == serialize(full.results().at(i).pdf()) );
+
+        if (i != 5)
+        {
+            CHECK_THROWS_AS( minimal.pdf(i), std::runtime_error );
+        }
+    }
+
+    CHECK( serialize(minimal.pdf(6)) == serialize(full.pdf()) );
+    CHECK_THROWS_AS( full.pdf(7), std::out_of_range );
+
+    std::ostringstream full_stream;
+    full.serialize(full_stream);
+
+    std::ostringstream minimal_stream;
+    minimal.serialize(minimal_stream);
+
+    CHECK( minimal_stream.str().size() < full_stream.str().size() );
+
+    // compact checkpoints can be read and resumed
+    for (auto const* chkpt : { &compact, &minimal })
+    {
+        std::ostringstream out;
+        chkpt->serialize(out);
+
+        std::istringstream in(out.str());
+        auto restored = hep::make_vegas_chkpt<T, std::mt19937>(in);
+
+        std::ostringstream out2;
+        restored.serialize(out2);
+
+        CHECK( out.str() == out2.str() );
+
+        restored.grid_storage(chkpt->grid_storage());
+
+        auto const resumed = run(2, restored);
+        auto const complete = run(8, hep::make_vegas_chkpt<T>());
+
+        CHECK( resumed.results().back().value() == complete.results().back().value() );
+        CHECK( serialize(resumed.pdf()) == serialize(complete.pdf()) );
+    }
+}
+
+TEMPLATE_TEST_CASE("rollback with grid storage", "[vegas_chkpt]", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_chkpt<T>;
+
+    auto const run = [](std::size_t iterations, chkpt_type const& chkpt) {
+        return hep::vegas(
+            hep::make_integrand<T>(
+                linear_function<T>,
+                1,
+                hep::make_dist_params<T>(10, T(0.0), T(1.0), "distribution #1")
+            ),
+            std::vector<std::size_t>(iterations, 1000),
+            chkpt,
+            hep::callback<chkpt_type>(hep::callback_mode::silent)
+        );
+    };
+
+    auto const serialize = [](hep::vegas_pdf<T> const& pdf) {
+        std::ostringstream out;
+        pdf.serialize(out);
+        return out.str();
+    };
+
+    auto const full = run(6, hep::make_vegas_chkpt<T>());
+
+    for (auto const storage : { hep::vegas_grid_storage::all,
+        hep::vegas_grid_storage::adjustment_data, hep::vegas_grid_storage::last })
+    {
+        auto initial = hep::make_vegas_chkpt<T>();
+        initial.grid_storage(storage);
+
+        auto chkpt = run(6, initial);
+
+        if (storage == hep::vegas_grid_storage::last)
+        {
+            // the grids needed to resume from an earlier iteration are gone
+            CHECK_THROWS_AS( chkpt.rollback(3), std::runtime_error );
+            CHECK( chkpt.results().size() == 6 );
+            CHECK( serialize(chkpt.pdf()) == serialize(full.pdf()) );
+        }
+        else
+        {
+            chkpt.rollback(3);
+
+            REQUIRE( chkpt.results().size() == 3 );
+            CHECK( chkpt.results().back().pdf().bins() != 0 );
+            CHECK( serialize(chkpt.pdf()) == serialize(full.pdf(3)) );
+
+            // the generator continues after the last remaining iteration
+            CHECK( chkpt.generator() == run(3, initial).generator() );
+
+            // resuming gives the same results as the integration without rollback
+            auto const resumed = run(3, chkpt);
+
+            REQUIRE( resumed.results().size() == 6 );
+            CHECK( resumed.results().back().value() == full.results().back().value() );
+            CHECK( serialize(resumed.pdf()) == serialize(full.pdf()) );
+        }
+
+        // rolling back everything is always possible, also for checkpoints read from a stream,
+        // which do not store the initial grid
+        std::ostringstream out;
+        run(6, initial).serialize(out);
+
+        std::istringstream in(out.str());
+        auto restored = hep::make_vegas_chkpt<T, std::mt19937>(in);
+        restored.grid_storage(storage);
+
+        if (storage == hep::vegas_grid_storage::last)
+        {
+            CHECK_THROWS_AS( restored.rollback(0), std::runtime_error );
+            restored = initial;
+        }
+        else
+        {
+            restored.rollback(0);
+        }
+
+        REQUIRE( restored.results().empty() );
+        CHECK( restored.generator() == initial.generator() );
+
+        auto const repeated = run(6, restored);
+
+        CHECK( repeated.results().back().value() == full.results().back().value() );
+        CHECK( serialize(repeated.pdf()) == serialize(full.pdf()) );
+    }
+}
@@ -156,3 +156,106 @@ TEMPLATE_TEST_CASE("", "", float, double /*, long double*/)
         CHECK_THAT( new_pdf.bin_left(0, i), Catch::WithinULP(old_pdf.bin_left(0, i), 4) );
     }
 }
+
+// The point-by-point implementation of `hep::vegas_icdf` before the block version was added, which
+// serves as an independent reference
+template <typename T>
+T reference_icdf(
+    hep::vegas_pdf<T> const& pdf,
+    std::vector<T>& random_numbers,
+    std::vector<std::size_t>& bin
+) {
+    T weight = T(1.0);
+
+    for (std::size_t i = 0; i != pdf.dimensions(); ++i)
+    {
+        if (random_numbers[i] == T(1.0))
+        {
+            random_numbers[i] = std::nexttoward(random_numbers[i], T());
+        }
+
+        T const position = random_numbers[i] * pdf.bins();
+        std::size_t const index = position;
+        T const position_inside_bin = position - index;
+
+        bin[i] = index;
+
+        T const left = pdf.bin_left(i, index);
+        T const size = pdf.bin_left(i, index + 1) - left;
+
+        random_numbers[i] = left + position_inside_bin * size;
+        weight *= size * pdf.bins();
+    }
+
+    return weight;
+}
+
+TEMPLATE_TEST_CASE("vegas_icdf_block", "", float, double /*, long double*/)
+{
+    using T = TestType;
+
+    std::size_t const dimensions = 3;
+    std::size_t const size = 99;
+    std::size_t const stride = 128;
+
+    hep::vegas_pdf<T> pdf{dimensions, 5};
+
+    for (std::size_t i = 0; i != dimensions; ++i)
+    {
+        pdf.set_bin_left(i, 1, T(0.1) * T(i + 1));
+        pdf.set_bin_left(i, 2, T(0.5));
+        pdf.set_bin_left(i, 3, T(0.6));
+        pdf.set_bin_left(i, 4, T(0.99));
+    }
+
+    std::vector<T> random_numbers(dimensions * stride);
+    std::vector<std::size_t> bins(dimensions * stride);
+    std::vector<T> weights(stride);
+
+    for (std::size_t i = 0; i != dimensions; ++i)
+    {
+        for (std::size_t j = 0; j != size; ++j)
+        {
+            // includes zero and one
+            random_numbers.at(i * stride + j) = T((j * (i + 1)) % size) / T(size - 1);
+        }
+    }
+
+    auto const numbers = random_numbers;
+
+    hep::vegas_icdf_block(pdf, size, stride, random_numbers.data(), bins.data(), weights.data());
+
+    std::vector<T> point(dimensions);
+    std::vector<std::size_t> bin(dimensions);
+    std::vector<T> single_point(dimensions);
+    std::vector<std::size_t> single_bin(dimensions);
+
+    for (std::size_t j = 0; j != size; ++j)
+    {
+        INFO( "j=" << j );
+
+        for (std::size_t i = 0; i != dimensions; ++i)
+        {
+            point.at(i) = numbers.at(i * stride + j);
+        }
+
+        single_point = point;
+
+        T const weight = reference_icdf(pdf, point, bin);
+
+        CHECK( weights.at(j) == weight );
+        CHECK( hep::vegas_icdf(pdf, single_point, single_bin) == weight );
+
+        for (std::size_t i = 0; i != dimensions; ++i)
+        {
+            CHECK( random_numbers.at(i * stride + j) == point.at(i) );
+            CHECK( bins.at(i * stride + j) == bin.at(i) );
+            CHECK( single_point.at(i) == point.at(i) );
+            CHECK( single_bin.at(i) == bin.at(i) );
+        }
+    }
+
+    // the entries after `size` are not touched
+    CHECK( random_numbers.at(size) == numbers.at(size) );
+    CHECK( weights.at(size) == T() );
+}
@@ -0,0 +1,196 @@
+#include "hep/mc.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <vector>
+
+template <typename T>
+T function(hep::vegas_point<T> const& point)
+{
+    T const x = point.point().at(0);
+    T const y = point.point().at(1);
+    T const f = T(3.0) / T(2.0) * (x * x + y * y);
+
+    return f;
+}
+
+template <typename T>
+T function_with_distribution(hep::vegas_point<T> const& point, hep::projector<T>& projector)
+{
+    T const f = function(point);
+
+    projector.add(0, point.point().at(0), f);
+
+    return f;
+}
+
+TEST_CASE("vegas_strata", "[vegas_stratified]")
+{
+    // at least four calls per hypercube
+    CHECK( hep::vegas_strata(3, 2, 10000) == 1 );
+    CHECK( hep::vegas_strata(16, 2, 10000) == 2 );
+    CHECK( hep::vegas_strata(10000, 2, 10000) == 50 );
+    CHECK( hep::vegas_strata(10000, 1, 10000) == 2500 );
+
+    // the maximum number of hypercubes is respected
+    CHECK( hep::vegas_strata(1000000, 2, 10000) == 100 );
+    CHECK( hep::vegas_strata(1000000, 3, 10000) == 21 );
+
+    // high dimensions are not stratified
+    CHECK( hep::vegas_strata(1000000, 30, 10000) == 1 );
+}
+
+TEMPLATE_TEST_CASE("vegas_hypercube_calls", "", float, double)
+{
+    using T = TestType;
+
+    // without variances the calls are distributed uniformly
+    auto const uniform = hep::vegas_hypercube_calls<T>(1000, 4, {}, T(0.75));
+
+    CHECK( uniform == std::vector<std::size_t>{ 250, 250, 250, 250 } );
+
+    std::vector<T> const variances = { T(), T(1.0), T(16.0), T(1.0) };
+
+    // with `beta = 1` the calls are proportional to the standard deviations
+    auto const adapted = hep::vegas_hypercube_calls(1006, 4, variances, T(1.0));
+
+    CHECK( adapted == std::vector<std::size_t>{ 2, 168, 667, 169 } );
+
+    // with `beta = 0` the calls are distributed uniformly
+    auto const damped = hep::vegas_hypercube_calls(1000, 4, variances, T());
+
+    CHECK( damped == std::vector<std::size_t>{ 250, 250, 250, 250 } );
+
+    // if there are not enough calls the minimum of two calls is not enforced
+    auto const few = hep::vegas_hypercube_calls(3, 4, variances, T(1.0));
+
+    CHECK( std::accumulate(few.begin(), few.end(), std::size_t()) == 3 );
+}
+
+TEMPLATE_TEST_CASE("vegas_stratified integration", "", float, double)
+{
+    using T = TestType;
+
+    std::vector<std::size_t> const iteration_calls(5, 10000);
+
+    auto const chkpt = hep::vegas_stratified(
+        hep::make_integrand<T>(function<T>, 2),
+        iteration_calls,
+        hep::make_vegas_stratified_chkpt<T>(8),
+        hep::callback<hep::default_vegas_stratified_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    auto const reference = hep::vegas(
+        hep::make_integrand<T>(function<T>, 2),
+        iteration_calls,
+        hep::make_vegas_chkpt<T>(8),
+        hep::callback<hep::default_vegas_chkpt<T>>(hep::callback_mode::silent)
+    );
+
+    REQUIRE( chkpt.results().size() == 5 );
+
+    for (std::size_t i = 0; i != chkpt.results().size(); ++i)
+    {
+        auto const& result = chkpt.results().at(i);
+
+        CHECK( result.calls() == 10000 );
+        CHECK( result.strata() == 50 );
+        CHECK( result.hypercube_variances().size() == 2500 );
+        CHECK( std::fabs(result.value() - T(1.0)) < T(4.0) * result.error() );
+
+        // stratification must reduce the error substantially
+        CHECK( result.error() < T(0.2) * reference.results().at(i).error() );
+    }
+
+    // the generator is forwarded by the number of random numbers used
+    CHECK( chkpt.generator() == reference.generator() );
+}
+
+TEMPLATE_TEST_CASE("vegas_stratified with distributions", "", float, double)
+{
+    using T = TestType;
+
+    auto const results = hep::vegas_stratified(
+        hep::make_integrand<T>(
+            function_with_distribution<T>,
+            2,
+            hep::make_dist_params<T>(10, T(0.0), T(1.0))
+        ),
+        std::vector<std::size_t>(3, 4000),
+        hep::make_vegas_stratified_chkpt<T>(8),
+        hep::callback<hep::default_vegas_stratified_chkpt<T>>(hep::callback_mode::silent)
+    ).results();
+
+    for (auto const& result : results)
+    {
+        T sum = T();
+
+        for (auto const& bin : result.distributions().at(0).results())
+        {
+            sum += bin.value();
+        }
+
+        // the bins must add up to the integral
+        CHECK_THAT( sum / T(10.0),
+            Catch::WithinAbs(result.value(), T(1e-4) * std::abs(result.value())) );
+    }
+}
+
+TEMPLATE_TEST_CASE("vegas_stratified checkpoints", "", float, double)
+{
+    using T = TestType;
+    using chkpt_type = hep::default_vegas_stratified_chkpt<T>;
+
+    auto integrand = hep::make_integrand<T>(function<T>, 2);
+
+    auto const chkpt = hep::vegas_stratified(
+        integrand,
+        std::vector<std::size_t>{ 1000, 2000, 2000 },
+        hep::make_vegas_stratified_chkpt<T>(8, T(1.5), T(0.5), 100),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    CHECK( chkpt.beta() == T(0.5) );
+    CHECK( chkpt.max_hypercubes() == 100 );
+    CHECK( chkpt.results().back().strata() == 10 );
+
+    std::ostringstream out;
+    chkpt.serialize(out);
+
+    std::istringstream in(out.str());
+    auto const restored = hep::make_vegas_stratified_chkpt<T, std::mt19937>(in);
+
+    std::ostringstream out2;
+    restored.serialize(out2);
+
+    CHECK( out.str() == out2.str() );
+    CHECK( restored.results().back().error() == chkpt.results().back().error() );
+
+    // resuming from a checkpoint gives the same results as performing all iterations at once
+    auto const resumed = hep::vegas_stratified(
+        integrand,
+        std::vector<std::size_t>{ 2000, 2000 },
+        restored,
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    auto const complete = hep::vegas_stratified(
+        integrand,
+        std::vector<std::size_t>{ 1000, 2000, 2000, 2000, 2000 },
+        hep::make_vegas_stratified_chkpt<T>(8, T(1.5), T(0.5), 100),
+        hep::callback<chkpt_type>(hep::callback_mode::silent)
+    );
+
+    std::ostringstream out3;
+    resumed.serialize(out3);
+
+    std::ostringstream out4;
+    complete.serialize(out4);
+
+    CHECK( out3.str() == out4.str() );
+}